@@ -0,0 +1,136 @@
+#include "cipher_cache.h"
+#include "modAlphaCipher.h"
+#include "module.h"
+#include "utf8.h"
+
+/**
+ * @file cipher_cache.cpp
+ * @brief Реализация LRU-кэша шифров демона
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Шифр демона поверх modAlphaCipher или RouteCipher
+ * @tparam Cipher - класс шифра с методами encrypt_into/decrypt_into для UTF-8
+ */
+template <class Cipher>
+class CipherModel : public CipherInstance
+{
+public:
+    /**
+     * @brief Создание шифра
+     * @param cipher - шифр с установленным ключом
+     */
+    explicit CipherModel(Cipher cipher): cipher(std::move(cipher)) {}
+
+    /**
+     * @brief Выполнение операции над текстом в UTF-8
+     * @param op - операция
+     * @param in - текст
+     * @param n - длина текста в байтах
+     * @param out - буфер для результата
+     * @param out_size - размер буфера (достаточно n)
+     * @return Количество записанных байтов
+     * @throw cipher_error если текст не подходит шифру
+     */
+    std::size_t run(CipherOp op, const char* in, std::size_t n, char* out, std::size_t out_size) const override
+    {
+        return op == CipherOp::encrypt ? cipher.encrypt_into(in, n, out, out_size)
+                                       : cipher.decrypt_into(in, n, out, out_size);
+    }
+
+private:
+    Cipher cipher; ///< Шифр
+};
+
+/**
+ * @brief Перевод ключа маршрута из UTF-8 в широкую строку
+ * @param key - ключ в UTF-8
+ * @return Ключ для конструктора RouteCipher
+ * @throw cipher_error если ключ не в UTF-8
+ */
+static std::wstring routeKey(const std::string& key)
+{
+    std::wstring result;
+    for (std::size_t i = 0; i < key.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(key.data() + i, key.size() - i, c);
+        if (k == 0)
+            throw cipher_error("Invalid key");
+        result.push_back(static_cast<wchar_t>(c));
+        i += k;
+    }
+    return result;
+}
+
+/**
+ * @brief Создание шифра
+ * @param algorithm - шифр
+ * @param key - ключ в UTF-8
+ * @return Шифр с установленным ключом
+ * @throw cipher_error если ключ невалиден
+ */
+std::shared_ptr<const CipherInstance> makeCipher(CipherAlgorithm algorithm, const std::string& key)
+{
+    if (algorithm == CipherAlgorithm::gronsfeld)
+        return std::make_shared<CipherModel<modAlphaCipher>>(modAlphaCipher(std::string_view(key)));
+    return std::make_shared<CipherModel<RouteCipher>>(RouteCipher(routeKey(key)));
+}
+
+const std::size_t CipherCache::default_capacity;
+
+/**
+ * @brief Создание пустого кэша
+ * @param capacity - наибольшее количество шифров (0 отключает кэш)
+ */
+CipherCache::CipherCache(std::size_t capacity):
+    cache(capacity)
+{
+}
+
+/**
+ * @brief Поиск шифра или его создание при промахе
+ * @param algorithm - шифр
+ * @param key - ключ в UTF-8
+ * @return Шифр с установленным ключом
+ * @throw cipher_error если ключ невалиден
+ * @details Если два потока одновременно промахнулись по одному ключу, в кэш попадает
+ * шифр первого, а второй получает его же
+ */
+CipherCache::Cipher CipherCache::get(CipherAlgorithm algorithm, const std::string& key)
+{
+    Key k(algorithm, key);
+    Cipher cipher = cache.find(k);
+    if (cipher)
+        return cipher;
+    return cache.insert(k, makeCipher(algorithm, key));
+}
+
+/**
+ * @brief Количество шифров в кэше
+ * @return Число шифров
+ */
+std::size_t CipherCache::size() const
+{
+    return cache.size();
+}
+
+/**
+ * @brief Количество попаданий
+ * @return Число вызовов get(), нашедших шифр
+ */
+unsigned long long CipherCache::hits() const
+{
+    return cache.hits();
+}
+
+/**
+ * @brief Количество промахов
+ * @return Число вызовов get(), создавших шифр
+ */
+unsigned long long CipherCache::misses() const
+{
+    return cache.misses();
+}
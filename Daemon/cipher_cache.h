@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include "lru_cache.h"
+#include "protocol.h"
+
+/**
+ * @file cipher_cache.h
+ * @brief Заголовочный файл LRU-кэша шифров демона
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Шифр с установленным ключом, выполняющий запросы демона
+ * @details Методы константны и потокобезопасны, как и методы самих шифров
+ */
+class CipherInstance
+{
+public:
+    virtual ~CipherInstance() = default;
+
+    /**
+     * @brief Выполнение операции над текстом в UTF-8
+     * @param op - операция
+     * @param in - текст
+     * @param n - длина текста в байтах
+     * @param out - буфер для результата
+     * @param out_size - размер буфера (достаточно n)
+     * @return Количество записанных байтов
+     * @throw cipher_error если текст не подходит шифру
+     */
+    virtual std::size_t run(CipherOp op, const char* in, std::size_t n, char* out, std::size_t out_size) const = 0;
+};
+
+/**
+ * @brief Создание шифра
+ * @param algorithm - шифр
+ * @param key - ключ в UTF-8
+ * @return Шифр с установленным ключом
+ * @throw cipher_error если ключ невалиден
+ */
+std::shared_ptr<const CipherInstance> makeCipher(CipherAlgorithm algorithm, const std::string& key);
+
+/**
+ * @brief Ограниченный LRU-кэш шифров, ключ — (шифр, ключ шифра)
+ * @details Разбор ключа и подготовка шифра (таблицы сдвигов, кэш планов перестановки)
+ * выполняются один раз на ключ, а не на каждый запрос. Кэш построен на LruCache:
+ * методы потокобезопасны, шифр создаётся вне блокировки, отдаётся через shared_ptr и остаётся действительным
+ * после вытеснения. Невалидные ключи не кэшируются.
+ */
+class CipherCache
+{
+public:
+    typedef std::shared_ptr<const CipherInstance> Cipher; ///< Общий неизменяемый шифр
+
+    static const std::size_t default_capacity = 64; ///< Ёмкость кэша по умолчанию
+
+    /**
+     * @brief Создание пустого кэша
+     * @param capacity - наибольшее количество шифров (0 отключает кэш)
+     */
+    explicit CipherCache(std::size_t capacity = default_capacity);
+
+    CipherCache(const CipherCache&) = delete; ///< Кэш не копируется
+    CipherCache& operator=(const CipherCache&) = delete; ///< Кэш не копируется
+
+    /**
+     * @brief Поиск шифра или его создание при промахе
+     * @param algorithm - шифр
+     * @param key - ключ в UTF-8
+     * @return Шифр с установленным ключом
+     * @throw cipher_error если ключ невалиден
+     */
+    Cipher get(CipherAlgorithm algorithm, const std::string& key);
+
+    /**
+     * @brief Количество шифров в кэше
+     * @return Число шифров
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Количество попаданий
+     * @return Число вызовов get(), нашедших шифр
+     */
+    unsigned long long hits() const;
+
+    /**
+     * @brief Количество промахов
+     * @return Число вызовов get(), создавших шифр
+     */
+    unsigned long long misses() const;
+
+private:
+    typedef std::pair<CipherAlgorithm, std::string> Key; ///< (шифр, ключ шифра)
+
+    LruCache<Key, Cipher> cache; ///< Шифры по ключу
+};
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "protocol.h"
+#include "bench_util.h"
+#include "size_arg.h"
+
+/**
+ * @file load.cpp (cipher_load)
+ * @brief Генератор нагрузки для демона шифрования
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Каждое соединение в своём потоке отправляет запросы один за другим и замеряет
+ * время от отправки запроса до получения ответа. Тексты генерируются детерминированно:
+ * для шифрования — буквы обоих регистров, пробелы и знаки препинания, для дешифрования —
+ * только заглавные буквы. Результат выводится в JSON.
+ */
+
+/**
+ * @brief Параметры нагрузки
+ */
+struct LoadOptions {
+    std::string socket_path = "/tmp/cipherd.sock"; ///< Путь к сокету демона
+    std::size_t connections = 8; ///< Количество соединений
+    std::size_t requests = 1000; ///< Запросы на одно соединение
+    std::size_t size = 256; ///< Размер текста запроса в байтах
+    CipherAlgorithm algorithm = CipherAlgorithm::gronsfeld; ///< Шифр
+    CipherOp op = CipherOp::encrypt; ///< Операция
+    std::size_t keys = 1; ///< Количество различных ключей (проверка кэша шифров)
+};
+
+static const std::size_t max_connections = 4096; ///< Наибольшее значение --connections (по потоку на соединение)
+static const std::size_t max_requests = 1000000000; ///< Наибольшее значение --requests
+static const std::size_t max_keys = 1 << 20; ///< Наибольшее значение --keys
+
+/**
+ * @brief Справка по параметрам
+ * @param program - имя программы
+ * @return Текст справки
+ */
+static std::string usage(const std::string& program)
+{
+    return "Использование: " + program + " [--socket ПУТЬ] [--connections N] [--requests N] [--size РАЗМЕР]\n"
+           "               [--algorithm gronsfeld|route] [--op encrypt|decrypt] [--keys N]\n"
+           "  --connections  соединения, каждое в своём потоке, от 1 до 4096 (8)\n"
+           "  --requests  запросы на одно соединение, от 1 до 1000000000 (1000)\n"
+           "  --size      размер текста запроса в байтах с суффиксом K, M или G\n"
+           "  --keys      количество различных ключей, по кругу, от 1 до 1048576 (1)\n";
+}
+
+/**
+ * @brief Разбор командной строки
+ * @param argc - количество аргументов
+ * @param argv - аргументы
+ * @return Параметры нагрузки
+ * @throw std::invalid_argument если аргументы неверны
+ */
+static LoadOptions parseOptions(int argc, char* argv[])
+{
+    LoadOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 == argc)
+            throw std::invalid_argument("missing value for " + arg);
+        std::string value = argv[++i];
+        if (arg == "--socket")
+            options.socket_path = value;
+        else if (arg == "--connections")
+            options.connections = parseCount(value, "connections", 1, max_connections);
+        else if (arg == "--requests")
+            options.requests = parseCount(value, "requests", 1, max_requests);
+        else if (arg == "--size")
+            options.size = parseSize(value);
+        else if (arg == "--algorithm" && (value == "gronsfeld" || value == "route"))
+            options.algorithm = value == "route" ? CipherAlgorithm::route : CipherAlgorithm::gronsfeld;
+        else if (arg == "--op" && (value == "encrypt" || value == "decrypt"))
+            options.op = value == "decrypt" ? CipherOp::decrypt : CipherOp::encrypt;
+        else if (arg == "--keys")
+            options.keys = parseCount(value, "keys", 1, max_keys);
+        else
+            throw std::invalid_argument("invalid option: " + arg + " " + value);
+    }
+    return options;
+}
+
+/**
+ * @brief Ключ с заданным номером
+ * @param algorithm - шифр
+ * @param number - номер ключа
+ * @return Ключ в UTF-8: буквы для шифра Гронсфельда, количество столбцов для маршрута
+ */
+static std::string makeKey(CipherAlgorithm algorithm, std::size_t number)
+{
+    if (algorithm == CipherAlgorithm::route)
+        return std::to_string(number + 2);
+    return benchText(16, L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ", static_cast<unsigned>(number + 1));
+}
+
+/**
+ * @brief Результат одного соединения
+ */
+struct ConnectionResult {
+    std::vector<double> latency; ///< Задержки успешных запросов, мкс
+    std::size_t errors = 0; ///< Ответы с ошибкой
+    std::string failure; ///< Ошибка ввода-вывода, прервавшая соединение
+};
+
+/**
+ * @brief Отправка запросов по одному соединению
+ * @param options - параметры нагрузки
+ * @param text - текст запросов
+ * @param first_key - номер ключа первого запроса
+ * @param result - результат соединения
+ */
+static void runConnection(const LoadOptions& options, const std::string& text, std::size_t first_key,
+                          ConnectionResult& result)
+{
+    int fd = -1;
+    try {
+        fd = connectSocket(options.socket_path);
+        std::vector<std::string> frames;
+        for (std::size_t k = 0; k < std::min(options.keys, options.requests); k++) {
+            CipherRequest request;
+            request.op = options.op;
+            request.algorithm = options.algorithm;
+            request.key = makeKey(options.algorithm, (first_key + k) % options.keys);
+            request.text = text;
+            frames.push_back(encodeRequest(request));
+        }
+        result.latency.reserve(options.requests);
+        std::string body;
+        CipherResponse response;
+        for (std::size_t i = 0; i < options.requests; i++) {
+            auto start = std::chrono::steady_clock::now();
+            writeFrame(fd, frames[i % frames.size()]);
+            if (!readFrame(fd, body))
+                throw std::system_error(ECONNRESET, std::generic_category(), "connection closed");
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (!decodeResponse(body, response) || response.status != ResponseStatus::ok) {
+                result.errors++;
+                continue;
+            }
+            result.latency.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+        }
+    } catch (const std::system_error& e) {
+        result.failure = e.what();
+    }
+    if (fd >= 0)
+        ::close(fd);
+}
+
+/**
+ * @brief Квантиль отсортированной выборки
+ * @param sorted - выборка по возрастанию
+ * @param q - уровень от 0 до 1
+ * @return Значение квантиля (0 для пустой выборки)
+ */
+static double quantile(const std::vector<double>& sorted, double q)
+{
+    if (sorted.empty())
+        return 0;
+    return sorted[static_cast<std::size_t>(q * (sorted.size() - 1))];
+}
+
+/**
+ * @brief Главная функция генератора нагрузки
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
+ * @return 0 если все запросы выполнены успешно, 1 иначе
+ */
+int main(int argc, char* argv[])
+{
+    LoadOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n" << usage(argv[0]);
+        return 1;
+    }
+
+    const std::wstring upper = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    const std::string text = options.op == CipherOp::decrypt
+        ? benchText(options.size, upper, 1)
+        : benchText(options.size, upper + L"абвгдеёжзийклмнопрстуфхцчшщъыьэюя    ,.!?-", 2);
+
+    std::vector<ConnectionResult> results(options.connections);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t c = 0; c < options.connections; c++)
+        threads.emplace_back(runConnection, std::cref(options), std::cref(text), c, std::ref(results[c]));
+    for (auto& t : threads)
+        t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> latency;
+    std::size_t errors = 0;
+    for (const ConnectionResult& r : results) {
+        latency.insert(latency.end(), r.latency.begin(), r.latency.end());
+        errors += r.errors;
+        if (!r.failure.empty()) {
+            std::cerr << "Ошибка соединения: " << r.failure << std::endl;
+            errors++;
+        }
+    }
+    std::sort(latency.begin(), latency.end());
+    double mean = 0;
+    for (double l : latency)
+        mean += l;
+    if (!latency.empty())
+        mean /= latency.size();
+
+    std::printf("{\n  \"benchmark\": \"cipher_load\",\n  \"algorithm\": \"%s\",\n  \"op\": \"%s\",\n"
+                "  \"connections\": %zu,\n  \"bytes\": %zu,\n  \"keys\": %zu,\n  \"requests\": %zu,\n"
+                "  \"errors\": %zu,\n  \"seconds\": %.6f,\n  \"requests_per_s\": %.1f,\n  \"mb_per_s\": %.3f,\n"
+                "  \"latency_us\": {\"mean\": %.1f, \"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f}\n}\n",
+                options.algorithm == CipherAlgorithm::route ? "route" : "gronsfeld",
+                options.op == CipherOp::decrypt ? "decrypt" : "encrypt",
+                options.connections, text.size(), options.keys, latency.size(), errors, seconds,
+                latency.size() / seconds, latency.size() * text.size() / seconds / 1e6,
+                mean, quantile(latency, 0.5), quantile(latency, 0.99), latency.empty() ? 0.0 : latency.back());
+    return errors == 0 ? 0 : 1;
+}
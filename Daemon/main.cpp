@@ -0,0 +1,347 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "server.h"
+#include "size_arg.h"
+#include "modAlphaCipher.h"
+#include "module.h"
+
+/**
+ * @file main.cpp (cipherd)
+ * @brief Главный модуль демона шифрования
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Демон работает до SIGINT или SIGTERM, затем дожидается ответов на принятые
+ * запросы и печатает счётчики демона и шифров в JSON. С --self-test (цель make test)
+ * проверяет кадры протокола, пакетирование запросов и вытеснение из кэша шифров.
+ */
+
+static CipherServer* running = nullptr; ///< Демон, останавливаемый обработчиком сигнала
+
+static const std::size_t max_workers = 1024; ///< Наибольшее значение --workers
+static const std::size_t max_batch = 1 << 16; ///< Наибольшее значение --batch
+static const std::size_t max_batch_delay = 10000000; ///< Наибольшее значение --batch-delay, мкс (10 с)
+static const std::size_t max_cache = 1 << 20; ///< Наибольшее значение --cache
+
+/**
+ * @brief Обработчик SIGINT и SIGTERM
+ * @param signal - номер сигнала
+ */
+extern "C" void stopServer(int signal)
+{
+    (void)signal;
+    if (running)
+        running->stop();
+}
+
+/**
+ * @brief Справка по параметрам
+ * @param program - имя программы
+ * @return Текст справки
+ */
+static std::string usage(const std::string& program)
+{
+    return "Использование: " + program + " [--socket ПУТЬ] [--workers N] [--batch N] [--batch-bytes РАЗМЕР]\n"
+           "               [--batch-delay МКС] [--cache N]\n"
+           "  --socket       путь к Unix-сокету (по умолчанию /tmp/cipherd.sock)\n"
+           "  --workers      исполнители пула, до 1024 (по умолчанию и при 0 - по числу ядер)\n"
+           "  --batch        наибольшее количество запросов в пакете, от 1 до 65536 (64)\n"
+           "  --batch-bytes  объём текста, после которого пакет закрывается (64K)\n"
+           "  --batch-delay  ожидание дополнительных запросов перед отправкой пакета, мкс, до 10000000 (0)\n"
+           "  --cache        ёмкость кэша шифров, до 1048576; 0 отключает кэш (64)\n";
+}
+
+/**
+ * @brief Разбор командной строки
+ * @param argc - количество аргументов
+ * @param argv - аргументы
+ * @return Параметры демона
+ * @throw std::invalid_argument если аргументы неверны
+ */
+static ServerOptions parseOptions(int argc, char* argv[])
+{
+    ServerOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 == argc)
+            throw std::invalid_argument("missing value for " + arg);
+        std::string value = argv[++i];
+        if (arg == "--socket")
+            options.socket_path = value;
+        else if (arg == "--workers")
+            options.workers = parseCount(value, "workers", 0, max_workers);
+        else if (arg == "--batch")
+            options.batch_max = parseCount(value, "batch", 1, max_batch);
+        else if (arg == "--batch-bytes")
+            options.batch_bytes = parseSize(value);
+        else if (arg == "--batch-delay")
+            options.batch_delay = std::chrono::microseconds(parseCount(value, "batch-delay", 0, max_batch_delay));
+        else if (arg == "--cache")
+            options.cache_capacity = parseCount(value, "cache", 0, max_cache);
+        else
+            throw std::invalid_argument("unknown option: " + arg);
+    }
+    return options;
+}
+
+/**
+ * @brief Вывод результата проверки
+ * @param name - название проверки
+ * @param ok - результат
+ * @return ok
+ */
+static bool report(const char* name, bool ok)
+{
+    std::cout << name << ": " << (ok ? "Ok" : "Err") << std::endl;
+    return ok;
+}
+
+/**
+ * @brief Проверка кодирования запросов и ответов и кадров на паре сокетов
+ * @return true если все кадры и сообщения восстановлены без изменений,
+ * а усечённые и слишком длинные кадры отклонены
+ */
+static bool checkFraming()
+{
+    CipherRequest request;
+    request.op = CipherOp::decrypt;
+    request.algorithm = CipherAlgorithm::route;
+    request.key = "order:3142";
+    request.text = "ТЕКСТ";
+    CipherRequest decoded;
+    std::string body = encodeRequest(request);
+    if (!decodeRequest(body, decoded) || decoded.op != request.op || decoded.algorithm != request.algorithm ||
+        decoded.key != request.key || decoded.text != request.text)
+        return false;
+    if (decodeRequest(body.substr(0, 3), decoded))
+        return false;
+    CipherResponse response;
+    response.status = ResponseStatus::cipher_error;
+    response.body = "Invalid key";
+    CipherResponse answer;
+    if (!decodeResponse(encodeResponse(response), answer) || answer.status != response.status ||
+        answer.body != response.body)
+        return false;
+
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0)
+        return false;
+    bool ok = true;
+    try {
+        std::string frame;
+        writeFrame(fds[0], body);
+        writeFrame(fds[0], "");
+        ok &= readFrame(fds[1], frame) && frame == body;
+        ok &= readFrame(fds[1], frame) && frame.empty();
+        const char oversized[4] = { '\x7f', '\0', '\0', '\0' };
+        ok &= ::write(fds[0], oversized, sizeof oversized) == sizeof oversized;
+        try {
+            readFrame(fds[1], frame);
+            ok = false;
+        } catch (const std::system_error& e) {
+            ok &= e.code().value() == EMSGSIZE;
+        }
+        const char truncated[6] = { '\0', '\0', '\0', '\x0a', 'a', 'b' };
+        ok &= ::write(fds[0], truncated, sizeof truncated) == sizeof truncated;
+        ::close(fds[0]);
+        fds[0] = -1;
+        try {
+            readFrame(fds[1], frame);
+            ok = false;
+        } catch (const std::system_error& e) {
+            ok &= e.code().value() == ECONNRESET;
+        }
+        ok &= !readFrame(fds[1], frame);
+    } catch (const std::system_error&) {
+        ok = false;
+    }
+    if (fds[0] >= 0)
+        ::close(fds[0]);
+    ::close(fds[1]);
+    return ok;
+}
+
+/**
+ * @brief Проверка пакетирования на работающем демоне
+ * @return true если все соединения получили верные ответы, запросы объединились
+ * в пакеты и ошибка шифра вернулась клиенту
+ * @details Соединения отправляют запросы одновременно, а batch_delay даёт очереди
+ * накопиться, поэтому пакетов должно быть меньше, чем запросов
+ */
+static bool checkBatching()
+{
+    const std::size_t clients = 8, rounds = 4;
+    ServerOptions options;
+    options.socket_path = "/tmp/cipherd-self-test-" + std::to_string(::getpid()) + ".sock";
+    options.workers = 2;
+    options.batch_max = clients;
+    options.batch_delay = std::chrono::milliseconds(50);
+
+    CipherRequest request;
+    request.key = "КЛЮЧ";
+    request.text = "Привет, мир!";
+    std::string expected(request.text.size(), '\0');
+    expected.resize(makeCipher(request.algorithm, request.key)->run(
+        request.op, request.text.data(), request.text.size(), &expected[0], expected.size()));
+
+    std::atomic<bool> ok(true);
+    ServerStats stats;
+    try {
+        CipherServer server(options);
+        std::thread acceptor([&] {
+            try {
+                server.run();
+            } catch (const std::system_error&) {
+                ok = false;
+            }
+        });
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < clients; t++) {
+            threads.emplace_back([&, t] {
+                int fd = -1;
+                try {
+                    fd = connectSocket(options.socket_path);
+                    std::string body;
+                    CipherResponse response;
+                    for (std::size_t round = 0; round < rounds; round++) {
+                        writeFrame(fd, encodeRequest(request));
+                        if (!readFrame(fd, body) || !decodeResponse(body, response) ||
+                            response.status != ResponseStatus::ok || response.body != expected)
+                            ok = false;
+                    }
+                    if (t == 0) {
+                        CipherRequest invalid = request;
+                        invalid.key = "KEY";
+                        writeFrame(fd, encodeRequest(invalid));
+                        if (!readFrame(fd, body) || !decodeResponse(body, response) ||
+                            response.status != ResponseStatus::cipher_error)
+                            ok = false;
+                    }
+                } catch (const std::system_error&) {
+                    ok = false;
+                }
+                if (fd >= 0)
+                    ::close(fd);
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        server.stop();
+        acceptor.join();
+        stats = server.stats();
+    } catch (const std::system_error&) {
+        return false;
+    }
+    const unsigned long long requests = clients * rounds + 1;
+    return ok && stats.connections == clients && stats.requests == requests && stats.failed == 1 &&
+           stats.batches >= requests / clients && stats.batches < requests;
+}
+
+/**
+ * @brief Проверка вытеснения из кэша шифров
+ * @return true если давно не используемый шифр вытесняется, счётчики попаданий и промахов
+ * верны, вытесненный шифр остаётся рабочим, а невалидные ключи и нулевая ёмкость не кэшируются
+ */
+static bool checkCacheEviction()
+{
+    const CipherAlgorithm gronsfeld = CipherAlgorithm::gronsfeld;
+    try {
+        CipherCache cache(2);
+        CipherCache::Cipher first = cache.get(gronsfeld, "КЛЮЧ");
+        cache.get(gronsfeld, "ШИФР");
+        bool ok = cache.get(gronsfeld, "КЛЮЧ") == first; // попадание, ШИФР - давно не используемый
+        cache.get(CipherAlgorithm::route, "5"); // вытесняет ШИФР
+        ok &= cache.size() == 2 && cache.hits() == 1 && cache.misses() == 3;
+        cache.get(gronsfeld, "ШИФР"); // промах, вытесняет КЛЮЧ
+        ok &= cache.get(CipherAlgorithm::route, "5") != nullptr; // попадание
+        ok &= cache.get(gronsfeld, "КЛЮЧ") != first; // промах: создан новый шифр
+        ok &= cache.size() == 2 && cache.hits() == 2 && cache.misses() == 5;
+
+        char out[16];
+        ok &= first->run(CipherOp::encrypt, "мир", 6, out, sizeof out) == 6;
+
+        try {
+            cache.get(gronsfeld, "KEY");
+            ok = false;
+        } catch (const cipher_error&) {
+        }
+        ok &= cache.size() == 2 && cache.misses() == 6;
+
+        CipherCache disabled(0);
+        disabled.get(gronsfeld, "КЛЮЧ");
+        disabled.get(gronsfeld, "КЛЮЧ");
+        ok &= disabled.size() == 0 && disabled.hits() == 0 && disabled.misses() == 2;
+        return ok;
+    } catch (const cipher_error&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Неинтерактивная проверка демона
+ * @return 0 если все проверки прошли, 1 при ошибке
+ * @details Запускается с --self-test из цели make test; демон слушает временный сокет
+ * в /tmp, который удаляется после проверки
+ */
+static int selfTest()
+{
+    bool ok = report("framing", checkFraming());
+    ok &= report("batching", checkBatching());
+    ok &= report("cache eviction", checkCacheEviction());
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Главная функция демона
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
+ * @return 0 при штатной остановке, 1 при ошибке
+ * @details С --self-test проверяет протокол, пакетирование и кэш (см. selfTest)
+ */
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--self-test")
+        return selfTest();
+
+    ServerOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n" << usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        CipherServer server(options);
+        running = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        std::cerr << "Демон слушает " << options.socket_path << std::endl;
+        server.run();
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        running = nullptr;
+
+        ServerStats stats = server.stats();
+        std::printf("{\n  \"connections\": %llu,\n  \"requests\": %llu,\n  \"failed\": %llu,\n"
+                    "  \"batches\": %llu,\n  \"cache_hits\": %llu,\n  \"cache_misses\": %llu\n}\n",
+                    stats.connections, stats.requests, stats.failed, stats.batches,
+                    stats.cache_hits, stats.cache_misses);
+        std::printf("%s", formatStats("modAlphaCipher", modAlphaCipher::stats().snapshot()).c_str());
+        std::printf("%s", formatStats("RouteCipher", RouteCipher::stats().snapshot()).c_str());
+    } catch (const std::system_error& e) {
+        std::cerr << "Ошибка ввода-вывода: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include "protocol.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @file protocol.cpp
+ * @brief Реализация протокола обмена с демоном шифрования
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+static const std::size_t request_header = 4; ///< Операция, шифр и длина ключа
+
+/**
+ * @brief Исключение с текущим errno
+ * @param what - описание операции
+ * @return Исключение для выброса
+ */
+static std::system_error socketError(const std::string& what)
+{
+    return std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * @brief Кодирование запроса в тело кадра
+ * @param request - запрос
+ * @return Тело кадра
+ * @throw std::length_error если ключ длиннее 65535 байт
+ */
+std::string encodeRequest(const CipherRequest& request)
+{
+    if (request.key.size() > 0xFFFF)
+        throw std::length_error("key is too long");
+    std::string body;
+    body.reserve(request_header + request.key.size() + request.text.size());
+    body.push_back(static_cast<char>(request.op));
+    body.push_back(static_cast<char>(request.algorithm));
+    body.push_back(static_cast<char>(request.key.size() >> 8));
+    body.push_back(static_cast<char>(request.key.size() & 0xFF));
+    body += request.key;
+    body += request.text;
+    return body;
+}
+
+/**
+ * @brief Разбор тела кадра запроса
+ * @param body - тело кадра
+ * @param request - разобранный запрос
+ * @return false если тело короче заголовка или операция и шифр неизвестны
+ */
+bool decodeRequest(const std::string& body, CipherRequest& request)
+{
+    if (body.size() < request_header)
+        return false;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(body.data());
+    if (p[0] != static_cast<unsigned char>(CipherOp::encrypt) && p[0] != static_cast<unsigned char>(CipherOp::decrypt))
+        return false;
+    if (p[1] != static_cast<unsigned char>(CipherAlgorithm::gronsfeld) &&
+        p[1] != static_cast<unsigned char>(CipherAlgorithm::route))
+        return false;
+    std::size_t key_size = (std::size_t(p[2]) << 8) | p[3];
+    if (body.size() < request_header + key_size)
+        return false;
+    request.op = static_cast<CipherOp>(p[0]);
+    request.algorithm = static_cast<CipherAlgorithm>(p[1]);
+    request.key.assign(body, request_header, key_size);
+    request.text.assign(body, request_header + key_size, std::string::npos);
+    return true;
+}
+
+/**
+ * @brief Кодирование ответа в тело кадра
+ * @param response - ответ
+ * @return Тело кадра
+ */
+std::string encodeResponse(const CipherResponse& response)
+{
+    std::string body;
+    body.reserve(1 + response.body.size());
+    body.push_back(static_cast<char>(response.status));
+    body += response.body;
+    return body;
+}
+
+/**
+ * @brief Разбор тела кадра ответа
+ * @param body - тело кадра
+ * @param response - разобранный ответ
+ * @return false если тело пусто или состояние неизвестно
+ */
+bool decodeResponse(const std::string& body, CipherResponse& response)
+{
+    if (body.empty() || static_cast<unsigned char>(body[0]) > static_cast<unsigned char>(ResponseStatus::bad_request))
+        return false;
+    response.status = static_cast<ResponseStatus>(body[0]);
+    response.body.assign(body, 1, std::string::npos);
+    return true;
+}
+
+/**
+ * @brief Чтение ровно n байт
+ * @param fd - сокет
+ * @param p - буфер
+ * @param n - количество байт
+ * @return Количество прочитанных байт (меньше n, только если соединение закрыто)
+ * @throw std::system_error при ошибке чтения
+ */
+static std::size_t readFull(int fd, char* p, std::size_t n)
+{
+    std::size_t done = 0;
+    while (done < n) {
+        ssize_t k = ::recv(fd, p + done, n - done, 0);
+        if (k == 0)
+            break;
+        if (k < 0) {
+            if (errno == EINTR)
+                continue;
+            throw socketError("recv");
+        }
+        done += k;
+    }
+    return done;
+}
+
+/**
+ * @brief Запись ровно n байт
+ * @param fd - сокет
+ * @param p - данные
+ * @param n - количество байт
+ * @throw std::system_error при ошибке записи
+ * @details MSG_NOSIGNAL: закрытое другой стороной соединение даёт EPIPE, а не SIGPIPE
+ */
+static void writeFull(int fd, const char* p, std::size_t n)
+{
+    while (n > 0) {
+        ssize_t k = ::send(fd, p, n, MSG_NOSIGNAL);
+        if (k < 0) {
+            if (errno == EINTR)
+                continue;
+            throw socketError("send");
+        }
+        p += k;
+        n -= k;
+    }
+}
+
+/**
+ * @brief Чтение кадра
+ * @param fd - сокет
+ * @param body - тело кадра
+ * @return false если соединение закрыто до начала кадра
+ * @throw std::system_error при ошибке чтения, обрыве внутри кадра или кадре длиннее max_frame_size
+ */
+bool readFrame(int fd, std::string& body)
+{
+    unsigned char header[4];
+    std::size_t k = readFull(fd, reinterpret_cast<char*>(header), sizeof header);
+    if (k == 0)
+        return false;
+    if (k < sizeof header)
+        throw std::system_error(ECONNRESET, std::generic_category(), "truncated frame");
+    std::size_t size = (std::size_t(header[0]) << 24) | (std::size_t(header[1]) << 16) |
+                       (std::size_t(header[2]) << 8) | header[3];
+    if (size > max_frame_size)
+        throw std::system_error(EMSGSIZE, std::generic_category(), "frame");
+    body.resize(size);
+    if (readFull(fd, &body[0], size) < size)
+        throw std::system_error(ECONNRESET, std::generic_category(), "truncated frame");
+    return true;
+}
+
+/**
+ * @brief Запись кадра
+ * @param fd - сокет
+ * @param body - тело кадра
+ * @throw std::system_error при ошибке записи (в том числе если другая сторона закрыла соединение)
+ */
+void writeFrame(int fd, const std::string& body)
+{
+    if (body.size() > max_frame_size)
+        throw std::system_error(EMSGSIZE, std::generic_category(), "frame");
+    std::string frame(4, '\0');
+    frame[0] = static_cast<char>(body.size() >> 24);
+    frame[1] = static_cast<char>(body.size() >> 16);
+    frame[2] = static_cast<char>(body.size() >> 8);
+    frame[3] = static_cast<char>(body.size());
+    frame += body;
+    writeFull(fd, frame.data(), frame.size());
+}
+
+/**
+ * @brief Заполнение адреса Unix-сокета
+ * @param path - путь к сокету
+ * @param addr - адрес
+ * @throw std::system_error если путь не помещается в адрес
+ */
+static void socketAddress(const std::string& path, sockaddr_un& addr)
+{
+    std::memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof addr.sun_path)
+        throw std::system_error(ENAMETOOLONG, std::generic_category(), path);
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+}
+
+/**
+ * @brief Подключение к демону
+ * @param path - путь к сокету
+ * @return Дескриптор подключённого сокета
+ * @throw std::system_error если подключиться не удалось
+ */
+int connectSocket(const std::string& path)
+{
+    sockaddr_un addr;
+    socketAddress(path, addr);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw socketError("socket");
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0) {
+        std::system_error e = socketError(path);
+        ::close(fd);
+        throw e;
+    }
+    return fd;
+}
+
+/**
+ * @brief Создание слушающего сокета
+ * @param path - путь к сокету; существующий файл сокета заменяется
+ * @return Дескриптор слушающего сокета
+ * @throw std::system_error если сокет не удалось создать
+ */
+int listenSocket(const std::string& path)
+{
+    sockaddr_un addr;
+    socketAddress(path, addr);
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+        ::unlink(path.c_str());
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw socketError("socket");
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0 || ::listen(fd, SOMAXCONN) < 0) {
+        std::system_error e = socketError(path);
+        ::close(fd);
+        throw e;
+    }
+    return fd;
+}
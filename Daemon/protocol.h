@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file protocol.h
+ * @brief Протокол обмена с демоном шифрования через Unix-сокет
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Каждое сообщение — кадр: длина тела (4 байта, старший байт первым) и тело.
+ * Тело запроса: операция (1 байт), шифр (1 байт), длина ключа (2 байта, старший
+ * байт первым), ключ в UTF-8 и текст в UTF-8 до конца кадра.
+ * Тело ответа: состояние (1 байт) и результат в UTF-8 или текст ошибки.
+ * По одному соединению можно отправлять запросы один за другим; ответы приходят
+ * в порядке запросов. Ошибки ввода-вывода сообщаются исключением std::system_error.
+ */
+
+/**
+ * @brief Операция над текстом
+ */
+enum class CipherOp : unsigned char {
+    encrypt = 1, ///< Шифрование
+    decrypt = 2  ///< Дешифрование
+};
+
+/**
+ * @brief Шифр
+ */
+enum class CipherAlgorithm : unsigned char {
+    gronsfeld = 1, ///< Шифр Гронсфельда (modAlphaCipher), ключ — буквы русского алфавита
+    route = 2      ///< Маршрутная перестановка (RouteCipher), ключ — см. RouteKey
+};
+
+/**
+ * @brief Состояние ответа
+ */
+enum class ResponseStatus : unsigned char {
+    ok = 0,           ///< Тело — результат
+    cipher_error = 1, ///< Неверный ключ или текст; тело — текст ошибки
+    bad_request = 2   ///< Запрос не разобран; тело — текст ошибки
+};
+
+/**
+ * @brief Запрос к демону
+ */
+struct CipherRequest {
+    CipherOp op = CipherOp::encrypt; ///< Операция
+    CipherAlgorithm algorithm = CipherAlgorithm::gronsfeld; ///< Шифр
+    std::string key; ///< Ключ в UTF-8
+    std::string text; ///< Текст в UTF-8
+};
+
+/**
+ * @brief Ответ демона
+ */
+struct CipherResponse {
+    ResponseStatus status = ResponseStatus::ok; ///< Состояние
+    std::string body; ///< Результат или текст ошибки
+};
+
+static const std::size_t max_frame_size = std::size_t(1) << 26; ///< Наибольший размер тела кадра (64 МБ)
+
+/**
+ * @brief Кодирование запроса в тело кадра
+ * @param request - запрос
+ * @return Тело кадра
+ * @throw std::length_error если ключ длиннее 65535 байт
+ */
+std::string encodeRequest(const CipherRequest& request);
+
+/**
+ * @brief Разбор тела кадра запроса
+ * @param body - тело кадра
+ * @param request - разобранный запрос
+ * @return false если тело короче заголовка или операция и шифр неизвестны
+ */
+bool decodeRequest(const std::string& body, CipherRequest& request);
+
+/**
+ * @brief Кодирование ответа в тело кадра
+ * @param response - ответ
+ * @return Тело кадра
+ */
+std::string encodeResponse(const CipherResponse& response);
+
+/**
+ * @brief Разбор тела кадра ответа
+ * @param body - тело кадра
+ * @param response - разобранный ответ
+ * @return false если тело пусто или состояние неизвестно
+ */
+bool decodeResponse(const std::string& body, CipherResponse& response);
+
+/**
+ * @brief Чтение кадра
+ * @param fd - сокет
+ * @param body - тело кадра
+ * @return false если соединение закрыто до начала кадра
+ * @throw std::system_error при ошибке чтения, обрыве внутри кадра или кадре длиннее max_frame_size
+ */
+bool readFrame(int fd, std::string& body);
+
+/**
+ * @brief Запись кадра
+ * @param fd - сокет
+ * @param body - тело кадра
+ * @throw std::system_error при ошибке записи (в том числе если другая сторона закрыла соединение)
+ */
+void writeFrame(int fd, const std::string& body);
+
+/**
+ * @brief Подключение к демону
+ * @param path - путь к сокету
+ * @return Дескриптор подключённого сокета
+ * @throw std::system_error если подключиться не удалось
+ */
+int connectSocket(const std::string& path);
+
+/**
+ * @brief Создание слушающего сокета
+ * @param path - путь к сокету; существующий файл сокета заменяется
+ * @return Дескриптор слушающего сокета
+ * @throw std::system_error если сокет не удалось создать
+ */
+int listenSocket(const std::string& path);
@@ -0,0 +1,256 @@
+#include "server.h"
+#include "cipher_error.h"
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @file server.cpp
+ * @brief Реализация демона шифрования
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Создание демона и слушающего сокета
+ * @param options - параметры
+ * @throw std::system_error если сокет не удалось создать
+ */
+CipherServer::CipherServer(const ServerOptions& options):
+    options(options),
+    cache(options.cache_capacity),
+    pool(options.workers)
+{
+    if (::pipe2(wake_fd, O_CLOEXEC | O_NONBLOCK) < 0)
+        throw std::system_error(errno, std::generic_category(), "pipe");
+    try {
+        listen_fd = listenSocket(options.socket_path);
+    } catch (...) {
+        ::close(wake_fd[0]);
+        ::close(wake_fd[1]);
+        throw;
+    }
+    batcher = std::thread(&CipherServer::batchLoop, this);
+}
+
+/**
+ * @brief Остановка демона и удаление файла сокета
+ */
+CipherServer::~CipherServer()
+{
+    reap(true);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    batcher.join();
+    ::close(listen_fd);
+    ::unlink(options.socket_path.c_str());
+    ::close(wake_fd[0]);
+    ::close(wake_fd[1]);
+}
+
+/**
+ * @brief Приём соединений до вызова stop()
+ * @details После stop() закрывает соединения, дожидается выполнения принятых
+ * запросов и возвращает управление
+ * @throw std::system_error при ошибке приёма соединения
+ */
+void CipherServer::run()
+{
+    pollfd fds[2] = { { listen_fd, POLLIN, 0 }, { wake_fd[0], POLLIN, 0 } };
+    for (;;) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "poll");
+        }
+        if (fds[1].revents != 0)
+            break;
+        reap(false);
+        int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "accept");
+        }
+        connection_count++;
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        connections.emplace_back();
+        Connection& connection = connections.back();
+        connection.fd = fd;
+        connection.thread = std::thread(&CipherServer::serve, this, std::ref(connection));
+    }
+
+    // Соединения закрываются на чтение: потоки дописывают ответы на уже принятые запросы
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (Connection& connection : connections) {
+            if (connection.fd >= 0)
+                ::shutdown(connection.fd, SHUT_RD);
+        }
+    }
+    reap(true);
+}
+
+/**
+ * @brief Запрос остановки
+ * @details Безопасен для вызова из обработчика сигнала
+ */
+void CipherServer::stop()
+{
+    char c = 0;
+    ssize_t k = ::write(wake_fd[1], &c, 1);
+    (void)k;
+}
+
+/**
+ * @brief Текущие счётчики
+ * @return Снимок счётчиков
+ */
+ServerStats CipherServer::stats() const
+{
+    ServerStats result;
+    result.connections = connection_count;
+    result.requests = request_count;
+    result.failed = failed_count;
+    result.batches = batch_count;
+    result.cache_hits = cache.hits();
+    result.cache_misses = cache.misses();
+    return result;
+}
+
+/**
+ * @brief Обслуживание соединения
+ * @param connection - соединение
+ * @details Ошибка ввода-вывода или неверный кадр закрывают только это соединение
+ */
+void CipherServer::serve(Connection& connection)
+{
+    try {
+        std::string frame;
+        while (readFrame(connection.fd, frame)) {
+            Job job;
+            if (decodeRequest(frame, job.request)) {
+                submit(job);
+            } else {
+                failed_count++;
+                job.response.status = ResponseStatus::bad_request;
+                job.response.body = "Malformed request";
+            }
+            writeFrame(connection.fd, encodeResponse(job.response));
+        }
+    } catch (const std::system_error&) {
+    }
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        ::close(connection.fd);
+        connection.fd = -1;
+    }
+    connection.finished = true;
+}
+
+/**
+ * @brief Постановка запроса в очередь и ожидание ответа
+ * @param job - запрос
+ */
+void CipherServer::submit(Job& job)
+{
+    std::future<void> done = job.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(&job);
+    }
+    ready.notify_all();
+    done.wait();
+}
+
+/**
+ * @brief Цикл потока пакетирования
+ * @details При остановке оставшиеся запросы отправляются в пул без ожидания
+ * свободного исполнителя, чтобы все ожидающие соединения получили ответ
+ */
+void CipherServer::batchLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        ready.wait(lock, [&] { return stopping || (!queue.empty() && in_flight < pool.size()); });
+        if (queue.empty())
+            return;
+        if (options.batch_delay.count() > 0 && !stopping && queue.size() < options.batch_max) {
+            auto deadline = std::chrono::steady_clock::now() + options.batch_delay;
+            ready.wait_until(lock, deadline, [&] { return stopping || queue.size() >= options.batch_max; });
+        }
+
+        auto batch = std::make_shared<std::vector<Job*>>();
+        std::size_t bytes = 0;
+        while (!queue.empty() && batch->size() < options.batch_max &&
+               (batch->empty() || bytes + queue.front()->request.text.size() <= options.batch_bytes)) {
+            bytes += queue.front()->request.text.size();
+            batch->push_back(queue.front());
+            queue.pop_front();
+        }
+        in_flight++;
+        batch_count++;
+        lock.unlock();
+        pool.submit([this, batch] {
+            for (Job* job : *batch)
+                process(*job);
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                in_flight--;
+            }
+            ready.notify_all();
+        });
+        lock.lock();
+    }
+}
+
+/**
+ * @brief Выполнение одного запроса
+ * @param job - запрос, в который записывается ответ
+ */
+void CipherServer::process(Job& job)
+{
+    const CipherRequest& request = job.request;
+    CipherResponse& response = job.response;
+    try {
+        CipherCache::Cipher cipher = cache.get(request.algorithm, request.key);
+        response.body.resize(request.text.size());
+        response.body.resize(cipher->run(request.op, request.text.data(), request.text.size(),
+                                         &response.body[0], response.body.size()));
+        response.status = ResponseStatus::ok;
+    } catch (const cipher_error& e) {
+        failed_count++;
+        response.status = ResponseStatus::cipher_error;
+        response.body = e.what();
+    } catch (const std::exception& e) {
+        failed_count++;
+        response.status = ResponseStatus::bad_request;
+        response.body = e.what();
+    }
+    request_count++;
+    job.done.set_value();
+}
+
+/**
+ * @brief Присоединение завершившихся потоков соединений
+ * @param all - true чтобы дождаться всех потоков
+ */
+void CipherServer::reap(bool all)
+{
+    for (auto it = connections.begin(); it != connections.end();) {
+        if (all || it->finished) {
+            it->thread.join();
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            it = connections.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
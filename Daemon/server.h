@@ -0,0 +1,165 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "cipher_cache.h"
+#include "protocol.h"
+#include "thread_pool.h"
+
+/**
+ * @file server.h
+ * @brief Заголовочный файл демона шифрования
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Параметры демона
+ */
+struct ServerOptions {
+    std::string socket_path = "/tmp/cipherd.sock"; ///< Путь к Unix-сокету
+    std::size_t workers = 0; ///< Исполнители пула (0 — по числу ядер)
+    std::size_t batch_max = 64; ///< Наибольшее количество запросов в пакете
+    std::size_t batch_bytes = std::size_t(1) << 16; ///< Объём текста, после которого пакет закрывается
+    std::chrono::microseconds batch_delay{0}; ///< Ожидание дополнительных запросов перед отправкой пакета
+    std::size_t cache_capacity = CipherCache::default_capacity; ///< Ёмкость кэша шифров
+};
+
+/**
+ * @brief Счётчики демона
+ */
+struct ServerStats {
+    unsigned long long connections = 0; ///< Принятые соединения
+    unsigned long long requests = 0; ///< Выполненные запросы
+    unsigned long long failed = 0; ///< Запросы с ошибкой шифра или разбора
+    unsigned long long batches = 0; ///< Отправленные в пул пакеты
+    unsigned long long cache_hits = 0; ///< Попадания в кэш шифров
+    unsigned long long cache_misses = 0; ///< Промахи кэша шифров
+};
+
+/**
+ * @brief Демон шифрования на Unix-сокете
+ * @details Каждое соединение обслуживается своим потоком, который читает кадры
+ * (см. protocol.h) и ставит запросы в общую очередь. Поток пакетирования забирает из
+ * очереди сразу несколько запросов и отправляет их в пул одной задачей, поэтому
+ * накладные расходы пула и пробуждения исполнителя делятся на весь пакет.
+ * Новый пакет собирается, только когда в пуле есть свободный исполнитель: при малой
+ * нагрузке запрос уходит сразу, а при большой в очереди успевает накопиться пакет.
+ * Пакет закрывается по batch_max запросам или batch_bytes байтам текста, так что
+ * большой запрос не задерживает мелкие. Шифры берутся из CipherCache.
+ */
+class CipherServer
+{
+public:
+    /**
+     * @brief Создание демона и слушающего сокета
+     * @param options - параметры
+     * @throw std::system_error если сокет не удалось создать
+     */
+    explicit CipherServer(const ServerOptions& options);
+
+    /**
+     * @brief Остановка демона и удаление файла сокета
+     */
+    ~CipherServer();
+
+    CipherServer(const CipherServer&) = delete; ///< Демон не копируется
+    CipherServer& operator=(const CipherServer&) = delete; ///< Демон не копируется
+
+    /**
+     * @brief Приём соединений до вызова stop()
+     * @details После stop() закрывает соединения, дожидается выполнения принятых
+     * запросов и возвращает управление
+     * @throw std::system_error при ошибке приёма соединения
+     */
+    void run();
+
+    /**
+     * @brief Запрос остановки
+     * @details Безопасен для вызова из обработчика сигнала
+     */
+    void stop();
+
+    /**
+     * @brief Текущие счётчики
+     * @return Снимок счётчиков
+     */
+    ServerStats stats() const;
+
+private:
+    /**
+     * @brief Запрос, ожидающий выполнения
+     */
+    struct Job {
+        CipherRequest request; ///< Запрос
+        CipherResponse response; ///< Ответ
+        std::promise<void> done; ///< Сигнал о готовности ответа
+    };
+
+    /**
+     * @brief Поток соединения
+     */
+    struct Connection {
+        int fd = -1; ///< Сокет
+        std::thread thread; ///< Обслуживающий поток
+        std::atomic<bool> finished{false}; ///< Поток завершился и может быть присоединён
+    };
+
+    ServerOptions options; ///< Параметры
+    int listen_fd = -1; ///< Слушающий сокет
+    int wake_fd[2] = { -1, -1 }; ///< Канал пробуждения приёма для stop()
+    CipherCache cache; ///< Кэш шифров
+    ThreadPool pool; ///< Исполнители пакетов
+    std::thread batcher; ///< Поток пакетирования
+
+    std::mutex mutex; ///< Защита очереди, счётчика пакетов в пуле и признака остановки
+    std::condition_variable ready; ///< Новый запрос, освободившийся исполнитель или остановка
+    std::deque<Job*> queue; ///< Запросы, ожидающие пакета
+    std::size_t in_flight = 0; ///< Пакеты в пуле
+    bool stopping = false; ///< Признак остановки пакетирования
+
+    std::list<Connection> connections; ///< Соединения (изменяется только потоком run())
+    std::mutex connections_mutex; ///< Защита дескрипторов соединений при остановке
+
+    std::atomic<unsigned long long> connection_count{0}; ///< Принятые соединения
+    std::atomic<unsigned long long> request_count{0}; ///< Выполненные запросы
+    std::atomic<unsigned long long> failed_count{0}; ///< Запросы с ошибкой
+    std::atomic<unsigned long long> batch_count{0}; ///< Пакеты
+
+    /**
+     * @brief Обслуживание соединения
+     * @param connection - соединение
+     */
+    void serve(Connection& connection);
+
+    /**
+     * @brief Постановка запроса в очередь и ожидание ответа
+     * @param job - запрос
+     */
+    void submit(Job& job);
+
+    /**
+     * @brief Цикл потока пакетирования
+     */
+    void batchLoop();
+
+    /**
+     * @brief Выполнение одного запроса
+     * @param job - запрос, в который записывается ответ
+     */
+    void process(Job& job);
+
+    /**
+     * @brief Присоединение завершившихся потоков соединений
+     * @param all - true чтобы дождаться всех потоков
+     */
+    void reap(bool all);
+};
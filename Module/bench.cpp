@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "module.h"
+#include "bench_util.h"
+
+/**
+ * @file bench.cpp (RouteCipher)
+ * @brief Измерение производительности шифра маршрутной перестановки
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Измеряет шифрование и дешифрование текста в UTF-8 через encrypt_into/decrypt_into
+ * для размеров входа от 16 Б до 1 ГБ и числа столбцов от 1 до 10 000.
+ * Вход valid состоит только из заглавных букв, dirty — из букв обоих регистров
+ * (кириллица и латиница), цифр, пробелов и знаков препинания. Результат выводится в JSON.
+ */
+
+/**
+ * @brief Главная функция программы измерений
+ * @param argc - количество аргументов
+ * @param argv - аргументы (см. parseBenchOptions)
+ * @return 0 при успешном завершении, 1 при ошибке в аргументах
+ */
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        options = parseBenchOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Ошибка: %s\n", e.what());
+        return 1;
+    }
+
+    const std::wstring upper = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    const std::wstring dirty = upper + L"абвгдеёжзийклмнопрстуфхцчшщъыьэюяABCXYZabcxyz    ,.!?-0123456789\n";
+    const std::size_t column_counts[] = { 1, 10, 100, 1000, 10000 };
+
+    std::vector<BenchResult> results;
+    for (std::size_t size : benchSizes(options)) {
+        const std::string inputs[] = { benchText(size, upper, 1), benchText(size, dirty, 2) };
+        const char* names[] = { "valid", "dirty" };
+        std::string out(size, '\0');
+        for (std::size_t columns : column_counts) {
+            RouteCipher cipher(std::to_wstring(columns));
+            for (int v = 0; v < 2; v++) {
+                BenchResult r;
+                r.op = "encrypt";
+                r.input = names[v];
+                r.param = "columns";
+                r.param_value = columns;
+                r.bytes = inputs[v].size();
+                r.chars = utf8Chars(inputs[v]);
+                try {
+                    benchMeasure(options, [&] {
+                        cipher.encrypt_into(inputs[v].data(), inputs[v].size(), &out[0], out.size());
+                    }, r);
+                    results.push_back(r);
+                } catch (const cipher_error& e) {
+                    std::fprintf(stderr, "Пропуск encrypt/%s/%zu Б: %s\n", names[v], size, e.what());
+                }
+            }
+
+            std::string cipher_text = cipher.encrypt(std::string_view(inputs[0]));
+            BenchResult r;
+            r.op = "decrypt";
+            r.input = "valid";
+            r.param = "columns";
+            r.param_value = columns;
+            r.bytes = cipher_text.size();
+            r.chars = utf8Chars(cipher_text);
+            benchMeasure(options, [&] {
+                cipher.decrypt_into(cipher_text.data(), cipher_text.size(), &out[0], out.size());
+            }, r);
+            results.push_back(r);
+        }
+        std::fprintf(stderr, "Готово: %zu Б\n", size);
+    }
+    benchPrintJson("RouteCipher", results);
+    return 0;
+}
@@ -1,7 +1,17 @@
 #include <iostream>
 #include <locale>
 #include <string>
+#include <system_error>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <memory>
 #include "module.h"
+#include "file_mode.h"
+#include "file_pipeline.h"
+#include "thread_pool.h"
 
 /**
  * @file main.cpp (RouteCipher)
@@ -17,24 +27,411 @@
  * @brief Проверка корректности ключа
  * @param s - строка с ключом
  * @return true если ключ валиден, false в противном случае
- * @details Ключ должен быть положительным целым числом, состоящим только из цифр
+ * @details Ключ — положительное целое число или маршрут: order:3142, snake:N, spiral:N
  */
 bool isValidKey(const std::wstring& s) {
-    if (s.empty()) return false;
-    for (auto c : s) {
-        if (!std::iswdigit(c)) return false;
+    return RouteCipher::checkKey(s).ok();
+}
+
+/**
+ * @brief Проверка одновременных вызовов одного экземпляра шифра из нескольких потоков
+ * @param cipher - общий неизменяемый экземпляр шифра
+ * @return true если все результаты совпали с ожидаемыми
+ * @details Потоки шифруют и расшифровывают разные тексты через один const-объект,
+ * сравнивают шифртекст с однопоточным, а расшифровку - с очищенным исходным текстом.
+ * Для поиска гонок программу следует собрать целью make tsan (ThreadSanitizer),
+ * которая запускает эту проверку через --self-test
+ */
+bool checkConcurrent(const RouteCipher& cipher) {
+    struct Sample {
+        std::wstring text; ///< Открытый текст
+        std::wstring plain; ///< Ожидаемый результат decrypt(encrypt(text))
+    };
+    const Sample samples[] = {
+        {L"ПРИВЕТ", L"ПРИВЕТ"},
+        {L"Маршрутная перестановка", L"МАРШРУТНАЯПЕРЕСТАНОВКА"},
+        {L"Съешь же ещё этих мягких французских булок, да выпей чаю",
+         L"СЪЕШЬЖЕЕЩЁЭТИХМЯГКИХФРАНЦУЗСКИХБУЛОКДАВЫПЕЙЧАЮ"},
+        {L"The quick brown fox jumps over the lazy dog", L"THEQUICKBROWNFOXJUMPSOVERTHELAZYDOG"}
+    };
+    const std::size_t count = sizeof samples / sizeof samples[0];
+    std::vector<std::wstring> expected;
+    try {
+        for (const auto& sample : samples)
+            expected.push_back(cipher.encrypt(sample.text));
+    } catch (const cipher_error&) {
+        return false;
+    }
+
+    const unsigned threads = std::max(4u, std::thread::hardware_concurrency());
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            try {
+                for (std::size_t round = 0; round < 1000; round++) {
+                    std::size_t i = (t + round) % count;
+                    std::wstring encrypted = cipher.encrypt(samples[i].text);
+                    if (encrypted != expected[i] || cipher.decrypt(encrypted) != samples[i].plain)
+                        ok = false;
+                }
+            } catch (const cipher_error&) {
+                ok = false;
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    return ok;
+}
+
+/**
+ * @brief Текст из заглавных букв для проверок
+ * @param length - количество букв
+ * @return Детерминированная последовательность букв русского алфавита
+ */
+static std::wstring sampleText(std::size_t length) {
+    static const wchar_t letters[] = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    std::wstring text(length, L'\0');
+    for (std::size_t i = 0; i < length; i++)
+        text[i] = letters[(i * 7 + 3) % 33];
+    return text;
+}
+
+/**
+ * @brief Проверка дешифрования отрезка
+ * @param cipher - шифр
+ * @return true если decrypt_range(text, from, from + n) совпадает с decrypt(text).substr(from, n)
+ * @details Длины текста не кратны числу столбцов (неполная последняя строка), отрезки
+ * начинаются в начале, середине и конце текста и доходят до его конца; отрезок
+ * за концом текста должен отклоняться
+ */
+static bool checkDecryptRange(const RouteCipher& cipher) {
+    const std::size_t lengths[] = { 1, 2, 7, 13, 29, 64, 101 };
+    try {
+        for (std::size_t length : lengths) {
+            const std::wstring encrypted = cipher.encrypt(sampleText(length));
+            const std::wstring plain = cipher.decrypt(encrypted);
+            const std::size_t starts[] = { 0, 1, length / 2, length - 1, length };
+            for (std::size_t from : starts) {
+                if (from > length)
+                    continue;
+                const std::size_t counts[] = { 0, 1, 5, length - from };
+                for (std::size_t n : counts) {
+                    if (from + n > length)
+                        continue;
+                    if (cipher.decrypt_range(encrypted, from, from + n) != plain.substr(from, n))
+                        return false;
+                }
+            }
+            try {
+                cipher.decrypt_range(encrypted, 0, length + 1);
+                return false;
+            } catch (const cipher_error&) {
+            }
+        }
+    } catch (const cipher_error&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Проверка шифрования и дешифрования на месте
+ * @param cipher - шифр
+ * @return true если encrypt_in_place/decrypt_in_place и их try_-варианты совпадают
+ * с encrypt/decrypt, а при ошибке try_decrypt_in_place текст не меняется
+ * @details На месте перестановка всегда выполняется обходом циклов (routeCycles), а образец
+ * encrypt/decrypt для длины ниже plan_max_length строится по плану, для длины выше - без него
+ */
+static bool checkInPlace(const RouteCipher& cipher) {
+    const std::size_t lengths[] = { 1001, RouteCipher::plan_max_length + 3 };
+    try {
+        for (std::size_t length : lengths) {
+            const std::wstring plain = sampleText(length);
+            const std::wstring encrypted = cipher.encrypt(plain);
+            const std::wstring decrypted = cipher.decrypt(encrypted);
+
+            std::wstring text = plain;
+            cipher.encrypt_in_place(text);
+            if (text != encrypted)
+                return false;
+            cipher.decrypt_in_place(text);
+            if (text != decrypted)
+                return false;
+
+            text = plain;
+            if (!cipher.try_encrypt_in_place(text).ok() || text != encrypted)
+                return false;
+            if (!cipher.try_decrypt_in_place(text).ok() || text != decrypted)
+                return false;
+
+            std::wstring invalid = encrypted;
+            invalid[length / 2] = L'я';
+            const std::wstring before = invalid;
+            cipher_status status = cipher.try_decrypt_in_place(invalid);
+            if (status.error != cipher_errc::invalid_cipher_text || status.offset != length / 2 || invalid != before)
+                return false;
+        }
+    } catch (const cipher_error&) {
+        return false;
     }
-    int key = std::stoi(s);
-    return key > 0;
+    return true;
+}
+
+/**
+ * @brief Начало символа UTF-8 не дальше заданной позиции
+ * @param s - текст в UTF-8
+ * @param pos - позиция в байтах
+ * @return Позиция первого байта символа, содержащего байт pos
+ */
+static std::size_t charStart(const std::string& s, std::size_t pos) {
+    while (pos > 0 && (static_cast<unsigned char>(s[pos]) & 0xC0) == 0x80)
+        pos--;
+    return pos;
+}
+
+/**
+ * @brief Проверка многопоточных перегрузок на пуле из нескольких исполнителей
+ * @param cipher - шифр
+ * @param pool - пул потоков
+ * @return true если многопоточные encrypt/decrypt, *_into и try_*_into с порогом 1
+ * совпадают с однопоточными, в том числе видом и позицией ошибки
+ */
+static bool checkPool(const RouteCipher& cipher, ThreadPool& pool) {
+    std::wstring wide;
+    std::string utf8;
+    for (int i = 0; i < 40; i++) {
+        wide += L"Съешь же ещё этих мягких французских булок, да выпей чаю. ";
+        utf8 += "Съешь же ещё этих мягких французских булок, да выпей чаю. ";
+    }
+    try {
+        const std::wstring encrypted = cipher.encrypt(wide);
+        if (cipher.encrypt(wide, pool, 1) != encrypted ||
+            cipher.decrypt(encrypted, pool, 1) != cipher.decrypt(encrypted))
+            return false;
+
+        std::string serial(utf8.size(), '\0'), parallel(utf8.size(), '\0');
+        serial.resize(cipher.encrypt_into(utf8.data(), utf8.size(), &serial[0], serial.size()));
+        parallel.resize(cipher.encrypt_into(utf8.data(), utf8.size(), &parallel[0], parallel.size(), pool, 1));
+        if (parallel != serial)
+            return false;
+        const std::string cipher_text = serial;
+        std::string plain(cipher_text.size(), '\0');
+        plain.resize(cipher.decrypt_into(cipher_text.data(), cipher_text.size(), &plain[0], plain.size()));
+        parallel.assign(cipher_text.size(), '\0');
+        parallel.resize(cipher.decrypt_into(cipher_text.data(), cipher_text.size(), &parallel[0],
+                                            parallel.size(), pool, 1));
+        if (parallel != plain)
+            return false;
+
+        std::string out(utf8.size(), '\0');
+        std::size_t written = 0;
+        if (!cipher.try_encrypt_into(utf8.data(), utf8.size(), &out[0], out.size(), written, pool, 1).ok() ||
+            out.compare(0, written, cipher_text) != 0 || written != cipher_text.size())
+            return false;
+        if (!cipher.try_decrypt_into(cipher_text.data(), cipher_text.size(), &out[0], out.size(), written,
+                                     pool, 1).ok() || out.compare(0, written, plain) != 0 || written != plain.size())
+            return false;
+
+        std::string bad = utf8;
+        const std::size_t bad_at = charStart(bad, bad.size() / 2);
+        bad.insert(bad_at, "\xff");
+        out.assign(bad.size(), '\0');
+        cipher_status expected = cipher.try_encrypt_into(bad.data(), bad.size(), &out[0], out.size(), written);
+        cipher_status status = cipher.try_encrypt_into(bad.data(), bad.size(), &out[0], out.size(), written, pool, 1);
+        if (expected.error != cipher_errc::invalid_utf8 || expected.offset != bad_at ||
+            status.error != expected.error || status.offset != expected.offset)
+            return false;
+
+        bad = cipher_text;
+        const std::size_t lower_at = charStart(bad, bad.size() / 3);
+        bad.insert(lower_at, "я");
+        out.assign(bad.size(), '\0');
+        expected = cipher.try_decrypt_into(bad.data(), bad.size(), &out[0], out.size(), written);
+        status = cipher.try_decrypt_into(bad.data(), bad.size(), &out[0], out.size(), written, pool, 1);
+        if (expected.error != cipher_errc::invalid_cipher_text || expected.offset != lower_at ||
+            status.error != expected.error || status.offset != expected.offset)
+            return false;
+
+        bad = cipher_text;
+        bad.insert(charStart(bad, bad.size() / 2), "\xff");
+        expected = cipher.try_decrypt_into(bad.data(), bad.size(), &out[0], out.size(), written);
+        status = cipher.try_decrypt_into(bad.data(), bad.size(), &out[0], out.size(), written, pool, 1);
+        if (expected.error != cipher_errc::invalid_utf8 || status.error != expected.error ||
+            status.offset != expected.offset)
+            return false;
+    } catch (const cipher_error&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Проверка кэша планов перестановки
+ * @param key - ключ шифра
+ * @return true если повтор ключа и длины попадает в кэш, длина больше plan_max_length
+ * обходит кэш, а нулевая ёмкость отключает его
+ * @details Шифр создаётся заново, чтобы счётчики не зависели от других проверок
+ */
+static bool checkPlanCache(const std::wstring& key) {
+    try {
+        const RouteCipher cipher(key);
+        RoutePlanCache& cache = cipher.planCache();
+        cache.clear();
+        const std::wstring text = sampleText(100);
+        const std::wstring encrypted = cipher.encrypt(text);
+        if (cache.misses() != 1 || cache.hits() != 0 || cache.size() != 1)
+            return false;
+        if (cipher.encrypt(text) != encrypted || cipher.decrypt(encrypted) != text)
+            return false;
+        if (cache.misses() != 1 || cache.hits() != 2)
+            return false;
+
+        cipher.encrypt(sampleText(RouteCipher::plan_max_length + 1));
+        if (cache.misses() != 1 || cache.hits() != 2 || cache.size() != 1)
+            return false;
+
+        cache.setCapacity(0);
+        if (cache.size() != 0 || cipher.encrypt(text) != encrypted || cipher.encrypt(text) != encrypted)
+            return false;
+        if (cache.hits() != 2 || cache.size() != 0)
+            return false;
+    } catch (const cipher_error&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Вывод результата проверки
+ * @param check - название проверки
+ * @param key - ключ шифра
+ * @param ok - результат
+ * @return ok
+ */
+static bool report(const char* check, const char* key, bool ok) {
+    std::cout << check << " " << key << ": " << (ok ? "Ok" : "Err") << std::endl;
+    return ok;
+}
+
+/**
+ * @brief Неинтерактивная проверка шифра
+ * @return 0 если все проверки прошли, 1 при ошибке
+ * @details Запускается с --self-test из целей make test и make tsan, без ввода
+ * и без локали; для ключа каждого вида проверяет одновременные вызовы,
+ * дешифрование отрезка, шифрование на месте, многопоточные перегрузки и кэш планов
+ */
+int selfTest() {
+    const char* keys[] = { "5", "order:3142", "snake:4", "spiral:5" };
+    ThreadPool pool(4);
+    bool ok = true;
+    for (const char* key : keys) {
+        const RouteCipher cipher(std::wstring(key, key + std::strlen(key)));
+        ok &= report("concurrent", key, checkConcurrent(cipher));
+        ok &= report("decrypt_range", key, checkDecryptRange(cipher));
+        ok &= report("in place", key, checkInPlace(cipher));
+        ok &= report("thread pool", key, checkPool(cipher, pool));
+        ok &= report("plan cache", key, checkPlanCache(std::wstring(key, key + std::strlen(key))));
+    }
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Счётчики кэша планов перестановки в JSON
+ * @param cache - кэш планов шифра
+ * @return Объект JSON с попаданиями, промахами, размером и ёмкостью кэша
+ */
+static std::string formatPlanCache(const RoutePlanCache& cache) {
+    return "{\n  \"cache\": \"RoutePlanCache\",\n  \"hits\": " + std::to_string(cache.hits()) +
+           ",\n  \"misses\": " + std::to_string(cache.misses()) +
+           ",\n  \"size\": " + std::to_string(cache.size()) +
+           ",\n  \"capacity\": " + std::to_string(cache.capacity()) + "\n}\n";
+}
+
+/**
+ * @brief Неинтерактивная обработка файла
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
+ * @return 0 при успешном завершении, 1 при ошибке
+ * @details Файл обрабатывается в UTF-8 через отображение в память, без локали и широких потоков.
+ * С --pipeline каждая строка файла шифруется отдельно, блоки читаются и записываются конвейером.
+ * Иначе с ограничением памяти (--memory) файл обрабатывается потоково за несколько проходов.
+ * С --stats статистика шифра и счётчики кэша планов перестановки печатаются и при ошибке
+ */
+int fileMode(int argc, char* argv[]) {
+    FileJob job;
+    try {
+        job = parseFileJob(argc, argv);
+        if (!job.pipeline && job.memory_budget > 0 && job.memory_budget < RouteCipher::min_memory_budget)
+            throw std::invalid_argument("memory budget is too small: at least 256K is required");
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n"
+                  << fileModeUsage(argv[0], "количество столбцов или маршрут: order:3142, snake:N, spiral:N")
+                  << "С --memory (не меньше 256K) файл читается заново на каждом проходе: для текста\n"
+                     "из N букв при ограничении M байт проходов около 2N/M, объём чтения растёт как N²/M.\n";
+        return 1;
+    }
+
+    int result = 0;
+    std::unique_ptr<RouteCipher> route;
+    try {
+        route.reset(new RouteCipher(std::wstring(job.key.begin(), job.key.end())));
+        const RouteCipher& cipher = *route;
+        if (job.pipeline) {
+            // Перестановка нужна вся запись сразу, поэтому каждая строка шифруется целиком
+            ThreadPool pool;
+            runPipelinedFileJob(job, FileFraming::records,
+                [&](const char* in, std::size_t n, char* out, std::size_t out_size) {
+                    return job.encrypt ? cipher.encrypt_into(in, n, out, out_size, pool)
+                                       : cipher.decrypt_into(in, n, out, out_size, pool);
+                });
+        } else if (job.memory_budget > 0) {
+            if (job.encrypt)
+                cipher.encrypt_file(job.input, job.output, job.memory_budget);
+            else
+                cipher.decrypt_file(job.input, job.output, job.memory_budget);
+        } else {
+            ThreadPool pool;
+            runFileJob(job, [&](const char* in, std::size_t n, char* out, std::size_t out_size) {
+                return job.encrypt ? cipher.encrypt_into(in, n, out, out_size, pool)
+                                   : cipher.decrypt_into(in, n, out, out_size, pool);
+            });
+        }
+    } catch (const cipher_error& e) {
+        std::cerr << "Ошибка обработки файла: " << e.what() << std::endl;
+        result = 1;
+    } catch (const std::system_error& e) {
+        std::cerr << "Ошибка ввода-вывода: " << e.what() << std::endl;
+        result = 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Неожиданная ошибка: " << e.what() << std::endl;
+        result = 1;
+    }
+    if (job.stats) {
+        std::cout << formatStats("RouteCipher", RouteCipher::stats().snapshot());
+        if (route)
+            std::cout << formatPlanCache(route->planCache());
+    }
+    return result;
 }
 
 /**
  * @brief Главная функция программы
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
  * @return 0 при успешном завершении, 1 при ошибке
- * @details Устанавливает локаль для работы с русским языком, принимает ключ от пользователя,
- * создаёт экземпляр шифра RouteCipher и предоставляет интерактивное меню для операций шифрования/дешифрования
+ * @details С --self-test проверяет шифр (см. selfTest), с другими аргументами обрабатывает
+ * файл (см. fileMode). Без аргументов устанавливает
+ * локаль для работы с русским языком, принимает ключ от пользователя, создаёт экземпляр
+ * шифра RouteCipher и предоставляет интерактивное меню для операций шифрования/дешифрования
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--self-test")
+        return selfTest();
+    if (argc > 1)
+        return fileMode(argc, argv);
+
     // Настройка локали для поддержки русского языка
     std::locale::global(std::locale(""));
     std::wcout.imbue(std::locale());
@@ -42,7 +439,7 @@ int main() {
     
     try {
         std::wstring key_str;
-        std::wcout << L"Введите ключ (количество столбцов): ";
+        std::wcout << L"Введите ключ (количество столбцов или order:3142, snake:N, spiral:N): ";
         std::wcin >> key_str;
         std::wcin.ignore(); 
         
@@ -50,18 +447,20 @@ int main() {
         if (!isValidKey(key_str)) {
             std::wcerr << L"Ошибка: неверный ключ\n";
             std::wcerr << L"Ключ должен быть положительным целым числом (например: 3, 5, 7)\n";
+            std::wcerr << L"или маршрутом (например: order:3142, snake:4, spiral:5)\n";
             return 1;
         }
         
         // Создание экземпляра шифра с указанным ключом
         RouteCipher cipher(key_str);
-        std::wcout << L"Ключ загружен: " << key_str << L" столбцов\n";
+        std::wcout << L"Ключ загружен: " << key_str << L", столбцов: " << cipher.columns() << L"\n";
         
         // Главный цикл программы
         while (true) {
             std::wcout << L"\n=========== МЕНЮ ===========\n";
             std::wcout << L"1 - Шифровать текст\n";
             std::wcout << L"2 - Дешифровать текст\n";
+            std::wcout << L"3 - Протестировать одновременные вызовы из нескольких потоков\n";
             std::wcout << L"0 - Выход из программы\n";
             std::wcout << L"Выберите операцию: ";
             
@@ -76,8 +475,14 @@ int main() {
             }
             
             // Проверка корректности выбора операции
-            if (choice > 2 || choice < 0) {
-                std::wcout << L"Неверная операция! Пожалуйста, выберите 0, 1 или 2\n";
+            if (choice > 3 || choice < 0) {
+                std::wcout << L"Неверная операция! Пожалуйста, выберите 0, 1, 2 или 3\n";
+                continue;
+            }
+
+            // Проверка многопоточного использования
+            if (choice == 3) {
+                std::wcout << L"Результат: " << (checkConcurrent(cipher) ? L"Ok" : L"Err") << std::endl;
                 continue;
             }
             
@@ -2,7 +2,12 @@
 #include <stdexcept>
 #include <locale>
 #include <string>
-#include <cwctype>
+#include <vector>
+#include <climits>
+#include <algorithm>
+#include "utf8.h"
+#include "letters.h"
+#include "thread_pool.h"
 
 /**
  * @file module.cpp
@@ -12,36 +17,346 @@
  * @date 2025
  */
 
+/**
+ * @brief Счётчики шифра, общие для всех объектов класса
+ * @return Статистика вызовов
+ */
+CipherStats& RouteCipher::stats() {
+    static CipherStats counters;
+    return counters;
+}
+
+/**
+ * @brief Учёт отклонённого вызова
+ * @param status - результат с ошибкой
+ * @return Тот же результат
+ */
+static cipher_status rejected(const cipher_status& status) {
+    RouteCipher::stats().addRejected();
+    return status;
+}
+
+/**
+ * @brief Выделение буфера результата с учётом в статистике
+ * @tparam Buffer - строка или вектор
+ * @param n - количество элементов
+ * @return Буфер из n нулевых элементов
+ */
+template <typename Buffer>
+static Buffer allocateResult(std::size_t n) {
+    StageTimer timer(RouteCipher::stats(), CipherStage::allocate);
+    RouteCipher::stats().addAllocated(n * sizeof(typename Buffer::value_type));
+    return Buffer(n, typename Buffer::value_type());
+}
+
+static const std::size_t tile = 32; ///< Сторона квадратного блока транспонирования, блок помещается в L1
+
+/**
+ * @brief Блочное транспонирование части таблицы маршрутной перестановки
+ * @tparam Encrypt - true для шифрования (строки в столбцы), false для дешифрования
+ * @tparam T - тип символа
+ * @param in - исходный текст
+ * @param out - результат той же длины
+ * @param length - длина текста
+ * @param columns - количество столбцов таблицы
+ * @param start - начала отрезков столбцов (RouteMap::columnStarts)
+ * @param row_begin, row_end - строки таблицы [row_begin, row_end), включая неполную последнюю
+ * @param col_begin, col_end - столбцы таблицы [col_begin, col_end)
+ * @details Полные строки обходятся блоками tile x tile: внутри блока и чтение
+ * с шагом columns, и запись в отрезки столбцов попадают в уже загруженные строки кэша,
+ * поэтому скорость не падает с ростом columns. Неполная последняя строка
+ * переносится отдельным проходом. Разные части таблицы пишут в непересекающиеся
+ * позиции результата и могут обрабатываться одновременно
+ */
+template <bool Encrypt, typename T>
+static void routeTransposeBlock(const T* in, T* out, std::size_t length, std::size_t columns,
+                                const std::vector<std::size_t>& start,
+                                std::size_t row_begin, std::size_t row_end,
+                                std::size_t col_begin, std::size_t col_end) {
+    const std::size_t body_rows = length / columns;
+    const std::size_t body_end = std::min(row_end, body_rows);
+    for (std::size_t r0 = row_begin; r0 < body_end; r0 += tile) {
+        const std::size_t r1 = std::min(r0 + tile, body_end);
+        for (std::size_t c0 = col_begin; c0 < col_end; c0 += tile) {
+            const std::size_t c1 = std::min(c0 + tile, col_end);
+            for (std::size_t col = c0; col < c1; col++) {
+                for (std::size_t row = r0; row < r1; row++) {
+                    if constexpr (Encrypt)
+                        out[start[col] + row] = in[row * columns + col];
+                    else
+                        out[row * columns + col] = in[start[col] + row];
+                }
+            }
+        }
+    }
+    if (row_begin > body_rows || row_end <= body_rows)
+        return;
+    const std::size_t tail_end = std::min(col_end, length % columns);
+    for (std::size_t col = col_begin; col < tail_end; col++) {
+        if constexpr (Encrypt)
+            out[start[col] + body_rows] = in[body_rows * columns + col];
+        else
+            out[body_rows * columns + col] = in[start[col] + body_rows];
+    }
+}
+
+/**
+ * @brief Блочное транспонирование таблицы маршрутной перестановки
+ * @tparam Encrypt - true для шифрования (строки в столбцы), false для дешифрования
+ * @tparam T - тип символа
+ * @param key - ключ со столбцовым маршрутом (RouteKey::columnar)
+ * @param in - исходный текст
+ * @param out - результат той же длины
+ * @param length - длина текста
+ */
+template <bool Encrypt, typename T>
+static void routeTranspose(const RouteKey& key, const T* in, T* out, std::size_t length) {
+    const std::size_t columns = key.columns;
+    const std::vector<std::size_t> start = RouteMap(key, length).columnStarts();
+    const std::size_t rows = (length + columns - 1) / columns;
+    routeTransposeBlock<Encrypt>(in, out, length, columns, start, 0, rows, 0, start.size());
+}
+
+/**
+ * @brief Разбиение отрезка [0, n) на части для пула потоков
+ * @param n - длина отрезка
+ * @param parts - желаемое количество частей
+ * @param align - кратность границ частей (кроме последней)
+ * @return Границы частей: bounds[i]..bounds[i + 1]
+ */
+static std::vector<std::size_t> splitRange(std::size_t n, std::size_t parts, std::size_t align) {
+    std::size_t units = (n + align - 1) / align;
+    parts = std::max<std::size_t>(1, std::min(parts, units));
+    std::vector<std::size_t> bounds(parts + 1);
+    for (std::size_t i = 0; i <= parts; i++)
+        bounds[i] = std::min(n, (units / parts * i + std::min(i, units % parts)) * align);
+    return bounds;
+}
+
+/**
+ * @brief Многопоточное блочное транспонирование
+ * @tparam Encrypt - true для шифрования, false для дешифрования
+ * @tparam T - тип символа
+ * @param pool - пул потоков
+ * @param key - ключ со столбцовым маршрутом (RouteKey::columnar)
+ * @param in - исходный текст
+ * @param out - результат той же длины
+ * @param length - длина текста
+ * @details При шифровании каждый столбец — непрерывный отрезок результата, поэтому
+ * между исполнителями делятся столбцы; при дешифровании непрерывны строки, и делятся
+ * строки. Если в выбранном измерении слишком мало блоков, делится другое
+ */
+template <bool Encrypt, typename T>
+static void routeTransposeParallel(ThreadPool& pool, const RouteKey& key, const T* in, T* out,
+                                   std::size_t length) {
+    const std::size_t columns = key.columns;
+    const std::vector<std::size_t> start = RouteMap(key, length).columnStarts();
+    const std::size_t rows = (length + columns - 1) / columns;
+    const std::size_t parts = pool.size() * 4;
+    bool by_columns = Encrypt ? start.size() >= parts * tile : rows < parts * tile;
+    std::vector<std::size_t> bounds = splitRange(by_columns ? start.size() : rows, parts, tile);
+    pool.parallelFor(bounds.size() - 1, [&](std::size_t i) {
+        if (by_columns)
+            routeTransposeBlock<Encrypt>(in, out, length, columns, start, 0, rows, bounds[i], bounds[i + 1]);
+        else
+            routeTransposeBlock<Encrypt>(in, out, length, columns, start, bounds[i], bounds[i + 1], 0, start.size());
+    });
+}
+
+/**
+ * @brief Разбиение текста в UTF-8 на части по границам символов
+ * @param in - текст
+ * @param n - длина в байтах
+ * @param parts - желаемое количество частей
+ * @return Границы частей; ни одна граница не приходится на байт продолжения
+ */
+static std::vector<std::size_t> splitUtf8(const char* in, std::size_t n, std::size_t parts) {
+    std::vector<std::size_t> bounds = splitRange(n, parts, 1);
+    for (std::size_t i = 1; i + 1 < bounds.size(); i++) {
+        std::size_t b = std::max(bounds[i], bounds[i - 1]);
+        while (b < n && (static_cast<unsigned char>(in[b]) & 0xC0) == 0x80)
+            b++;
+        bounds[i] = b;
+    }
+    return bounds;
+}
+
+/**
+ * @brief Многопоточное кодирование букв в UTF-8
+ * @param pool - пул потоков
+ * @param text - буквы
+ * @param length - количество букв
+ * @param out - буфер достаточного размера
+ * @return Количество записанных байтов
+ * @details Сначала параллельно считается длина каждой части в байтах,
+ * затем каждая часть кодируется со своего смещения
+ */
+static std::size_t encodeParallel(ThreadPool& pool, const char16_t* text, std::size_t length, char* out) {
+    std::vector<std::size_t> bounds = splitRange(length, pool.size() * 4, 1);
+    const std::size_t parts = bounds.size() - 1;
+    std::vector<std::size_t> offsets(parts + 1, 0);
+    pool.parallelFor(parts, [&](std::size_t i) {
+        std::size_t bytes = 0;
+        for (std::size_t k = bounds[i]; k < bounds[i + 1]; k++)
+            bytes += utf8Length(text[k]);
+        offsets[i + 1] = bytes;
+    });
+    for (std::size_t i = 0; i < parts; i++)
+        offsets[i + 1] += offsets[i];
+    pool.parallelFor(parts, [&](std::size_t i) {
+        char* p = out + offsets[i];
+        for (std::size_t k = bounds[i]; k < bounds[i + 1]; k++)
+            p += utf8Encode(text[k], p);
+    });
+    return offsets[parts];
+}
+
+/**
+ * @brief Первая ошибка среди результатов частей текста
+ * @param status - результаты частей в порядке следования
+ * @return Результат первой части с ошибкой или успешный результат
+ */
+static cipher_status firstFailure(const std::vector<cipher_status>& status) {
+    for (const auto& st : status) {
+        if (!st)
+            return st;
+    }
+    return cipher_status();
+}
+
+/**
+ * @brief Перестановка по плану или блочным транспонированием
+ * @tparam Encrypt - true для шифрования (выборка по плану), false для дешифрования (разброс)
+ * @tparam T - тип символа
+ * @param route - план перестановки или nullptr (только для столбцовых маршрутов)
+ * @param key - ключ
+ * @param in - исходный текст
+ * @param out - результат той же длины
+ * @param length - длина текста
+ */
+template <bool Encrypt, typename T>
+static void routePermute(const RoutePlanCache::Plan& route, const RouteKey& key, const T* in, T* out,
+                         std::size_t length) {
+    if (!route) {
+        routeTranspose<Encrypt>(key, in, out, length);
+        return;
+    }
+    const std::uint32_t* index = route->data();
+    for (std::size_t i = 0; i < length; i++) {
+        if constexpr (Encrypt)
+            out[i] = in[index[i]];
+        else
+            out[index[i]] = in[i];
+    }
+}
+
+/**
+ * @brief Многопоточная перестановка по плану или блочным транспонированием
+ * @tparam Encrypt - true для шифрования, false для дешифрования
+ * @tparam T - тип символа
+ * @param pool - пул потоков
+ * @param route - план перестановки или nullptr (только для столбцовых маршрутов)
+ * @param key - ключ
+ * @param in - исходный текст
+ * @param out - результат той же длины
+ * @param length - длина текста
+ * @details По плану между исполнителями делятся позиции шифртекста: каждая позиция
+ * плана встречается ровно один раз, поэтому части пишут в непересекающиеся места
+ */
+template <bool Encrypt, typename T>
+static void routePermuteParallel(ThreadPool& pool, const RoutePlanCache::Plan& route, const RouteKey& key,
+                                 const T* in, T* out, std::size_t length) {
+    if (!route) {
+        routeTransposeParallel<Encrypt>(pool, key, in, out, length);
+        return;
+    }
+    const std::uint32_t* index = route->data();
+    std::vector<std::size_t> bounds = splitRange(length, pool.size() * 4, tile);
+    pool.parallelFor(bounds.size() - 1, [&](std::size_t part) {
+        for (std::size_t i = bounds[part]; i < bounds[part + 1]; i++) {
+            if constexpr (Encrypt)
+                out[i] = in[index[i]];
+            else
+                out[index[i]] = in[i];
+        }
+    });
+}
+
+/**
+ * @brief Перестановка текста на месте обходом циклов
+ * @tparam Encrypt - true для шифрования, false для дешифрования
+ * @param text - текст, заменяемый результатом
+ * @param length - длина текста
+ * @param map - маршрут для этой длины
+ * @details Позиция каждой буквы в результате берётся из RouteMap::target() без таблицы
+ * размером с текст. Перестановка раскладывается на циклы; каждый
+ * цикл проходится один раз, как при транспонировании матрицы на месте. Уже поставленные
+ * на место символы помечаются битом visited, который не встречается в кодах Unicode
+ * (не больше 0x10FFFF), и пометки снимаются последним проходом. Дополнительная
+ * память — несколько переменных
+ */
+template <bool Encrypt>
+static void routeCycles(wchar_t* text, std::size_t length, const RouteMap& map) {
+    static_assert(sizeof(wchar_t) >= 4, "wchar_t must hold the visited bit");
+    const wchar_t visited = wchar_t(1) << 30;
+
+    for (std::size_t first = 0; first < length; first++) {
+        if (text[first] & visited)
+            continue;
+        if constexpr (Encrypt) {
+            // Разброс: символ с позиции i переносится на map.target(i)
+            wchar_t carry = text[first];
+            std::size_t i = first;
+            do {
+                i = map.target(i);
+                std::swap(carry, text[i]);
+                text[i] |= visited;
+            } while (i != first);
+        } else {
+            // Выборка: на позицию i ставится символ с позиции map.target(i)
+            wchar_t saved = text[first];
+            std::size_t i = first;
+            for (std::size_t next = map.target(i); next != first; next = map.target(i)) {
+                text[i] = text[next] | visited;
+                i = next;
+            }
+            text[i] = saved | visited;
+        }
+    }
+    for (std::size_t i = 0; i < length; i++)
+        text[i] &= ~visited;
+}
+
 /**
  * @brief Конструктор RouteCipher
  * @param key - ключ шифрования (количество столбцов)
  * @throw cipher_error если ключ невалиден
  */
 RouteCipher::RouteCipher(const std::wstring& key) {
-    std::wstring valid_key = getValidKey(key);
-    columns = std::stoi(valid_key);
+    throwIfFailed(RouteKey::compile(key, route_key));
 }
 
 /**
- * @brief Проверка ключа на валидность
- * @param s - исходный ключ
- * @return Нормализованная строка ключа
- * @throw cipher_error если ключ невалиден
+ * @brief Проверка ключа без исключений
+ * @param key - ключ шифрования (количество столбцов)
+ * @return Вид ошибки и позиция первого недопустимого символа ключа
  */
-std::wstring RouteCipher::getValidKey(const std::wstring& s) {
-    if (s.empty())
-        throw cipher_error("Empty key");
-    
-    for (auto c : s) {
-        if (!std::iswdigit(c))
-            throw cipher_error("Invalid key - must contain only digits");
-    }
-    
-    int key_value = std::stoi(s);
-    if (key_value <= 0)
-        throw cipher_error("Key must be greater than 0");
-    
-    return s;
+cipher_status RouteCipher::checkKey(const std::wstring& key) {
+    RouteKey parsed;
+    return RouteKey::compile(key, parsed);
+}
+
+/**
+ * @brief Проверка открытого текста без исключений
+ * @param text - открытый текст
+ * @return Вид ошибки (пустой текст после очистки)
+ */
+cipher_status RouteCipher::checkOpenText(const std::wstring& text) {
+    for (auto c : text) {
+        if (isLetter(c))
+            return cipher_status();
+    }
+    return cipher_status(cipher_errc::empty_open_text);
 }
 
 /**
@@ -50,35 +365,39 @@ std::wstring RouteCipher::getValidKey(const std::wstring& s) {
  * @return Текст в верхнем регистре без не-букв
  * @throw cipher_error если текст пуст после очистки
  */
-std::wstring RouteCipher::getValidOpenText(const std::wstring& s) {
-    std::wstring tmp;
-    for (auto c : s) {
-        if (std::iswalpha(c)) {
-            if (std::iswlower(c))
-                tmp.push_back(std::towupper(c));
-            else
-                tmp.push_back(c);
-        }
-    }
+std::wstring RouteCipher::getValidOpenText(const std::wstring& s) const {
+    std::wstring tmp(s.size(), L'\0');
+    tmp.resize(foldLetters(s.data(), s.size(), &tmp[0]));
     if (tmp.empty())
-        throw cipher_error("Empty open text");
+        throwIfFailed(rejected(cipher_status(cipher_errc::empty_open_text)));
     return tmp;
 }
 
+/**
+ * @brief Проверка шифртекста без исключений
+ * @param text - шифртекст
+ * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой
+ */
+cipher_status RouteCipher::checkCipherText(const std::wstring& text) {
+    if (text.empty())
+        return cipher_status(cipher_errc::empty_cipher_text);
+
+    std::size_t i = upperLetterSpan(text.data(), text.size());
+    if (i < text.size())
+        return cipher_status(cipher_errc::invalid_cipher_text, i);
+    return cipher_status();
+}
+
 /**
  * @brief Проверка шифртекста
  * @param s - шифртекст
  * @return Текст без изменений
  * @throw cipher_error если текст пуст или содержит не заглавные буквы
  */
-std::wstring RouteCipher::getValidCipherText(const std::wstring& s) {
-    if (s.empty())
-        throw cipher_error("Empty cipher text");
-    
-    for (auto c : s) {
-        if (!std::iswupper(c))
-            throw cipher_error("Invalid cipher text - must contain only uppercase letters");
-    }
+std::wstring RouteCipher::getValidCipherText(const std::wstring& s) const {
+    cipher_status status = checkCipherText(s);
+    if (!status)
+        throwIfFailed(rejected(status));
     return s;
 }
 
@@ -88,8 +407,8 @@ std::wstring RouteCipher::getValidCipherText(const std::wstring& s) {
  * @throw cipher_error если ключ невалиден
  */
 void RouteCipher::setKey(const std::wstring& key) {
-    std::wstring valid_key = getValidKey(key);
-    columns = std::stoi(valid_key);
+    throwIfFailed(RouteKey::compile(key, route_key));
+    plans.clear();
 }
 
 /**
@@ -97,7 +416,45 @@ void RouteCipher::setKey(const std::wstring& key) {
  * @return Строковое представление ключа
  */
 std::wstring RouteCipher::getKey() const {
-    return std::to_wstring(columns);
+    return route_key.text();
+}
+
+const std::size_t RouteCipher::plan_max_length;
+const std::size_t RouteCipher::parallel_threshold;
+
+/**
+ * @brief План перестановки для текущего ключа и заданной длины
+ * @param length - длина текста
+ * @return План из кэша (построенный при промахе) или nullptr, если план не используется
+ * @details Для столбцовых маршрутов план — результат транспонирования последовательности
+ * 0, 1, ..., length - 1; для длинных текстов таблица индексов больше самого текста,
+ * и блочное транспонирование выгоднее выборки по плану. Змейка и спираль всегда
+ * выполняются по плану, построенному через RouteMap::target(); планы длиннее
+ * plan_max_length не кэшируются
+ */
+RoutePlanCache::Plan RouteCipher::plan(std::size_t length) const {
+    const bool cached = length <= plan_max_length;
+    if (route_key.columnar() && (!cached || plans.capacity() == 0))
+        return nullptr;
+    if (cached) {
+        RoutePlanCache::Plan route = plans.find(route_key.columns, length);
+        if (route)
+            return route;
+    }
+    RoutePlanCache::Table table(length);
+    if (route_key.columnar()) {
+        RoutePlanCache::Table identity(length);
+        for (std::size_t i = 0; i < length; i++)
+            identity[i] = i;
+        routeTranspose<true>(route_key, identity.data(), table.data(), length);
+    } else {
+        RouteMap map(route_key, length);
+        for (std::size_t i = 0; i < length; i++)
+            table[map.target(i)] = i;
+    }
+    if (!cached)
+        return std::make_shared<const RoutePlanCache::Table>(std::move(table));
+    return plans.insert(route_key.columns, length, std::move(table));
 }
 
 /**
@@ -106,21 +463,14 @@ std::wstring RouteCipher::getKey() const {
  * @return Зашифрованная строка
  * @throw cipher_error если текст пуст после очистки
  */
-std::wstring RouteCipher::encrypt(const std::wstring& text) {
+std::wstring RouteCipher::encrypt(const std::wstring& text) const {
+    stats().addCall(text.size());
+    StageTimer validate(stats(), CipherStage::validate);
     std::wstring clean_text = getValidOpenText(text);
-    
-    std::size_t text_length = clean_text.length();
-    std::size_t rows = (text_length + columns - 1) / columns;
-    std::wstring result;
-    
-    for (int col = columns - 1; col >= 0; col--) {
-        for (std::size_t row = 0; row < rows; row++) {
-            std::size_t pos = row * columns + col;
-            if (pos < text_length) {
-                result += clean_text[pos];
-            }
-        }
-    }
+    validate.stop();
+    std::wstring result = allocateResult<std::wstring>(clean_text.length());
+    StageTimer timer(stats(), CipherStage::transform);
+    routePermute<true>(plan(clean_text.length()), route_key, clean_text.data(), &result[0], clean_text.length());
     return result;
 }
 
@@ -130,21 +480,607 @@ std::wstring RouteCipher::encrypt(const std::wstring& text) {
  * @return Расшифрованная строка
  * @throw cipher_error если текст пуст или содержит не заглавные буквы
  */
-std::wstring RouteCipher::decrypt(const std::wstring& text) {
+std::wstring RouteCipher::decrypt(const std::wstring& text) const {
+    stats().addCall(text.size());
+    StageTimer validate(stats(), CipherStage::validate);
     std::wstring clean_text = getValidCipherText(text);
-   
-    std::size_t text_length = clean_text.length();
-    std::size_t rows = (text_length + columns - 1) / columns;
-    std::wstring result(text_length, L' ');
-    std::size_t index = 0;
-
-    for (int col = columns - 1; col >= 0; col--) {
-        for (std::size_t row = 0; row < rows; row++) {
-            std::size_t pos = row * columns + col;
-            if (pos < text_length && index < text_length) {
-                result[pos] = clean_text[index++];
-            }
+    validate.stop();
+    std::wstring result = allocateResult<std::wstring>(clean_text.length());
+    StageTimer timer(stats(), CipherStage::transform);
+    routePermute<false>(plan(clean_text.length()), route_key, clean_text.data(), &result[0], clean_text.length());
+    return result;
+}
+
+/**
+ * @brief Шифрование текста в виде номеров букв
+ * @param text - открытый текст (любым алфавитом)
+ * @return Шифртекст в том же виде
+ * @throw cipher_error если текст пуст
+ */
+PackedText RouteCipher::encrypt(const PackedText& text) const {
+    stats().addCall(text.size());
+    if (text.empty())
+        throwIfFailed(rejected(cipher_status(cipher_errc::empty_open_text)));
+    PackedText result(allocateResult<std::vector<unsigned char>>(text.size()));
+    StageTimer timer(stats(), CipherStage::transform);
+    routePermute<true>(plan(text.size()), route_key, text.data(), result.data(), text.size());
+    return result;
+}
+
+/**
+ * @brief Дешифрование текста в виде номеров букв
+ * @param text - шифртекст (любым алфавитом)
+ * @return Открытый текст в том же виде
+ * @throw cipher_error если текст пуст
+ */
+PackedText RouteCipher::decrypt(const PackedText& text) const {
+    stats().addCall(text.size());
+    if (text.empty())
+        throwIfFailed(rejected(cipher_status(cipher_errc::empty_cipher_text)));
+    PackedText result(allocateResult<std::vector<unsigned char>>(text.size()));
+    StageTimer timer(stats(), CipherStage::transform);
+    routePermute<false>(plan(text.size()), route_key, text.data(), result.data(), text.size());
+    return result;
+}
+
+/**
+ * @brief Дешифрование отрезка открытого текста
+ * @param text - шифртекст
+ * @param begin - начало отрезка в открытом тексте
+ * @param end - конец отрезка (не включается)
+ * @return Символы decrypt(text) с позиций [begin, end)
+ * @throw cipher_error если текст пуст, отрезок выходит за его границы
+ * или прочитанные символы не являются заглавными буквами
+ * @details Позиция каждой буквы отрезка в шифртексте берётся из RouteMap::target()
+ */
+std::wstring RouteCipher::decrypt_range(const std::wstring& text, std::size_t begin, std::size_t end) const {
+    const std::size_t length = text.length();
+    stats().addCall(begin < end ? end - begin : 0);
+    if (length == 0)
+        throwIfFailed(rejected(cipher_status(cipher_errc::empty_cipher_text)));
+    if (begin > end || end > length)
+        throwIfFailed(rejected(cipher_status(cipher_errc::invalid_range)));
+
+    RouteMap map(route_key, length);
+    std::wstring result = allocateResult<std::wstring>(end - begin);
+    StageTimer timer(stats(), CipherStage::transform);
+    for (std::size_t i = 0; i < result.length(); i++) {
+        std::size_t pos = map.target(begin + i);
+        wchar_t c = text[pos];
+        if (!isUpperLetter(c))
+            throwIfFailed(rejected(cipher_status(cipher_errc::invalid_cipher_text, pos)));
+        result[i] = c;
+    }
+    return result;
+}
+
+/**
+ * @brief Шифрование текста на месте без исключений
+ * @param text - открытый текст, заменяемый шифртекстом
+ * @return Вид ошибки (пустой текст после очистки); при ошибке текст не изменяется
+ */
+cipher_status RouteCipher::try_encrypt_in_place(std::wstring& text) const {
+    stats().addCall(text.size());
+    StageTimer validate(stats(), CipherStage::validate);
+    cipher_status status = checkOpenText(text);
+    if (!status)
+        return rejected(status);
+    text.resize(foldLetters(text.data(), text.size(), &text[0]));
+    const std::size_t length = text.length();
+    validate.stop();
+    StageTimer timer(stats(), CipherStage::transform);
+    routeCycles<true>(&text[0], length, RouteMap(route_key, length));
+    return cipher_status();
+}
+
+/**
+ * @brief Шифрование текста на месте
+ * @param text - открытый текст, заменяемый шифртекстом
+ * @throw cipher_error если текст пуст после очистки
+ */
+void RouteCipher::encrypt_in_place(std::wstring& text) const {
+    throwIfFailed(try_encrypt_in_place(text));
+}
+
+/**
+ * @brief Дешифрование текста на месте без исключений
+ * @param text - шифртекст, заменяемый открытым текстом
+ * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой;
+ * при ошибке текст не изменяется
+ */
+cipher_status RouteCipher::try_decrypt_in_place(std::wstring& text) const {
+    stats().addCall(text.size());
+    StageTimer validate(stats(), CipherStage::validate);
+    cipher_status status = checkCipherText(text);
+    if (!status)
+        return rejected(status);
+    validate.stop();
+    StageTimer timer(stats(), CipherStage::transform);
+    routeCycles<false>(&text[0], text.length(), RouteMap(route_key, text.length()));
+    return cipher_status();
+}
+
+/**
+ * @brief Дешифрование текста на месте
+ * @param text - шифртекст, заменяемый открытым текстом
+ * @throw cipher_error если текст пуст или содержит не заглавные буквы
+ */
+void RouteCipher::decrypt_in_place(std::wstring& text) const {
+    throwIfFailed(try_decrypt_in_place(text));
+}
+
+/**
+ * @brief Декодирование, проверка и нормализация открытого текста в UTF-8
+ * @param s - исходный текст в UTF-8
+ * @param text - буквы текста в верхнем регистре
+ * @param bytes - длина очищенного текста в UTF-8
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status RouteCipher::decodeOpenText(std::string_view s, std::u16string& text, std::size_t& bytes) {
+    text.clear();
+    text.reserve(s.size());
+    bytes = 0;
+    for (std::size_t i = 0; i < s.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(s.data() + i, s.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        i += k;
+        if (isLetter(c)) {
+            c = toUpperLetter(c);
+            text.push_back(static_cast<char16_t>(c));
+            bytes += utf8Length(c);
         }
     }
+    if (text.empty())
+        return cipher_status(cipher_errc::empty_open_text);
+    return cipher_status();
+}
+
+/**
+ * @brief Декодирование и проверка шифртекста в UTF-8
+ * @param s - шифртекст в UTF-8
+ * @param text - буквы шифртекста
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status RouteCipher::decodeCipherText(std::string_view s, std::u16string& text) {
+    text.clear();
+    if (s.empty())
+        return cipher_status(cipher_errc::empty_cipher_text);
+
+    text.reserve(s.size());
+    for (std::size_t i = 0; i < s.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(s.data() + i, s.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        if (!isUpperLetter(c))
+            return cipher_status(cipher_errc::invalid_cipher_text, i);
+        i += k;
+        text.push_back(static_cast<char16_t>(c));
+    }
+    return cipher_status();
+}
+
+/**
+ * @brief Проверка открытого текста в UTF-8 без исключений
+ * @param text - открытый текст в UTF-8
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ * @details В отличие от decodeOpenText не строит очищенный текст
+ */
+cipher_status RouteCipher::checkOpenText(std::string_view text) {
+    bool letters = false;
+    for (std::size_t i = 0; i < text.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(text.data() + i, text.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        i += k;
+        if (isLetter(c))
+            letters = true;
+    }
+    if (!letters)
+        return cipher_status(cipher_errc::empty_open_text);
+    return cipher_status();
+}
+
+/**
+ * @brief Проверка шифртекста в UTF-8 без исключений
+ * @param text - шифртекст в UTF-8
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status RouteCipher::checkCipherText(std::string_view text) {
+    if (text.empty())
+        return cipher_status(cipher_errc::empty_cipher_text);
+
+    for (std::size_t i = 0; i < text.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(text.data() + i, text.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        if (!isUpperLetter(c))
+            return cipher_status(cipher_errc::invalid_cipher_text, i);
+        i += k;
+    }
+    return cipher_status();
+}
+
+/**
+ * @brief Шифрование текста в UTF-8
+ * @param text - открытый текст в UTF-8
+ * @return Зашифрованная строка в UTF-8
+ * @throw cipher_error если текст не в UTF-8 или пуст после очистки
+ */
+std::string RouteCipher::encrypt(std::string_view text) const {
+    std::string result = allocateResult<std::string>(text.size());
+    result.resize(encrypt_into(text.data(), text.size(), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Дешифрование текста в UTF-8
+ * @param text - шифртекст в UTF-8
+ * @return Расшифрованная строка в UTF-8
+ * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы
+ */
+std::string RouteCipher::decrypt(std::string_view text) const {
+    std::string result = allocateResult<std::string>(text.size());
+    result.resize(decrypt_into(text.data(), text.size(), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны
+ * @param in - открытый текст в UTF-8
+ * @param n - длина открытого текста в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @return Количество записанных байтов
+ * @throw cipher_error если буфер мал, текст не в UTF-8 или пуст после очистки
+ */
+std::size_t RouteCipher::encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const {
+    std::size_t written;
+    throwIfFailed(try_encrypt_into(in, n, out, out_size, written));
+    return written;
+}
+
+/**
+ * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+ * @param in - открытый текст в UTF-8
+ * @param n - длина открытого текста в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @param written - количество записанных байтов
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status RouteCipher::try_encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                            std::size_t& written) const {
+    written = 0;
+    stats().addCall(n);
+    StageTimer validate(stats(), CipherStage::validate);
+    std::size_t bytes;
+    std::u16string clean_text;
+    cipher_status status = decodeOpenText(std::string_view(in, n), clean_text, bytes);
+    if (!status)
+        return rejected(status);
+    if (out_size < bytes)
+        return rejected(cipher_status(cipher_errc::buffer_too_small));
+    validate.stop();
+
+    StageTimer timer(stats(), CipherStage::transform);
+    char* p = out;
+    RoutePlanCache::Plan route = plan(clean_text.length());
+    if (route) {
+        for (std::uint32_t i : *route)
+            p += utf8Encode(clean_text[i], p);
+    } else {
+        std::u16string cipher_text(clean_text.length(), u'\0');
+        routeTranspose<true>(route_key, clean_text.data(), &cipher_text[0], clean_text.length());
+        for (char16_t c : cipher_text)
+            p += utf8Encode(c, p);
+    }
+    written = bytes;
+    return cipher_status();
+}
+
+/**
+ * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны
+ * @param in - шифртекст в UTF-8
+ * @param n - длина шифртекста в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @return Количество записанных байтов
+ * @throw cipher_error если буфер мал, текст не в UTF-8, пуст или содержит не заглавные буквы
+ */
+std::size_t RouteCipher::decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const {
+    std::size_t written;
+    throwIfFailed(try_decrypt_into(in, n, out, out_size, written));
+    return written;
+}
+
+/**
+ * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+ * @param in - шифртекст в UTF-8
+ * @param n - длина шифртекста в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @param written - количество записанных байтов
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ * @details Буквы разносятся по плану (или блочным транспонированием) в буфер UTF-16,
+ * который затем последовательно кодируется в UTF-8
+ */
+cipher_status RouteCipher::try_decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                            std::size_t& written) const {
+    written = 0;
+    stats().addCall(n);
+    StageTimer validate(stats(), CipherStage::validate);
+    std::u16string clean_text;
+    cipher_status status = decodeCipherText(std::string_view(in, n), clean_text);
+    if (!status)
+        return rejected(status);
+    if (out_size < n)
+        return rejected(cipher_status(cipher_errc::buffer_too_small));
+    validate.stop();
+
+    StageTimer timer(stats(), CipherStage::transform);
+    std::u16string plain(clean_text.length(), u'\0');
+    routePermute<false>(plan(clean_text.length()), route_key, clean_text.data(), &plain[0], clean_text.length());
+    char* p = out;
+    for (char16_t c : plain)
+        p += utf8Encode(c, p);
+    written = p - out;
+    return cipher_status();
+}
+
+/**
+ * @brief Многопоточное шифрование текста
+ * @param text - открытый текст
+ * @param pool - пул потоков
+ * @param threshold - длина текста, ниже которой шифрование выполняется в вызывающем потоке
+ * @return Зашифрованная строка, совпадающая с encrypt(text)
+ * @throw cipher_error если текст пуст после очистки
+ * @details Буквы каждой части текста сначала считаются, затем по префиксным суммам
+ * записываются в общий очищенный текст, который транспонируется по столбцам
+ */
+std::wstring RouteCipher::encrypt(const std::wstring& text, ThreadPool& pool, std::size_t threshold) const {
+    const std::size_t n = text.size();
+    if (n < threshold || pool.size() < 2)
+        return encrypt(text);
+    stats().addCall(n);
+    StageTimer validate(stats(), CipherStage::validate);
+
+    std::vector<std::size_t> bounds = splitRange(n, pool.size() * 4, 1);
+    const std::size_t parts = bounds.size() - 1;
+    std::vector<std::size_t> offsets(parts + 1, 0);
+    pool.parallelFor(parts, [&](std::size_t i) {
+        offsets[i + 1] = letterCount(text.data() + bounds[i], bounds[i + 1] - bounds[i]);
+    });
+    for (std::size_t i = 0; i < parts; i++)
+        offsets[i + 1] += offsets[i];
+    if (offsets[parts] == 0)
+        throwIfFailed(rejected(cipher_status(cipher_errc::empty_open_text)));
+
+    std::wstring clean_text(offsets[parts], L'\0');
+    pool.parallelFor(parts, [&](std::size_t i) {
+        foldLetters(text.data() + bounds[i], bounds[i + 1] - bounds[i], &clean_text[offsets[i]]);
+    });
+    validate.stop();
+
+    std::wstring result = allocateResult<std::wstring>(clean_text.length());
+    StageTimer timer(stats(), CipherStage::transform);
+    routePermuteParallel<true>(pool, route_key.columnar() ? nullptr : plan(clean_text.length()), route_key,
+                               clean_text.data(), &result[0], clean_text.length());
     return result;
 }
+
+/**
+ * @brief Многопоточное дешифрование текста
+ * @param text - шифртекст
+ * @param pool - пул потоков
+ * @param threshold - длина текста, ниже которой дешифрование выполняется в вызывающем потоке
+ * @return Расшифрованная строка, совпадающая с decrypt(text)
+ * @throw cipher_error если текст пуст или содержит не заглавные буквы
+ */
+std::wstring RouteCipher::decrypt(const std::wstring& text, ThreadPool& pool, std::size_t threshold) const {
+    const std::size_t n = text.size();
+    if (n < threshold || pool.size() < 2)
+        return decrypt(text);
+    stats().addCall(n);
+    StageTimer validate(stats(), CipherStage::validate);
+
+    std::vector<std::size_t> bounds = splitRange(n, pool.size() * 4, 1);
+    std::vector<cipher_status> status(bounds.size() - 1);
+    pool.parallelFor(status.size(), [&](std::size_t i) {
+        std::size_t k = bounds[i] + upperLetterSpan(text.data() + bounds[i], bounds[i + 1] - bounds[i]);
+        if (k < bounds[i + 1])
+            status[i] = cipher_status(cipher_errc::invalid_cipher_text, k);
+    });
+    cipher_status failure = firstFailure(status);
+    if (!failure)
+        throwIfFailed(rejected(failure));
+    validate.stop();
+
+    std::wstring result = allocateResult<std::wstring>(n);
+    StageTimer timer(stats(), CipherStage::transform);
+    routePermuteParallel<false>(pool, route_key.columnar() ? nullptr : plan(n), route_key, text.data(), &result[0], n);
+    return result;
+}
+
+/**
+ * @brief Многопоточное шифрование текста в UTF-8 в буфер вызывающей стороны
+ * @param in - открытый текст в UTF-8
+ * @param n - длина открытого текста в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @param pool - пул потоков
+ * @param threshold - длина текста в байтах, ниже которой шифрование выполняется в вызывающем потоке
+ * @return Количество записанных байтов
+ * @throw cipher_error если буфер мал, текст не в UTF-8 или пуст после очистки
+ */
+std::size_t RouteCipher::encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                      ThreadPool& pool, std::size_t threshold) const {
+    std::size_t written;
+    throwIfFailed(try_encrypt_into(in, n, out, out_size, written, pool, threshold));
+    return written;
+}
+
+/**
+ * @brief Многопоточное шифрование текста в UTF-8 без исключений
+ * @param in - открытый текст в UTF-8
+ * @param n - длина открытого текста в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @param written - количество записанных байтов
+ * @param pool - пул потоков
+ * @param threshold - длина текста в байтах, ниже которой шифрование выполняется в вызывающем потоке
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ * @details Текст делится на части по границам символов. Каждая часть декодируется дважды:
+ * сначала для подсчёта букв, затем для записи их в общий очищенный текст со своего
+ * смещения. Транспонирование и кодирование результата тоже выполняются параллельно
+ */
+cipher_status RouteCipher::try_encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                            std::size_t& written, ThreadPool& pool,
+                                            std::size_t threshold) const {
+    if (n < threshold || pool.size() < 2)
+        return try_encrypt_into(in, n, out, out_size, written);
+    written = 0;
+    stats().addCall(n);
+    StageTimer validate(stats(), CipherStage::validate);
+
+    std::vector<std::size_t> bounds = splitUtf8(in, n, pool.size() * 4);
+    const std::size_t parts = bounds.size() - 1;
+    std::vector<std::size_t> offsets(parts + 1, 0);
+    std::vector<std::size_t> bytes(parts, 0);
+    std::vector<cipher_status> status(parts);
+    pool.parallelFor(parts, [&](std::size_t i) {
+        for (std::size_t k = bounds[i]; k < bounds[i + 1];) {
+            char32_t c;
+            std::size_t len = utf8Decode(in + k, bounds[i + 1] - k, c);
+            if (len == 0) {
+                status[i] = cipher_status(cipher_errc::invalid_utf8, k);
+                return;
+            }
+            k += len;
+            if (isLetter(c)) {
+                offsets[i + 1]++;
+                bytes[i] += utf8Length(toUpperLetter(c));
+            }
+        }
+    });
+    cipher_status failure = firstFailure(status);
+    if (!failure)
+        return rejected(failure);
+    std::size_t total_bytes = 0;
+    for (std::size_t i = 0; i < parts; i++) {
+        offsets[i + 1] += offsets[i];
+        total_bytes += bytes[i];
+    }
+    if (offsets[parts] == 0)
+        return rejected(cipher_status(cipher_errc::empty_open_text));
+    if (out_size < total_bytes)
+        return rejected(cipher_status(cipher_errc::buffer_too_small));
+
+    std::u16string clean_text(offsets[parts], u'\0');
+    pool.parallelFor(parts, [&](std::size_t i) {
+        char16_t* p = &clean_text[offsets[i]];
+        for (std::size_t k = bounds[i]; k < bounds[i + 1];) {
+            char32_t c = 0;
+            k += utf8Decode(in + k, bounds[i + 1] - k, c);
+            if (isLetter(c))
+                *p++ = static_cast<char16_t>(toUpperLetter(c));
+        }
+    });
+    validate.stop();
+
+    StageTimer timer(stats(), CipherStage::transform);
+    std::u16string cipher_text(clean_text.length(), u'\0');
+    routePermuteParallel<true>(pool, route_key.columnar() ? nullptr : plan(clean_text.length()), route_key,
+                               clean_text.data(), &cipher_text[0], clean_text.length());
+    written = encodeParallel(pool, cipher_text.data(), cipher_text.length(), out);
+    return cipher_status();
+}
+
+/**
+ * @brief Многопоточное дешифрование текста в UTF-8 в буфер вызывающей стороны
+ * @param in - шифртекст в UTF-8
+ * @param n - длина шифртекста в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @param pool - пул потоков
+ * @param threshold - длина текста в байтах, ниже которой дешифрование выполняется в вызывающем потоке
+ * @return Количество записанных байтов
+ * @throw cipher_error если буфер мал, текст не в UTF-8, пуст или содержит не заглавные буквы
+ */
+std::size_t RouteCipher::decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                      ThreadPool& pool, std::size_t threshold) const {
+    std::size_t written;
+    throwIfFailed(try_decrypt_into(in, n, out, out_size, written, pool, threshold));
+    return written;
+}
+
+/**
+ * @brief Многопоточное дешифрование текста в UTF-8 без исключений
+ * @param in - шифртекст в UTF-8
+ * @param n - длина шифртекста в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (достаточно n)
+ * @param written - количество записанных байтов
+ * @param pool - пул потоков
+ * @param threshold - длина текста в байтах, ниже которой дешифрование выполняется в вызывающем потоке
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status RouteCipher::try_decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                            std::size_t& written, ThreadPool& pool,
+                                            std::size_t threshold) const {
+    if (n < threshold || pool.size() < 2)
+        return try_decrypt_into(in, n, out, out_size, written);
+    written = 0;
+    stats().addCall(n);
+    StageTimer validate(stats(), CipherStage::validate);
+
+    std::vector<std::size_t> bounds = splitUtf8(in, n, pool.size() * 4);
+    const std::size_t parts = bounds.size() - 1;
+    std::vector<std::size_t> offsets(parts + 1, 0);
+    std::vector<cipher_status> status(parts);
+    pool.parallelFor(parts, [&](std::size_t i) {
+        for (std::size_t k = bounds[i]; k < bounds[i + 1];) {
+            char32_t c;
+            std::size_t len = utf8Decode(in + k, bounds[i + 1] - k, c);
+            if (len == 0) {
+                status[i] = cipher_status(cipher_errc::invalid_utf8, k);
+                return;
+            }
+            if (!isUpperLetter(c)) {
+                status[i] = cipher_status(cipher_errc::invalid_cipher_text, k);
+                return;
+            }
+            k += len;
+            offsets[i + 1]++;
+        }
+    });
+    cipher_status failure = firstFailure(status);
+    if (!failure)
+        return rejected(failure);
+    if (out_size < n)
+        return rejected(cipher_status(cipher_errc::buffer_too_small));
+    for (std::size_t i = 0; i < parts; i++)
+        offsets[i + 1] += offsets[i];
+
+    std::u16string clean_text(offsets[parts], u'\0');
+    pool.parallelFor(parts, [&](std::size_t i) {
+        char16_t* p = &clean_text[offsets[i]];
+        for (std::size_t k = bounds[i]; k < bounds[i + 1];) {
+            char32_t c = 0;
+            k += utf8Decode(in + k, bounds[i + 1] - k, c);
+            *p++ = static_cast<char16_t>(c);
+        }
+    });
+    validate.stop();
+
+    StageTimer timer(stats(), CipherStage::transform);
+    std::u16string plain(clean_text.length(), u'\0');
+    routePermuteParallel<false>(pool, route_key.columnar() ? nullptr : plan(clean_text.length()), route_key,
+                                clean_text.data(), &plain[0], clean_text.length());
+    written = encodeParallel(pool, plain.data(), plain.length(), out);
+    return cipher_status();
+}
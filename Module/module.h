@@ -1,7 +1,14 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <locale>
 #include <stdexcept>
+#include "cipher_error.h"
+#include "cipher_status.h"
+#include "cipher_stats.h"
+#include "packed_text.h"
+#include "route_key.h"
+#include "route_plan_cache.h"
 
 /**
  * @file module.h
@@ -12,44 +19,30 @@
  * @warning Реализация для работы с текстами в кодировке UTF-8 (wstring)
  */
 
-/**
- * @brief Класс исключения для ошибок шифрования
- * @details Наследуется от std::invalid_argument
- */
-class cipher_error : public std::invalid_argument {
-public:
-    /**
-     * @brief Конструктор исключения с передачей строки
-     * @param what_arg - сообщение об ошибке
-     */
-    explicit cipher_error(const std::string& what_arg):
-        std::invalid_argument(what_arg) {}
-    
-    /**
-     * @brief Конструктор исключения с передачей строки (C-стиль)
-     * @param what_arg - сообщение об ошибке
-     */
-    explicit cipher_error(const char* what_arg):
-        std::invalid_argument(what_arg) {}
-};
+class ThreadPool;
 
 /**
  * @brief Класс для шифрования методом маршрутной перестановки
  * @details Использует таблицу с заданным числом столбцов.
  * Запись: слева направо, сверху вниз.
- * Считывание: сверху вниз, справа налево.
+ * Считывание по умолчанию: сверху вниз, справа налево; ключ может задать другой
+ * маршрут — порядок столбцов, змейку или спираль (см. RouteKey).
+ * Методы шифрования и дешифрования константны и могут одновременно вызываться
+ * из нескольких потоков, пока ключ не меняется через setKey().
+ * Для текстов не длиннее plan_max_length перестановка выполняется по плану
+ * из LRU-кэша planCache(), поэтому повторяющиеся длины сообщений не пересчитывают маршрут.
  */
 class RouteCipher {
 private:
-    int columns; ///< Количество столбцов таблицы (ключ шифрования)
-    
+    RouteKey route_key; ///< Разобранный ключ: количество столбцов и маршрут считывания
+    mutable RoutePlanCache plans; ///< Планы перестановки для недавних длин текста
+
     /**
-     * @brief Проверка и нормализация ключа
-     * @param s - исходный ключ (строка с числом)
-     * @return Валидная строка ключа
-     * @throw cipher_error если ключ пустой, содержит не цифры, или число <= 0
+     * @brief План перестановки для текущего ключа и заданной длины
+     * @param length - длина текста
+     * @return План из кэша (построенный при промахе) или nullptr, если план не используется
      */
-    std::wstring getValidKey(const std::wstring& s);
+    RoutePlanCache::Plan plan(std::size_t length) const;
     
     /**
      * @brief Проверка и нормализация открытого текста
@@ -57,7 +50,7 @@ private:
      * @return Текст в верхнем регистре без не-букв
      * @throw cipher_error если после очистки текст пуст
      */
-    std::wstring getValidOpenText(const std::wstring& s);
+    std::wstring getValidOpenText(const std::wstring& s) const;
     
     /**
      * @brief Проверка шифртекста
@@ -65,22 +58,90 @@ private:
      * @return Текст без изменений
      * @throw cipher_error если текст пуст или содержит не заглавные буквы
      */
-    std::wstring getValidCipherText(const std::wstring& s);
+    std::wstring getValidCipherText(const std::wstring& s) const;
+
+    /**
+     * @brief Декодирование, проверка и нормализация открытого текста в UTF-8
+     * @param s - исходный текст в UTF-8
+     * @param text - буквы текста в верхнем регистре
+     * @param bytes - длина очищенного текста в UTF-8
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status decodeOpenText(std::string_view s, std::u16string& text, std::size_t& bytes);
+
+    /**
+     * @brief Декодирование и проверка шифртекста в UTF-8
+     * @param s - шифртекст в UTF-8
+     * @param text - буквы шифртекста
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status decodeCipherText(std::string_view s, std::u16string& text);
     
 public:
+    static const std::size_t plan_max_length = 1 << 18; ///< Наибольшая длина текста, для которой строится план
+    static const std::size_t parallel_threshold = 1 << 20; ///< Длина текста, начиная с которой выгодно многопоточное шифрование
+    static const std::size_t min_memory_budget = 1 << 18; ///< Наименьшее ограничение памяти для encrypt_file/decrypt_file
+
     RouteCipher() = delete; ///< Удалённый конструктор по умолчанию
+
+    /**
+     * @brief Счётчики шифра, общие для всех объектов класса
+     * @return Статистика вызовов
+     * @details Вызовом считается каждый публичный метод шифрования, кроме обёрток над
+     * try_* и многопоточных методов, передавших текст однопоточным. Этап validate —
+     * проход проверки и очистки текста, transform — перестановка (у decrypt_range
+     * вместе с проверкой прочитанных букв)
+     */
+    static CipherStats& stats();
     
     /**
      * @brief Конструктор с установкой ключа
-     * @param key - ключ шифрования (количество столбцов)
+     * @param key - ключ шифрования (количество столбцов или маршрут, см. RouteKey)
      * @throw cipher_error если ключ невалиден
      */
     RouteCipher(const std::wstring& key);
+
+    /**
+     * @brief Проверка ключа без исключений
+     * @param key - ключ шифрования (количество столбцов или маршрут, см. RouteKey)
+     * @return Вид ошибки и позиция первого недопустимого символа ключа
+     * @details Если проверка прошла, конструктор и setKey() с этим ключом не выбрасывают исключений
+     */
+    static cipher_status checkKey(const std::wstring& key);
+
+    /**
+     * @brief Проверка открытого текста без исключений
+     * @param text - открытый текст
+     * @return Вид ошибки (пустой текст после очистки)
+     */
+    static cipher_status checkOpenText(const std::wstring& text);
+
+    /**
+     * @brief Проверка открытого текста в UTF-8 без исключений
+     * @param text - открытый текст в UTF-8
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status checkOpenText(std::string_view text);
+
+    /**
+     * @brief Проверка шифртекста без исключений
+     * @param text - шифртекст
+     * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой
+     */
+    static cipher_status checkCipherText(const std::wstring& text);
+
+    /**
+     * @brief Проверка шифртекста в UTF-8 без исключений
+     * @param text - шифртекст в UTF-8
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status checkCipherText(std::string_view text);
     
     /**
      * @brief Установка нового ключа
      * @param key - новый ключ
      * @throw cipher_error если ключ невалиден
+     * @details Маршрут разбирается один раз здесь; кэш планов очищается
      */
     void setKey(const std::wstring& key);
     
@@ -89,6 +150,33 @@ public:
      * @return Строковое представление ключа
      */
     std::wstring getKey() const;
+
+    /**
+     * @brief Количество столбцов таблицы
+     * @return Число столбцов разобранного ключа (для order:3142 — длина перестановки)
+     */
+    int columns() const {
+        return route_key.columns;
+    }
+
+    /**
+     * @brief Кэш планов перестановки
+     * @return Кэш для чтения счётчиков попаданий и промахов и изменения ёмкости
+     * @details Кэш потокобезопасен, поэтому доступен и у константного шифра
+     */
+    RoutePlanCache& planCache() const {
+        return plans;
+    }
+
+    /**
+     * @brief Маршрут текущего ключа для текста заданной длины
+     * @param length - длина текста
+     * @return Перевод позиций открытого текста в позиции шифртекста и обратно
+     * @details Нужен для слияния шифра с другими этапами (см. CipherPipeline)
+     */
+    RouteMap routeMap(std::size_t length) const {
+        return RouteMap(route_key, length);
+    }
     
     /**
      * @brief Шифрование текста
@@ -96,7 +184,7 @@ public:
      * @return Зашифрованная строка
      * @throw cipher_error если текст пуст после очистки
      */
-    std::wstring encrypt(const std::wstring& text);
+    std::wstring encrypt(const std::wstring& text) const;
     
     /**
      * @brief Дешифрование текста
@@ -104,5 +192,246 @@ public:
      * @return Расшифрованная строка
      * @throw cipher_error если текст пуст или содержит не заглавные буквы
      */
-    std::wstring decrypt(const std::wstring& text);
+    std::wstring decrypt(const std::wstring& text) const;
+
+    /**
+     * @brief Шифрование текста в виде номеров букв
+     * @param text - открытый текст (любым алфавитом)
+     * @return Шифртекст в том же виде
+     * @throw cipher_error если текст пуст
+     * @details Переставляются байты номеров, а не четырёхбайтовые символы
+     */
+    PackedText encrypt(const PackedText& text) const;
+
+    /**
+     * @brief Дешифрование текста в виде номеров букв
+     * @param text - шифртекст (любым алфавитом)
+     * @return Открытый текст в том же виде
+     * @throw cipher_error если текст пуст
+     */
+    PackedText decrypt(const PackedText& text) const;
+
+    /**
+     * @brief Дешифрование отрезка открытого текста
+     * @param text - шифртекст
+     * @param begin - начало отрезка в открытом тексте
+     * @param end - конец отрезка (не включается)
+     * @return Символы decrypt(text) с позиций [begin, end)
+     * @throw cipher_error если текст пуст, отрезок выходит за его границы
+     * или прочитанные символы не являются заглавными буквами
+     * @details Позиция каждой буквы в шифртексте вычисляется по формуле,
+     * поэтому время и память пропорциональны длине отрезка, а не текста.
+     * Проверяются только прочитанные символы шифртекста
+     */
+    std::wstring decrypt_range(const std::wstring& text, std::size_t begin, std::size_t end) const;
+
+    /**
+     * @brief Шифрование текста на месте
+     * @param text - открытый текст, заменяемый шифртекстом
+     * @throw cipher_error если текст пуст после очистки
+     * @details Результат совпадает с encrypt(text), но строится в буфере text:
+     * буквы сдвигаются к началу, а перестановка выполняется обходом циклов
+     * без дополнительной памяти, пропорциональной длине текста
+     */
+    void encrypt_in_place(std::wstring& text) const;
+
+    /**
+     * @brief Дешифрование текста на месте
+     * @param text - шифртекст, заменяемый открытым текстом
+     * @throw cipher_error если текст пуст или содержит не заглавные буквы
+     * @details Результат совпадает с decrypt(text); дополнительная память не зависит от длины текста
+     */
+    void decrypt_in_place(std::wstring& text) const;
+
+    /**
+     * @brief Шифрование текста на месте без исключений
+     * @param text - открытый текст, заменяемый шифртекстом
+     * @return Вид ошибки; при ошибке текст не изменяется
+     */
+    cipher_status try_encrypt_in_place(std::wstring& text) const;
+
+    /**
+     * @brief Дешифрование текста на месте без исключений
+     * @param text - шифртекст, заменяемый открытым текстом
+     * @return Вид ошибки и позиция первого недопустимого символа; при ошибке текст не изменяется
+     */
+    cipher_status try_decrypt_in_place(std::wstring& text) const;
+
+    /**
+     * @brief Шифрование текста в UTF-8
+     * @param text - открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8 или пуст после очистки
+     * @details Буквы латиницы и кириллицы хранятся по 2 байта; текст декодируется
+     * за один проход и за один проход переставляется с кодированием обратно в UTF-8
+     */
+    std::string encrypt(std::string_view text) const;
+
+    /**
+     * @brief Дешифрование текста в UTF-8
+     * @param text - шифртекст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы
+     */
+    std::string decrypt(std::string_view text) const;
+
+    /**
+     * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны
+     * @param in - открытый текст в UTF-8
+     * @param n - длина открытого текста в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @return Количество записанных байтов
+     * @throw cipher_error если буфер мал, текст не в UTF-8 или пуст после очистки
+     */
+    std::size_t encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const;
+
+    /**
+     * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны
+     * @param in - шифртекст в UTF-8
+     * @param n - длина шифртекста в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @return Количество записанных байтов
+     * @throw cipher_error если буфер мал, текст не в UTF-8, пуст или содержит не заглавные буквы
+     */
+    std::size_t decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const;
+
+    /**
+     * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+     * @param in - открытый текст в UTF-8
+     * @param n - длина открытого текста в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+    /**
+     * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+     * @param in - шифртекст в UTF-8
+     * @param n - длина шифртекста в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+    /**
+     * @brief Многопоточное шифрование текста
+     * @param text - открытый текст
+     * @param pool - пул потоков
+     * @param threshold - длина текста, ниже которой шифрование выполняется в вызывающем потоке
+     * @return Зашифрованная строка, совпадающая с encrypt(text)
+     * @throw cipher_error если текст пуст после очистки
+     * @details Каждый столбец таблицы — непрерывный отрезок шифртекста с заранее известным
+     * началом, поэтому столбцы делятся между исполнителями и пишутся прямо в общий результат
+     */
+    std::wstring encrypt(const std::wstring& text, ThreadPool& pool,
+                         std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Многопоточное дешифрование текста
+     * @param text - шифртекст
+     * @param pool - пул потоков
+     * @param threshold - длина текста, ниже которой дешифрование выполняется в вызывающем потоке
+     * @return Расшифрованная строка, совпадающая с decrypt(text)
+     * @throw cipher_error если текст пуст или содержит не заглавные буквы
+     * @details Исполнители разбрасывают буквы по непересекающимся строкам общего результата
+     */
+    std::wstring decrypt(const std::wstring& text, ThreadPool& pool,
+                         std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Многопоточное шифрование текста в UTF-8 в буфер вызывающей стороны
+     * @param in - открытый текст в UTF-8
+     * @param n - длина открытого текста в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @param pool - пул потоков
+     * @param threshold - длина текста в байтах, ниже которой шифрование выполняется в вызывающем потоке
+     * @return Количество записанных байтов
+     * @throw cipher_error если буфер мал, текст не в UTF-8 или пуст после очистки
+     */
+    std::size_t encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                             ThreadPool& pool, std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Многопоточное шифрование текста в UTF-8 без исключений
+     * @param in - открытый текст в UTF-8
+     * @param n - длина открытого текста в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @param written - количество записанных байтов
+     * @param pool - пул потоков
+     * @param threshold - длина текста в байтах, ниже которой шифрование выполняется в вызывающем потоке
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written, ThreadPool& pool,
+                                   std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Многопоточное дешифрование текста в UTF-8 в буфер вызывающей стороны
+     * @param in - шифртекст в UTF-8
+     * @param n - длина шифртекста в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @param pool - пул потоков
+     * @param threshold - длина текста в байтах, ниже которой дешифрование выполняется в вызывающем потоке
+     * @return Количество записанных байтов
+     * @throw cipher_error если буфер мал, текст не в UTF-8, пуст или содержит не заглавные буквы
+     */
+    std::size_t decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                             ThreadPool& pool, std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Многопоточное дешифрование текста в UTF-8 без исключений
+     * @param in - шифртекст в UTF-8
+     * @param n - длина шифртекста в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (достаточно n)
+     * @param written - количество записанных байтов
+     * @param pool - пул потоков
+     * @param threshold - длина текста в байтах, ниже которой дешифрование выполняется в вызывающем потоке
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written, ThreadPool& pool,
+                                   std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Шифрование файла в UTF-8 с ограничением памяти
+     * @param input - путь к открытому тексту
+     * @param output - путь к шифртексту
+     * @param memory_budget - ограничение памяти в байтах
+     * @return Размер шифртекста в байтах
+     * @throw cipher_error если текст не в UTF-8 или пуст после очистки
+     * @throw std::invalid_argument если memory_budget меньше min_memory_budget
+     * @throw std::system_error при ошибке ввода-вывода или если output - тот же файл, что input
+     * @details Текст не загружается целиком: результат собирается за несколько проходов
+     * по входному файлу, по отрезку в пределах memory_budget за проход (см. route_external.cpp).
+     * Каждый проход перечитывает весь вход, поэтому объём чтения растёт как N²/memory_budget
+     */
+    std::size_t encrypt_file(const std::string& input, const std::string& output,
+                             std::size_t memory_budget) const;
+
+    /**
+     * @brief Дешифрование файла в UTF-8 с ограничением памяти
+     * @param input - путь к шифртексту
+     * @param output - путь к открытому тексту
+     * @param memory_budget - ограничение памяти в байтах
+     * @return Размер открытого текста в байтах
+     * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы
+     * @throw std::invalid_argument если memory_budget меньше min_memory_budget
+     * @throw std::system_error при ошибке ввода-вывода или если output - тот же файл, что input
+     * @details Завершающий перевод строки отбрасывается, как в файловом режиме.
+     * Объём чтения, как и в encrypt_file, растёт как N²/memory_budget
+     */
+    std::size_t decrypt_file(const std::string& input, const std::string& output,
+                             std::size_t memory_budget) const;
 };
@@ -0,0 +1,350 @@
+#include "module.h"
+#include "utf8.h"
+#include "letters.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file route_external.cpp
+ * @brief Маршрутная перестановка файлов, не помещающихся в память
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Перестановка выполняется в несколько проходов по входному файлу. Каждый проход
+ * собирает в буфер отрезок результата [first, last): позиция каждой буквы в результате
+ * вычисляется через RouteMap, и буква сохраняется, только если попадает в отрезок.
+ * Собранный отрезок дописывается в выходной файл, поэтому результат совпадает
+ * с результатом encrypt_into/decrypt_into байт в байт. Вход читается заново на каждом
+ * проходе: для текста из N букв при ограничении M байт проходов около 2N/M, и всего
+ * читается O(N²/M) байт, так что ограничение стоит выбирать как можно больше.
+ */
+
+static const std::size_t io_block = 1 << 16; ///< Размер блока чтения и записи
+
+/**
+ * @brief Исключение с текущим errno и именем файла
+ * @param path - путь к файлу
+ * @return Исключение для выброса
+ */
+static std::system_error fileError(const std::string& path) {
+    return std::system_error(errno, std::generic_category(), path);
+}
+
+/**
+ * @brief Последовательное чтение файла в UTF-8 по символам через буфер фиксированного размера
+ */
+class Utf8Reader {
+public:
+    /**
+     * @brief Открытие файла
+     * @param path - путь к файлу
+     * @throw std::system_error если файл не удалось открыть
+     */
+    explicit Utf8Reader(const std::string& path): path(path), buffer(io_block) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw fileError(path);
+        struct stat st;
+        if (::fstat(fd, &st) < 0) {
+            std::system_error e = fileError(path);
+            ::close(fd);
+            throw e;
+        }
+        length = st.st_size;
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    ~Utf8Reader() {
+        ::close(fd);
+    }
+
+    Utf8Reader(const Utf8Reader&) = delete; ///< Читатель не копируется
+    Utf8Reader& operator=(const Utf8Reader&) = delete; ///< Читатель не копируется
+
+    /**
+     * @brief Размер читаемой части файла
+     * @return Количество байтов
+     */
+    std::size_t size() const {
+        return length;
+    }
+
+    /**
+     * @brief Отбрасывание завершающего перевода строки (\n или \r\n)
+     * @throw std::system_error при ошибке чтения
+     */
+    void trimNewline() {
+        for (char end : {'\n', '\r'}) {
+            char last;
+            if (length == 0)
+                return;
+            if (::pread(fd, &last, 1, length - 1) != 1)
+                throw fileError(path);
+            if (last == end)
+                length--;
+        }
+    }
+
+    /**
+     * @brief Возврат к началу файла
+     */
+    void rewind() {
+        pos = 0;
+        end = 0;
+        offset = 0;
+        consumed = 0;
+    }
+
+    /**
+     * @brief Чтение очередного символа
+     * @param c - прочитанный символ
+     * @param at - позиция символа в байтах от начала файла
+     * @return 1 - символ прочитан, 0 - некорректный UTF-8, -1 - конец файла
+     * @throw std::system_error при ошибке чтения
+     */
+    int next(char32_t& c, std::size_t& at) {
+        if (end - pos < 4)
+            fill();
+        if (pos == end)
+            return -1;
+        at = offset;
+        std::size_t k = utf8Decode(&buffer[pos], end - pos, c);
+        if (k == 0)
+            return 0;
+        pos += k;
+        offset += k;
+        return 1;
+    }
+
+private:
+    std::string path; ///< Путь к файлу
+    int fd = -1; ///< Дескриптор файла
+    std::size_t length = 0; ///< Размер читаемой части файла
+    std::vector<char> buffer; ///< Буфер чтения
+    std::size_t pos = 0; ///< Позиция очередного символа в буфере
+    std::size_t end = 0; ///< Конец данных в буфере
+    std::size_t offset = 0; ///< Позиция очередного символа в файле
+    std::size_t consumed = 0; ///< Количество байтов файла, прочитанных в буфер
+
+    /**
+     * @brief Перенос остатка в начало буфера и дочитывание блока
+     * @throw std::system_error при ошибке чтения
+     */
+    void fill() {
+        std::copy(buffer.begin() + pos, buffer.begin() + end, buffer.begin());
+        end -= pos;
+        pos = 0;
+        while (end < buffer.size() && consumed < length) {
+            std::size_t want = std::min(buffer.size() - end, length - consumed);
+            ssize_t got = ::pread(fd, &buffer[end], want, consumed);
+            if (got < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw fileError(path);
+            }
+            if (got == 0)
+                break;
+            end += got;
+            consumed += got;
+        }
+    }
+};
+
+/**
+ * @brief Последовательная запись букв в файл в UTF-8
+ * @details Запись идёт через OutputFile: если commit() не был вызван (например, из-за
+ * исключения), удаляется только временный файл, а цель остаётся прежней
+ */
+class Utf8Writer {
+public:
+    /**
+     * @brief Создание файла
+     * @param path - путь к файлу
+     * @throw std::system_error если файл не удалось создать
+     */
+    explicit Utf8Writer(const std::string& path): file(path), buffer(io_block) {}
+
+    Utf8Writer(const Utf8Writer&) = delete; ///< Писатель не копируется
+    Utf8Writer& operator=(const Utf8Writer&) = delete; ///< Писатель не копируется
+
+    /**
+     * @brief Запись буквы
+     * @param c - буква
+     * @throw std::system_error при ошибке записи
+     */
+    void put(char16_t c) {
+        if (buffer.size() - used < 4)
+            flush();
+        used += utf8Encode(c, &buffer[used]);
+    }
+
+    /**
+     * @brief Сброс буфера и замена цели записанным файлом
+     * @return Размер файла в байтах
+     * @throw std::system_error при ошибке записи
+     */
+    std::size_t commit() {
+        flush();
+        file.commit();
+        return written;
+    }
+
+private:
+    OutputFile file; ///< Выходной файл
+    std::vector<char> buffer; ///< Буфер записи
+    std::size_t used = 0; ///< Заполненная часть буфера
+    std::size_t written = 0; ///< Количество записанных в файл байтов
+
+    /**
+     * @brief Запись буфера в файл
+     * @throw std::system_error при ошибке записи
+     */
+    void flush() {
+        file.write(buffer.data(), used);
+        written += used;
+        used = 0;
+    }
+};
+
+/**
+ * @brief Проход по буквам файла
+ * @param in - читатель, переводимый в начало файла
+ * @param cipher_text - true для шифртекста (допустимы только заглавные буквы)
+ * @param letter - обработчик каждой буквы (в верхнем регистре)
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ * @throw std::system_error при ошибке чтения
+ */
+template <typename F>
+static cipher_status scanLetters(Utf8Reader& in, bool cipher_text, F&& letter) {
+    in.rewind();
+    char32_t c;
+    std::size_t at = 0;
+    for (;;) {
+        int r = in.next(c, at);
+        if (r < 0)
+            return cipher_status();
+        if (r == 0)
+            return cipher_status(cipher_errc::invalid_utf8, at);
+        if (cipher_text) {
+            if (!isUpperLetter(c))
+                return cipher_status(cipher_errc::invalid_cipher_text, at);
+            letter(static_cast<char16_t>(c));
+        } else if (isLetter(c)) {
+            letter(static_cast<char16_t>(toUpperLetter(c)));
+        }
+    }
+}
+
+/**
+ * @brief Количество букв, собираемых за один проход
+ * @param memory_budget - ограничение памяти в байтах
+ * @return Размер буфера прохода в буквах
+ * @throw std::invalid_argument если ограничение меньше RouteCipher::min_memory_budget
+ * @details Из ограничения вычитаются буферы чтения и записи; буква занимает 2 байта
+ */
+static std::size_t passLetters(std::size_t memory_budget) {
+    static_assert(RouteCipher::min_memory_budget == 2 * io_block + io_block * sizeof(char16_t),
+                  "the minimum budget must hold both I/O buffers and one block of letters");
+    if (memory_budget < RouteCipher::min_memory_budget)
+        throw std::invalid_argument("memory budget is too small: at least 256K is required");
+    return (memory_budget - 2 * io_block) / sizeof(char16_t);
+}
+
+/**
+ * @brief Шифрование файла с ограничением памяти
+ * @param input - путь к открытому тексту в UTF-8
+ * @param output - путь к шифртексту
+ * @param memory_budget - ограничение памяти в байтах
+ * @return Размер шифртекста в байтах
+ * @throw cipher_error если текст не в UTF-8 или пуст после очистки
+ * @throw std::system_error при ошибке ввода-вывода
+ * @details Позиция каждой буквы в шифртексте берётся из RouteMap::target()
+ */
+std::size_t RouteCipher::encrypt_file(const std::string& input, const std::string& output,
+                                      std::size_t memory_budget) const {
+    const std::size_t letters = passLetters(memory_budget);
+    checkDistinctFiles(input, output);
+    Utf8Reader in(input);
+    stats().addCall(in.size());
+    StageTimer validate(stats(), CipherStage::validate);
+    std::size_t length = 0;
+    cipher_status status = scanLetters(in, false, [&](char16_t) { length++; });
+    if (status && length == 0)
+        status = cipher_status(cipher_errc::empty_open_text);
+    if (!status)
+        stats().addRejected();
+    throwIfFailed(status);
+    validate.stop();
+
+    std::u16string part(std::min(letters, length), u'\0');
+    Utf8Writer out(output);
+    const RouteMap map(route_key, length);
+    stats().addAllocated(part.size() * sizeof(char16_t));
+    StageTimer timer(stats(), CipherStage::transform);
+    for (std::size_t first = 0; first < length; first += part.size()) {
+        const std::size_t last = std::min(first + part.size(), length);
+        std::size_t i = 0;
+        scanLetters(in, false, [&](char16_t c) {
+            std::size_t pos = map.target(i++);
+            if (pos >= first && pos < last)
+                part[pos - first] = c;
+        });
+        for (std::size_t i = 0; i < last - first; i++)
+            out.put(part[i]);
+    }
+    return out.commit();
+}
+
+/**
+ * @brief Дешифрование файла с ограничением памяти
+ * @param input - путь к шифртексту в UTF-8
+ * @param output - путь к открытому тексту
+ * @param memory_budget - ограничение памяти в байтах
+ * @return Размер открытого текста в байтах
+ * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы
+ * @throw std::system_error при ошибке ввода-вывода
+ * @details Как и в файловом режиме, завершающий перевод строки не считается частью
+ * шифртекста. Номер каждой буквы в открытом тексте берётся из RouteMap::source()
+ */
+std::size_t RouteCipher::decrypt_file(const std::string& input, const std::string& output,
+                                      std::size_t memory_budget) const {
+    const std::size_t letters = passLetters(memory_budget);
+    checkDistinctFiles(input, output);
+    Utf8Reader in(input);
+    in.trimNewline();
+    stats().addCall(in.size());
+    StageTimer validate(stats(), CipherStage::validate);
+    std::size_t length = 0;
+    cipher_status status(cipher_errc::empty_cipher_text);
+    if (in.size() != 0)
+        status = scanLetters(in, true, [&](char16_t) { length++; });
+    if (!status)
+        stats().addRejected();
+    throwIfFailed(status);
+    validate.stop();
+
+    std::u16string part(std::min(letters, length), u'\0');
+    Utf8Writer out(output);
+    const RouteMap map(route_key, length);
+    stats().addAllocated(part.size() * sizeof(char16_t));
+    StageTimer timer(stats(), CipherStage::transform);
+    for (std::size_t first = 0; first < length; first += part.size()) {
+        const std::size_t last = std::min(first + part.size(), length);
+        std::size_t p = 0;
+        scanLetters(in, true, [&](char16_t c) {
+            std::size_t pos = map.source(p++);
+            if (pos >= first && pos < last)
+                part[pos - first] = c;
+        });
+        for (std::size_t i = 0; i < last - first; i++)
+            out.put(part[i]);
+    }
+    return out.commit();
+}
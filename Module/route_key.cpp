@@ -0,0 +1,316 @@
+#include "route_key.h"
+#include <algorithm>
+#include <climits>
+
+/**
+ * @file route_key.cpp
+ * @brief Реализация ключей маршрута перестановки
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Проверка, является ли символ десятичной цифрой
+ * @param c - символ ключа
+ * @return true для цифр 0..9 (без учёта локали)
+ */
+static bool isDigit(wchar_t c) {
+    return c >= L'0' && c <= L'9';
+}
+
+/**
+ * @brief Разбор положительного числа
+ * @param s - ключ
+ * @param begin - начало числа в ключе
+ * @param end - конец числа
+ * @param value - разобранное число
+ * @return Вид ошибки и позиция первого недопустимого символа ключа
+ */
+static cipher_status parseNumber(const std::wstring& s, std::size_t begin, std::size_t end, int& value) {
+    if (begin == end)
+        return cipher_status(cipher_errc::empty_key, begin);
+
+    value = 0;
+    for (std::size_t i = begin; i < end; i++) {
+        if (!isDigit(s[i]))
+            return cipher_status(cipher_errc::invalid_key, i);
+        int digit = s[i] - L'0';
+        if (value > (INT_MAX - digit) / 10)
+            return cipher_status(cipher_errc::key_too_large, i);
+        value = value * 10 + digit;
+    }
+
+    if (value <= 0)
+        return cipher_status(cipher_errc::key_not_positive, begin);
+    return cipher_status();
+}
+
+/**
+ * @brief Разбор порядка считывания столбцов
+ * @param s - ключ
+ * @param begin - начало порядка в ключе
+ * @param rank - номер очереди каждого столбца, начиная с 0
+ * @return Вид ошибки и позиция первого недопустимого символа ключа
+ * @details Порядок записывается цифрами ("3142") или числами через запятую ("3,1,4,2")
+ * и должен быть перестановкой чисел 1..N, где N — количество столбцов
+ */
+static cipher_status parseOrder(const std::wstring& s, std::size_t begin, std::vector<std::uint32_t>& rank) {
+    std::vector<std::size_t> at;
+    rank.clear();
+    if (s.find(L',', begin) == std::wstring::npos) {
+        for (std::size_t i = begin; i < s.size(); i++) {
+            if (!isDigit(s[i]))
+                return cipher_status(cipher_errc::invalid_key, i);
+            rank.push_back(s[i] - L'0');
+            at.push_back(i);
+        }
+    } else {
+        for (std::size_t i = begin; i <= s.size();) {
+            std::size_t end = std::min(s.find(L',', i), s.size());
+            int value;
+            cipher_status status = parseNumber(s, i, end, value);
+            if (!status)
+                return status.error == cipher_errc::key_not_positive ? cipher_status(cipher_errc::invalid_route, i)
+                                                                      : status;
+            rank.push_back(value);
+            at.push_back(i);
+            i = end + 1;
+        }
+    }
+    if (rank.empty())
+        return cipher_status(cipher_errc::empty_key, begin);
+    if (rank.size() > INT_MAX)
+        return cipher_status(cipher_errc::key_too_large, begin);
+
+    std::vector<bool> seen(rank.size(), false);
+    for (std::size_t col = 0; col < rank.size(); col++) {
+        if (rank[col] == 0 || rank[col] > rank.size() || seen[rank[col] - 1])
+            return cipher_status(cipher_errc::invalid_route, at[col]);
+        seen[rank[col] - 1] = true;
+        rank[col]--;
+    }
+    return cipher_status();
+}
+
+/**
+ * @brief Разбор ключа
+ * @param s - ключ
+ * @param key - разобранный ключ (изменяется только при успехе)
+ * @return Вид ошибки и позиция первого недопустимого символа ключа
+ */
+cipher_status RouteKey::compile(const std::wstring& s, RouteKey& key) {
+    if (s.empty())
+        return cipher_status(cipher_errc::empty_key);
+
+    RouteKey parsed;
+    std::size_t colon = s.find(L':');
+    if (colon == std::wstring::npos) {
+        cipher_status status = parseNumber(s, 0, s.size(), parsed.columns);
+        if (!status)
+            return status.error == cipher_errc::key_not_positive ? cipher_status(status.error) : status;
+        key = std::move(parsed);
+        return cipher_status();
+    }
+
+    std::wstring name = s.substr(0, colon);
+    cipher_status status;
+    if (name == L"order") {
+        parsed.kind = Kind::order;
+        status = parseOrder(s, colon + 1, parsed.rank);
+        parsed.columns = static_cast<int>(parsed.rank.size());
+    } else if (name == L"snake" || name == L"spiral") {
+        parsed.kind = name == L"snake" ? Kind::snake : Kind::spiral;
+        status = parseNumber(s, colon + 1, s.size(), parsed.columns);
+    } else {
+        return cipher_status(cipher_errc::invalid_route, 0);
+    }
+    if (!status)
+        return status;
+    key = std::move(parsed);
+    return cipher_status();
+}
+
+/**
+ * @brief Запись ключа
+ * @return Ключ в том виде, в котором его принимает compile()
+ */
+std::wstring RouteKey::text() const {
+    switch (kind) {
+    case Kind::order: {
+        std::wstring result = L"order:";
+        bool digits = rank.size() <= 9;
+        for (std::size_t col = 0; col < rank.size(); col++) {
+            if (!digits && col > 0)
+                result += L',';
+            result += std::to_wstring(rank[col] + 1);
+        }
+        return result;
+    }
+    case Kind::snake:
+        return L"snake:" + std::to_wstring(columns);
+    case Kind::spiral:
+        return L"spiral:" + std::to_wstring(columns);
+    default:
+        return std::to_wstring(columns);
+    }
+}
+
+/**
+ * @brief Подготовка маршрута
+ * @param key - ключ
+ * @param length - длина текста
+ * @details Для Kind::order начала столбцов считаются здесь накопленной суммой высот
+ * в порядке очереди; остальные маршруты не хранят ничего, кроме размеров таблицы
+ */
+RouteMap::RouteMap(const RouteKey& key, std::size_t length):
+    kind(key.kind), columns(key.columns), length(length),
+    rows((length + key.columns - 1) / key.columns),
+    body_rows(length / key.columns), tail(length % key.columns) {
+    if (kind != RouteKey::Kind::order)
+        return;
+    column_of.resize(columns);
+    for (std::size_t col = 0; col < columns; col++)
+        column_of[key.rank[col]] = col;
+    start.resize(columns);
+    rank_start.resize(columns);
+    std::size_t pos = 0;
+    for (std::size_t r = 0; r < columns; r++) {
+        rank_start[r] = pos;
+        start[column_of[r]] = pos;
+        pos += height(column_of[r]);
+    }
+}
+
+/**
+ * @brief Позиция буквы открытого текста в шифртексте
+ * @param i - номер буквы открытого текста
+ * @return Позиция в шифртексте
+ */
+std::size_t RouteMap::target(std::size_t i) const {
+    const std::size_t row = i / columns;
+    const std::size_t col = i % columns;
+    switch (kind) {
+    case RouteKey::Kind::order:
+        return start[col] + row;
+    case RouteKey::Kind::snake:
+        return rightToLeftStart(col) + ((columns - 1 - col) % 2 == 0 ? row : height(col) - 1 - row);
+    case RouteKey::Kind::spiral: {
+        std::size_t index = spiralIndex(row, col);
+        // Пустые клетки последней строки идут в спирали подряд, начиная с угла (rows - 1, columns - 1)
+        if (tail > 0 && rows > 1 && index >= columns + rows - 2)
+            index -= columns - tail;
+        return index;
+    }
+    default:
+        return rightToLeftStart(col) + row;
+    }
+}
+
+/**
+ * @brief Номер буквы открытого текста на позиции шифртекста
+ * @param p - позиция в шифртексте
+ * @return Номер буквы открытого текста
+ */
+std::size_t RouteMap::source(std::size_t p) const {
+    std::size_t col, offset;
+    switch (kind) {
+    case RouteKey::Kind::order: {
+        std::size_t r = std::upper_bound(rank_start.begin(), rank_start.end(), p) - rank_start.begin() - 1;
+        col = column_of[r];
+        return (p - rank_start[r]) * columns + col;
+    }
+    case RouteKey::Kind::snake:
+        rightToLeftCell(p, col, offset);
+        if ((columns - 1 - col) % 2 != 0)
+            offset = height(col) - 1 - offset;
+        return offset * columns + col;
+    case RouteKey::Kind::spiral: {
+        if (tail > 0 && rows > 1 && p >= columns + rows - 2)
+            p += columns - tail;
+        // Слой k начинается с номера 2k(rows + columns - 2k)
+        std::size_t lo = 0, hi = (std::min(rows, columns) - 1) / 2;
+        while (lo < hi) {
+            std::size_t k = (lo + hi + 1) / 2;
+            if (2 * k * (rows + columns - 2 * k) <= p)
+                lo = k;
+            else
+                hi = k - 1;
+        }
+        const std::size_t k = lo;
+        const std::size_t h = rows - 2 * k, w = columns - 2 * k;
+        const std::size_t off = p - 2 * k * (rows + columns - 2 * k);
+        std::size_t r, c;
+        if (off < w) {
+            r = 0;
+            c = off;
+        } else if (off < w + h - 1) {
+            r = off - (w - 1);
+            c = w - 1;
+        } else if (off < 2 * w + h - 2) {
+            r = h - 1;
+            c = (w - 1) - (off - (w + h - 2));
+        } else {
+            r = (h - 1) - (off - (2 * (w - 1) + (h - 1)));
+            c = 0;
+        }
+        return (k + r) * columns + (k + c);
+    }
+    default:
+        rightToLeftCell(p, col, offset);
+        return offset * columns + col;
+    }
+}
+
+/**
+ * @brief Начала отрезков непустых столбцов в шифртексте
+ * @return Начало отрезка каждого непустого столбца
+ */
+std::vector<std::size_t> RouteMap::columnStarts() const {
+    std::vector<std::size_t> result(std::min(columns, length));
+    for (std::size_t col = 0; col < result.size(); col++)
+        result[col] = kind == RouteKey::Kind::order ? start[col] : rightToLeftStart(col);
+    return result;
+}
+
+/**
+ * @brief Клетка таблицы по позиции при считывании столбцов справа налево
+ * @param p - позиция в шифртексте
+ * @param col - столбец
+ * @param offset - смещение от начала отрезка столбца
+ * @details Сначала идут columns - tail столбцов высотой body_rows, затем tail столбцов
+ * на одну букву выше
+ */
+void RouteMap::rightToLeftCell(std::size_t p, std::size_t& col, std::size_t& offset) const {
+    const std::size_t short_part = (columns - tail) * body_rows;
+    if (p < short_part) {
+        col = columns - 1 - p / body_rows;
+        offset = p % body_rows;
+    } else {
+        col = tail - 1 - (p - short_part) / (body_rows + 1);
+        offset = (p - short_part) % (body_rows + 1);
+    }
+}
+
+/**
+ * @brief Номер клетки при обходе по спирали без учёта пустых клеток
+ * @param row - строка
+ * @param col - столбец
+ * @return Номер клетки в спирали таблицы rows x columns
+ * @details Клетка лежит в слое k — на расстоянии k от ближайшего края. Слои до k
+ * занимают 2k(rows + columns - 2k) номеров; внутри слоя номер зависит от стороны:
+ * верхняя, правая, нижняя, левая
+ */
+std::size_t RouteMap::spiralIndex(std::size_t row, std::size_t col) const {
+    const std::size_t k = std::min(std::min(row, col), std::min(rows - 1 - row, columns - 1 - col));
+    const std::size_t h = rows - 2 * k, w = columns - 2 * k;
+    const std::size_t base = 2 * k * (rows + columns - 2 * k);
+    const std::size_t r = row - k, c = col - k;
+    if (r == 0)
+        return base + c;
+    if (c == w - 1)
+        return base + (w - 1) + r;
+    if (r == h - 1)
+        return base + (w - 1) + (h - 1) + (w - 1 - c);
+    return base + 2 * (w - 1) + (h - 1) + (h - 1 - r);
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cipher_status.h"
+
+/**
+ * @file route_key.h
+ * @brief Заголовочный файл ключей маршрута перестановки
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Разобранный ключ маршрутной перестановки
+ * @details Текст всегда записывается в таблицу по строкам слева направо. Ключ задаёт
+ * число столбцов и маршрут считывания:
+ * - "N" — столбцы справа налево, каждый сверху вниз (исходный маршрут);
+ * - "order:3142" или "order:3,1,4,2" — столбцы в порядке номеров над ними, каждый сверху вниз;
+ * - "snake:N" — столбцы справа налево, попеременно сверху вниз и снизу вверх;
+ * - "spiral:N" — по спирали по часовой стрелке от левого верхнего угла.
+ *
+ * Пустые клетки неполной последней строки пропускаются. Ключ разбирается один раз
+ * в RouteCipher::setKey(), дальше маршрут применяется через RouteMap
+ */
+struct RouteKey {
+    /**
+     * @brief Вид маршрута считывания
+     */
+    enum class Kind {
+        columns, ///< Столбцы справа налево сверху вниз
+        order,   ///< Столбцы в заданном порядке сверху вниз
+        snake,   ///< Столбцы справа налево змейкой
+        spiral   ///< Спираль по часовой стрелке
+    };
+
+    Kind kind = Kind::columns; ///< Вид маршрута
+    int columns = 1; ///< Количество столбцов таблицы
+    std::vector<std::uint32_t> rank; ///< Номер очереди считывания каждого столбца (только для Kind::order)
+
+    /**
+     * @brief Разбор ключа
+     * @param s - ключ
+     * @param key - разобранный ключ (изменяется только при успехе)
+     * @return Вид ошибки и позиция первого недопустимого символа ключа
+     */
+    static cipher_status compile(const std::wstring& s, RouteKey& key);
+
+    /**
+     * @brief Проверка, что маршрут считывает столбцы целиком сверху вниз
+     * @return true для Kind::columns и Kind::order
+     * @details Такие маршруты выполняются блочным транспонированием по началам столбцов
+     */
+    bool columnar() const {
+        return kind == Kind::columns || kind == Kind::order;
+    }
+
+    /**
+     * @brief Запись ключа
+     * @return Ключ в том виде, в котором его принимает compile()
+     */
+    std::wstring text() const;
+};
+
+/**
+ * @brief Маршрут для текста заданной длины
+ * @details Переводит номера букв открытого текста в позиции шифртекста и обратно
+ * за O(1) (для Kind::order — за O(log columns)), не строя таблицу размером с текст.
+ * Вид маршрута выбирается ветвлением внутри target() и source(), которое при обходе
+ * текста всегда идёт одинаково; горячие пути шифрования используют columnStarts()
+ * или план, построенный один раз на длину
+ */
+class RouteMap {
+public:
+    /**
+     * @brief Подготовка маршрута
+     * @param key - ключ
+     * @param length - длина текста
+     */
+    RouteMap(const RouteKey& key, std::size_t length);
+
+    /**
+     * @brief Позиция буквы открытого текста в шифртексте
+     * @param i - номер буквы открытого текста
+     * @return Позиция в шифртексте
+     */
+    std::size_t target(std::size_t i) const;
+
+    /**
+     * @brief Номер буквы открытого текста на позиции шифртекста
+     * @param p - позиция в шифртексте
+     * @return Номер буквы открытого текста
+     */
+    std::size_t source(std::size_t p) const;
+
+    /**
+     * @brief Начала отрезков непустых столбцов в шифртексте
+     * @return Начало отрезка каждого непустого столбца
+     * @details Только для маршрутов, у которых RouteKey::columnar()
+     */
+    std::vector<std::size_t> columnStarts() const;
+
+private:
+    RouteKey::Kind kind; ///< Вид маршрута
+    std::size_t columns; ///< Количество столбцов таблицы
+    std::size_t length; ///< Длина текста
+    std::size_t rows; ///< Количество строк, включая неполную последнюю
+    std::size_t body_rows; ///< Количество полных строк
+    std::size_t tail; ///< Количество букв в неполной последней строке
+    std::vector<std::size_t> start; ///< Начало отрезка каждого столбца (Kind::order)
+    std::vector<std::size_t> column_of; ///< Столбец по номеру очереди (Kind::order)
+    std::vector<std::size_t> rank_start; ///< Начало отрезка столбца по номеру очереди (Kind::order)
+
+    /**
+     * @brief Высота столбца
+     * @param col - номер столбца
+     * @return Количество букв в столбце
+     */
+    std::size_t height(std::size_t col) const {
+        return body_rows + (col < tail ? 1 : 0);
+    }
+
+    /**
+     * @brief Начало отрезка столбца при считывании справа налево
+     * @param col - номер столбца
+     * @return Позиция первой буквы столбца в шифртексте
+     */
+    std::size_t rightToLeftStart(std::size_t col) const {
+        return (columns - 1 - col) * body_rows + (tail > col + 1 ? tail - (col + 1) : 0);
+    }
+
+    /**
+     * @brief Клетка таблицы по позиции при считывании столбцов справа налево
+     * @param p - позиция в шифртексте
+     * @param col - столбец
+     * @param offset - смещение от начала отрезка столбца
+     */
+    void rightToLeftCell(std::size_t p, std::size_t& col, std::size_t& offset) const;
+
+    /**
+     * @brief Номер клетки при обходе по спирали без учёта пустых клеток
+     * @param row - строка
+     * @param col - столбец
+     * @return Номер клетки в спирали таблицы rows x columns
+     */
+    std::size_t spiralIndex(std::size_t row, std::size_t col) const;
+};
@@ -0,0 +1,108 @@
+#include "route_plan_cache.h"
+
+/**
+ * @file route_plan_cache.cpp
+ * @brief Реализация LRU-кэша планов маршрутной перестановки
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+const std::size_t RoutePlanCache::default_capacity;
+
+/**
+ * @brief Создание пустого кэша
+ * @param capacity - наибольшее количество планов (0 отключает кэш)
+ */
+RoutePlanCache::RoutePlanCache(std::size_t capacity):
+    cache(capacity) {
+}
+
+/**
+ * @brief Создание пустого кэша с ёмкостью другого
+ * @param other - образец
+ */
+RoutePlanCache::RoutePlanCache(const RoutePlanCache& other):
+    cache(other.capacity()) {
+}
+
+/**
+ * @brief Очистка кэша и перенос ёмкости другого
+ * @param other - образец
+ * @return Ссылка на этот кэш
+ */
+RoutePlanCache& RoutePlanCache::operator=(const RoutePlanCache& other) {
+    if (this != &other) {
+        cache.clear();
+        cache.setCapacity(other.capacity());
+    }
+    return *this;
+}
+
+/**
+ * @brief Поиск плана с учётом счётчиков попаданий и промахов
+ * @param columns - количество столбцов
+ * @param length - длина текста
+ * @return План или nullptr при промахе
+ */
+RoutePlanCache::Plan RoutePlanCache::find(int columns, std::size_t length) {
+    return cache.find(Key(columns, length));
+}
+
+/**
+ * @brief Добавление плана; при переполнении вытесняется давно не используемый
+ * @param columns - количество столбцов
+ * @param length - длина текста
+ * @param table - таблица перестановки
+ * @return Добавленный план (или уже имеющийся, если его успел добавить другой поток)
+ */
+RoutePlanCache::Plan RoutePlanCache::insert(int columns, std::size_t length, Table table) {
+    return cache.insert(Key(columns, length), std::make_shared<const Table>(std::move(table)));
+}
+
+/**
+ * @brief Изменение ёмкости с вытеснением лишних планов
+ * @param capacity - наибольшее количество планов (0 отключает кэш)
+ */
+void RoutePlanCache::setCapacity(std::size_t capacity) {
+    cache.setCapacity(capacity);
+}
+
+/**
+ * @brief Удаление всех планов и обнуление счётчиков
+ */
+void RoutePlanCache::clear() {
+    cache.clear();
+}
+
+/**
+ * @brief Ёмкость кэша
+ * @return Наибольшее количество планов
+ */
+std::size_t RoutePlanCache::capacity() const {
+    return cache.capacity();
+}
+
+/**
+ * @brief Количество планов в кэше
+ * @return Число планов
+ */
+std::size_t RoutePlanCache::size() const {
+    return cache.size();
+}
+
+/**
+ * @brief Количество попаданий
+ * @return Число вызовов find(), нашедших план
+ */
+unsigned long long RoutePlanCache::hits() const {
+    return cache.hits();
+}
+
+/**
+ * @brief Количество промахов
+ * @return Число вызовов find(), не нашедших план
+ */
+unsigned long long RoutePlanCache::misses() const {
+    return cache.misses();
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lru_cache.h"
+
+/**
+ * @file route_plan_cache.h
+ * @brief Заголовочный файл LRU-кэша планов маршрутной перестановки
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Ограниченный LRU-кэш планов перестановки, ключ — (число столбцов, длина текста)
+ * @details План — таблица номеров букв открытого текста для каждой позиции шифртекста.
+ * Шифрование по плану сводится к выборке (gather), дешифрование — к разбросу (scatter).
+ * Кэш построен на LruCache: методы потокобезопасны, план отдаётся через shared_ptr
+ * и остаётся действительным после вытеснения из кэша. При копировании копируется только ёмкость: кэш и счётчики
+ * нового объекта пусты.
+ */
+class RoutePlanCache {
+public:
+    typedef std::vector<std::uint32_t> Table; ///< Номер буквы открытого текста для каждой позиции шифртекста
+    typedef std::shared_ptr<const Table> Plan; ///< Общий неизменяемый план
+
+    static const std::size_t default_capacity = 16; ///< Ёмкость кэша по умолчанию
+
+    /**
+     * @brief Создание пустого кэша
+     * @param capacity - наибольшее количество планов (0 отключает кэш)
+     */
+    explicit RoutePlanCache(std::size_t capacity = default_capacity);
+
+    /**
+     * @brief Создание пустого кэша с ёмкостью другого
+     * @param other - образец
+     */
+    RoutePlanCache(const RoutePlanCache& other);
+
+    /**
+     * @brief Очистка кэша и перенос ёмкости другого
+     * @param other - образец
+     * @return Ссылка на этот кэш
+     */
+    RoutePlanCache& operator=(const RoutePlanCache& other);
+
+    /**
+     * @brief Поиск плана с учётом счётчиков попаданий и промахов
+     * @param columns - количество столбцов
+     * @param length - длина текста
+     * @return План или nullptr при промахе
+     */
+    Plan find(int columns, std::size_t length);
+
+    /**
+     * @brief Добавление плана; при переполнении вытесняется давно не используемый
+     * @param columns - количество столбцов
+     * @param length - длина текста
+     * @param table - таблица перестановки
+     * @return Добавленный план (или уже имеющийся, если его успел добавить другой поток)
+     */
+    Plan insert(int columns, std::size_t length, Table table);
+
+    /**
+     * @brief Изменение ёмкости с вытеснением лишних планов
+     * @param capacity - наибольшее количество планов (0 отключает кэш)
+     */
+    void setCapacity(std::size_t capacity);
+
+    /**
+     * @brief Удаление всех планов и обнуление счётчиков
+     */
+    void clear();
+
+    /**
+     * @brief Ёмкость кэша
+     * @return Наибольшее количество планов
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Количество планов в кэше
+     * @return Число планов
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Количество попаданий
+     * @return Число вызовов find(), нашедших план
+     */
+    unsigned long long hits() const;
+
+    /**
+     * @brief Количество промахов
+     * @return Число вызовов find(), не нашедших план
+     */
+    unsigned long long misses() const;
+
+private:
+    typedef std::pair<int, std::size_t> Key; ///< (число столбцов, длина текста)
+
+    LruCache<Key, Plan> cache; ///< Планы по ключу
+};
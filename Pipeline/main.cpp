@@ -0,0 +1,160 @@
+#include <cstring>
+#include <iostream>
+#include <locale>
+#include <string>
+#include "pipeline.h"
+
+/**
+ * @file main.cpp (CipherPipeline)
+ * @brief Главный модуль программы для составного шифра: замена Гронсфельда и маршрутная перестановка
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Сравнение цепочки с последовательным применением шифров
+ * @param substitution - шифр Гронсфельда
+ * @param route - шифр маршрутной перестановки
+ * @param pipeline - цепочка substitution, затем route
+ * @param log - поток для шифртекстов и итога (nullptr - без вывода)
+ * @return true если для всех текстов результаты совпали
+ * @details Шифрует тексты разной длины цепочкой и по очереди обоими шифрами,
+ * сравнивает шифртексты и проверяет, что дешифрование цепочкой возвращает очищенный текст
+ */
+bool checkPipeline(const modAlphaCipher& substitution, const RouteCipher& route, const CipherPipeline& pipeline,
+                   std::wostream* log)
+{
+    const std::wstring texts[] = {
+        L"ПРИВЕТ",
+        L"Маршрутная перестановка",
+        L"Съешь же ещё этих мягких французских булок, да выпей чаю",
+        L"В чащах юга жил бы цитрус? Да, но фальшивый экземпляр!"
+    };
+    bool ok = true;
+    for (const auto& text : texts) {
+        try {
+            std::wstring sequential = route.encrypt(substitution.encrypt(text));
+            std::wstring fused = pipeline.encrypt(text);
+            std::wstring back = pipeline.decrypt(fused);
+            bool same = fused == sequential && back == substitution.decrypt(route.decrypt(sequential));
+            if (log)
+                *log << fused << L" " << (same ? L"Ok" : L"Err") << std::endl;
+            if (!same)
+                ok = false;
+        } catch (const cipher_error& e) {
+            if (log)
+                *log << L"Error: " << e.what() << std::endl;
+            ok = false;
+        }
+    }
+    if (log)
+        *log << (ok ? L"Ok\n" : L"Err\n") << std::endl;
+    return ok;
+}
+
+/**
+ * @brief Неинтерактивная проверка цепочки
+ * @return 0 если все проверки прошли, 1 при ошибке
+ * @details Запускается с --self-test из цели make test, без ввода и без локали:
+ * для каждого вида ключа перестановки сравнивает цепочку (слитый проход)
+ * с последовательным применением шифров
+ */
+int selfTest()
+{
+    const char* route_keys[] = { "5", "order:3142", "snake:4", "spiral:5" };
+    bool ok = true;
+    try {
+        modAlphaCipher substitution(L"КЛЮЧ");
+        for (const char* key : route_keys) {
+            RouteCipher route(std::wstring(key, key + std::strlen(key)));
+            CipherPipeline pipeline;
+            pipeline.then(substitution).then(route);
+            bool passed = checkPipeline(substitution, route, pipeline, nullptr);
+            std::cout << "pipeline " << key << ": " << (passed ? "Ok" : "Err") << std::endl;
+            ok &= passed;
+        }
+    } catch (const cipher_error& e) {
+        std::cout << "pipeline: " << e.what() << std::endl;
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Главная функция программы
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
+ * @return 0 при успешном завершении, 1 при ошибке
+ * @details С --self-test проверяет цепочку (см. selfTest). Без аргументов принимает
+ * ключи обоих шифров, собирает цепочку «замена, затем перестановка»
+ * и предоставляет интерактивное меню
+ */
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--self-test")
+        return selfTest();
+
+    std::locale::global(std::locale(""));
+    std::wcout.imbue(std::locale());
+    std::wcin.imbue(std::locale());
+
+    try {
+        std::wstring substitution_key, route_key;
+        std::wcout << L"Введите ключ шифра Гронсфельда (буквы алфавита): ";
+        std::getline(std::wcin, substitution_key);
+        std::wcout << L"Введите ключ перестановки (количество столбцов или order:3142, snake:N, spiral:N): ";
+        std::getline(std::wcin, route_key);
+
+        modAlphaCipher substitution(substitution_key);
+        RouteCipher route(route_key);
+        CipherPipeline pipeline;
+        pipeline.then(substitution).then(route);
+        std::wcout << L"Цепочка собрана: этапов " << pipeline.size() << std::endl;
+
+        while (true) {
+            std::wcout << L"\n=========== МЕНЮ ===========\n";
+            std::wcout << L"1 - Шифровать текст\n";
+            std::wcout << L"2 - Дешифровать текст\n";
+            std::wcout << L"3 - Сравнить с последовательным применением шифров\n";
+            std::wcout << L"0 - Выход из программы\n";
+            std::wcout << L"Выберите операцию: ";
+
+            int choice;
+            std::wcin >> choice;
+            std::wcin.ignore();
+
+            if (choice == 0) {
+                std::wcout << L"Завершение работы программы.\n";
+                break;
+            }
+            if (choice > 3 || choice < 0) {
+                std::wcout << L"Неверная операция! Пожалуйста, выберите 0, 1, 2 или 3\n";
+                continue;
+            }
+            if (choice == 3) {
+                checkPipeline(substitution, route, pipeline, &std::wcout);
+                continue;
+            }
+
+            std::wstring text;
+            std::wcout << L"Введите текст: ";
+            std::getline(std::wcin, text);
+            try {
+                if (choice == 1)
+                    std::wcout << L"Зашифрованный текст: " << pipeline.encrypt(text) << std::endl;
+                else
+                    std::wcout << L"Расшифрованный текст: " << pipeline.decrypt(text) << std::endl;
+            } catch (const cipher_error& e) {
+                std::wcerr << L"\nОшибка обработки текста: " << e.what() << std::endl;
+            }
+        }
+    } catch (const cipher_error& e) {
+        std::wcerr << L"Ошибка инициализации шифра: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::exception& e) {
+        std::wcerr << L"Неожиданная ошибка: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include "pipeline.h"
+#include "letters.h"
+
+/**
+ * @file pipeline.cpp
+ * @brief Реализация класса CipherPipeline
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Добавление этапа замены
+ * @param stage - шифр Гронсфельда
+ * @return Ссылка на эту цепочку
+ */
+CipherPipeline& CipherPipeline::then(const modAlphaCipher& stage)
+{
+    stages.push_back(Stage{std::make_shared<const modAlphaCipher>(stage), nullptr});
+    return *this;
+}
+
+/**
+ * @brief Добавление этапа перестановки
+ * @param stage - шифр маршрутной перестановки
+ * @return Ссылка на эту цепочку
+ */
+CipherPipeline& CipherPipeline::then(const RouteCipher& stage)
+{
+    stages.push_back(Stage{nullptr, std::make_shared<const RouteCipher>(stage)});
+    return *this;
+}
+
+/**
+ * @brief Маршруты этапов перестановки для текста заданной длины
+ * @param length - длина текста
+ * @return Маршруты в порядке этапов
+ */
+std::vector<RouteMap> CipherPipeline::routeMaps(std::size_t length) const
+{
+    std::vector<RouteMap> maps;
+    for (const Stage& stage : stages) {
+        if (stage.route)
+            maps.push_back(stage.route->routeMap(length));
+    }
+    return maps;
+}
+
+/**
+ * @brief Шифрование текста
+ * @param open_text - открытый текст
+ * @return Зашифрованная строка
+ * @throw cipher_error если текст пуст после очистки или содержит буквы вне алфавита
+ */
+std::wstring CipherPipeline::encrypt(const std::wstring& open_text) const
+{
+    std::wstring result(open_text.size(), L'\0');
+    std::size_t written;
+    throwIfFailed(try_encrypt_into(open_text.data(), open_text.size(), &result[0], result.size(), written));
+    result.resize(written);
+    return result;
+}
+
+/**
+ * @brief Дешифрование текста
+ * @param cipher_text - шифртекст
+ * @return Расшифрованная строка
+ * @throw cipher_error если текст пуст или содержит не заглавные буквы алфавита
+ */
+std::wstring CipherPipeline::decrypt(const std::wstring& cipher_text) const
+{
+    std::wstring result(cipher_text.size(), L'\0');
+    std::size_t written;
+    throwIfFailed(try_decrypt_into(cipher_text.data(), cipher_text.size(), &result[0], result.size(), written));
+    return result;
+}
+
+/**
+ * @brief Шифрование в буфер вызывающей стороны без исключений
+ * @param in - открытый текст
+ * @param n - длина открытого текста
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера (достаточно n)
+ * @param written - количество записанных символов
+ * @return Вид ошибки и позиция первого недопустимого символа
+ * @details Для позиции p результата этапы обходятся с последнего: перестановка
+ * переводит позицию в позицию своего входа (RouteMap::source), замена добавляет
+ * сдвиг ключа для текущей позиции. Найденная буква входа сдвигается на сумму сдвигов
+ */
+cipher_status CipherPipeline::try_encrypt_into(const wchar_t* in, std::size_t n, wchar_t* out,
+                                               std::size_t out_size, std::size_t& written) const
+{
+    written = 0;
+    const Alphabet& alphabet = modAlphaCipher::alphabet();
+    std::vector<unsigned char> letters;
+    letters.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        wchar_t c = in[i];
+        if (!isLetter(c))
+            continue;
+        int a = alphabet.index(toUpperLetter(c));
+        if (a == Alphabet::npos)
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+        letters.push_back(a);
+    }
+    if (letters.empty())
+        return cipher_status(cipher_errc::empty_open_text);
+    if (out_size < letters.size())
+        return cipher_status(cipher_errc::buffer_too_small);
+
+    const std::size_t length = letters.size();
+    const std::size_t m = alphabet.size();
+    const std::vector<RouteMap> maps = routeMaps(length);
+    for (std::size_t p = 0; p < length; p++) {
+        std::size_t pos = p;
+        std::size_t shift = 0;
+        std::size_t route = maps.size();
+        for (std::size_t s = stages.size(); s-- > 0;) {
+            if (stages[s].route)
+                pos = maps[--route].source(pos);
+            else
+                shift += stages[s].substitution->keyShift(pos);
+        }
+        out[p] = alphabet.symbol((letters[pos] + shift) % m);
+    }
+    written = length;
+    return cipher_status();
+}
+
+/**
+ * @brief Дешифрование в буфер вызывающей стороны без исключений
+ * @param in - шифртекст
+ * @param n - длина шифртекста
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера (не меньше n)
+ * @param written - количество записанных символов
+ * @return Вид ошибки и позиция первого недопустимого символа
+ * @details Обратная цепочка: для позиции i открытого текста этапы обходятся с первого,
+ * замена накапливает сдвиг ключа, перестановка переводит позицию в позицию своего
+ * выхода (RouteMap::target). Буква шифртекста на найденной позиции сдвигается назад
+ */
+cipher_status CipherPipeline::try_decrypt_into(const wchar_t* in, std::size_t n, wchar_t* out,
+                                               std::size_t out_size, std::size_t& written) const
+{
+    written = 0;
+    if (n == 0)
+        return cipher_status(cipher_errc::empty_cipher_text);
+    const Alphabet& alphabet = modAlphaCipher::alphabet();
+    std::vector<unsigned char> letters(n);
+    for (std::size_t i = 0; i < n; i++) {
+        if (!isUpperLetter(in[i]))
+            return cipher_status(cipher_errc::invalid_cipher_text, i);
+        int a = alphabet.index(in[i]);
+        if (a == Alphabet::npos)
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+        letters[i] = a;
+    }
+    if (out_size < n)
+        return cipher_status(cipher_errc::buffer_too_small);
+
+    const std::size_t m = alphabet.size();
+    const std::vector<RouteMap> maps = routeMaps(n);
+    for (std::size_t i = 0; i < n; i++) {
+        std::size_t pos = i;
+        std::size_t shift = 0;
+        std::size_t route = 0;
+        for (const Stage& stage : stages) {
+            if (stage.route)
+                pos = maps[route++].target(pos);
+            else
+                shift += stage.substitution->keyShift(pos);
+        }
+        out[i] = alphabet.symbol((letters[pos] + m - shift % m) % m);
+    }
+    written = n;
+    return cipher_status();
+}
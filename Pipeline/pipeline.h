@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "cipher_error.h"
+#include "cipher_status.h"
+#include "modAlphaCipher.h"
+#include "module.h"
+
+/**
+ * @file pipeline.h
+ * @brief Заголовочный файл класса CipherPipeline — составного шифра из нескольких этапов
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Составной шифр: цепочка этапов замены (Гронсфельд) и перестановки (маршрут)
+ * @details Этапы применяются при шифровании в порядке добавления, при дешифровании —
+ * в обратном порядке с обратными преобразованиями. Цепочка выполняется одним проходом:
+ * текст один раз проверяется и переводится в номера букв, а каждая буква результата
+ * собирается сразу — по маршрутам (RouteMap) находится её позиция во входном тексте,
+ * по этапам замены складываются сдвиги ключей. Промежуточные строки этапов не строятся.
+ *
+ * Текст проверяется по правилам шифра Гронсфельда: не-буквы отбрасываются, буквы
+ * вне его алфавита — ошибка, даже если в цепочке только перестановки.
+ * Этапы копируются при добавлении, поэтому исходные шифры можно уничтожить.
+ * Методы шифрования и дешифрования константны и потокобезопасны
+ */
+class CipherPipeline
+{
+public:
+    /**
+     * @brief Пустая цепочка (только проверка и нормализация текста)
+     */
+    CipherPipeline() = default;
+
+    /**
+     * @brief Добавление этапа замены
+     * @param stage - шифр Гронсфельда
+     * @return Ссылка на эту цепочку
+     */
+    CipherPipeline& then(const modAlphaCipher& stage);
+
+    /**
+     * @brief Добавление этапа перестановки
+     * @param stage - шифр маршрутной перестановки
+     * @return Ссылка на эту цепочку
+     */
+    CipherPipeline& then(const RouteCipher& stage);
+
+    /**
+     * @brief Количество этапов
+     * @return Число добавленных этапов
+     */
+    std::size_t size() const
+    {
+        return stages.size();
+    }
+
+    /**
+     * @brief Шифрование текста
+     * @param open_text - открытый текст
+     * @return Зашифрованная строка
+     * @throw cipher_error если текст пуст после очистки или содержит буквы вне алфавита
+     */
+    std::wstring encrypt(const std::wstring& open_text) const;
+
+    /**
+     * @brief Дешифрование текста
+     * @param cipher_text - шифртекст
+     * @return Расшифрованная строка
+     * @throw cipher_error если текст пуст или содержит не заглавные буквы алфавита
+     */
+    std::wstring decrypt(const std::wstring& cipher_text) const;
+
+    /**
+     * @brief Шифрование в буфер вызывающей стороны без исключений
+     * @param in - открытый текст
+     * @param n - длина открытого текста
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера (достаточно n)
+     * @param written - количество записанных символов
+     * @return Вид ошибки и позиция первого недопустимого символа
+     */
+    cipher_status try_encrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+    /**
+     * @brief Дешифрование в буфер вызывающей стороны без исключений
+     * @param in - шифртекст
+     * @param n - длина шифртекста
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера (не меньше n)
+     * @param written - количество записанных символов
+     * @return Вид ошибки и позиция первого недопустимого символа
+     */
+    cipher_status try_decrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+private:
+    /**
+     * @brief Этап цепочки: задан ровно один из указателей
+     */
+    struct Stage {
+        std::shared_ptr<const modAlphaCipher> substitution; ///< Этап замены
+        std::shared_ptr<const RouteCipher> route; ///< Этап перестановки
+    };
+
+    std::vector<Stage> stages; ///< Этапы в порядке шифрования
+
+    /**
+     * @brief Маршруты этапов перестановки для текста заданной длины
+     * @param length - длина текста
+     * @return Маршруты в порядке этапов
+     */
+    std::vector<RouteMap> routeMaps(std::size_t length) const;
+};
@@ -0,0 +1,59 @@
+#include "alphabet.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @file alphabet.cpp
+ * @brief Реализация класса Alphabet
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+const int Alphabet::npos;
+const unsigned long Alphabet::block_begin;
+const unsigned long Alphabet::block_size;
+const unsigned char Alphabet::unknown;
+
+/**
+ * @brief Построение таблиц по строке алфавита
+ * @param letters - буквы алфавита по порядку
+ * @throw std::invalid_argument если алфавит пуст, длиннее 255 букв или содержит повторы
+ */
+Alphabet::Alphabet(const std::wstring& letters): letters(letters)
+{
+    if (letters.empty())
+        throw std::invalid_argument("Empty alphabet");
+    if (letters.size() >= unknown)
+        throw std::invalid_argument("Alphabet is too long");
+
+    block.fill(unknown);
+    for (unsigned i = 0; i < letters.size(); i++) {
+        if (index(letters[i]) != npos)
+            throw std::invalid_argument("Duplicate letter in alphabet");
+        unsigned long off = static_cast<unsigned long>(letters[i]) - block_begin;
+        if (off < block_size) {
+            block[off] = static_cast<unsigned char>(i);
+        } else {
+            auto pos = std::lower_bound(fallback.begin(), fallback.end(),
+                                        std::make_pair(letters[i], static_cast<unsigned char>(0)));
+            fallback.insert(pos, std::make_pair(letters[i], static_cast<unsigned char>(i)));
+        }
+    }
+}
+
+/**
+ * @brief Поиск символа вне кириллического блока
+ * @param c - символ
+ * @return Номер символа или npos
+ */
+int Alphabet::lookupFallback(wchar_t c) const
+{
+    auto pos = std::lower_bound(fallback.begin(), fallback.end(), c,
+                                [](const std::pair<wchar_t, unsigned char>& p, wchar_t v) {
+                                    return p.first < v;
+                                });
+    if (pos == fallback.end() || pos->first != c)
+        return npos;
+    return pos->second;
+}
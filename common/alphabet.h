@@ -0,0 +1,104 @@
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+#include <utility>
+
+/**
+ * @file alphabet.h
+ * @brief Заголовочный файл класса Alphabet — скомпилированной таблицы алфавита
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Скомпилированный алфавит для шифров замены
+ * @details Переводит символ в его номер в алфавите за O(1) через плоскую таблицу,
+ * покрывающую кириллический блок Unicode (U+0400..U+04FF). Символы вне блока
+ * ищутся двоичным поиском в небольшом отсортированном массиве.
+ * Символ, отсутствующий в алфавите, явно сообщается значением npos.
+ */
+class Alphabet
+{
+public:
+    static const int npos = -1; ///< Признак символа вне алфавита
+
+    Alphabet() = delete; ///< Удалённый конструктор по умолчанию
+
+    /**
+     * @brief Построение таблиц по строке алфавита
+     * @param letters - буквы алфавита по порядку
+     * @throw std::invalid_argument если алфавит пуст, длиннее 255 букв или содержит повторы
+     */
+    explicit Alphabet(const std::wstring& letters);
+
+    /**
+     * @brief Номер символа в алфавите
+     * @param c - символ
+     * @return Номер символа или npos, если символа нет в алфавите
+     */
+    int index(wchar_t c) const
+    {
+        unsigned long off = static_cast<unsigned long>(c) - block_begin;
+        if (off < block_size) {
+            unsigned char i = block[off];
+            return i == unknown ? npos : i;
+        }
+        return lookupFallback(c);
+    }
+
+    /**
+     * @brief Проверка принадлежности символа алфавиту
+     * @param c - символ
+     * @return true если символ есть в алфавите
+     */
+    bool contains(wchar_t c) const
+    {
+        return index(c) != npos;
+    }
+
+    /**
+     * @brief Символ по номеру
+     * @param i - номер символа (0 <= i < size())
+     * @return Символ алфавита
+     */
+    wchar_t symbol(int i) const
+    {
+        return letters[i];
+    }
+
+    /**
+     * @brief Мощность алфавита
+     * @return Количество букв
+     */
+    std::size_t size() const
+    {
+        return letters.size();
+    }
+
+    /**
+     * @brief Буквы алфавита по порядку
+     * @return Строка алфавита
+     */
+    const std::wstring& str() const
+    {
+        return letters;
+    }
+
+private:
+    static const unsigned long block_begin = 0x0400; ///< Начало кириллического блока
+    static const unsigned long block_size = 0x100;   ///< Размер кириллического блока
+    static const unsigned char unknown = 0xFF;       ///< Метка отсутствующего символа
+
+    std::wstring letters; ///< Буквы алфавита по порядку
+    std::array<unsigned char, block_size> block; ///< Плоская таблица "символ → номер" для кириллицы
+    std::vector<std::pair<wchar_t, unsigned char>> fallback; ///< Отсортированные символы вне блока
+
+    /**
+     * @brief Поиск символа вне кириллического блока
+     * @param c - символ
+     * @return Номер символа или npos
+     */
+    int lookupFallback(wchar_t c) const;
+};
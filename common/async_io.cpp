@@ -0,0 +1,241 @@
+#include "async_io.h"
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <unistd.h>
+#if CIPHER_IO_URING
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+/**
+ * @file async_io.cpp
+ * @brief Реализация очереди асинхронного ввода-вывода блоками
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Создание очереди
+ * @param depth - наибольшее количество одновременных операций
+ * @param backend - способ ввода-вывода
+ * @throw std::system_error если io_uring запрошен явно, но недоступен
+ */
+IoQueue::IoQueue(unsigned depth, IoBackend backend)
+{
+    if (backend == IoBackend::plain)
+        return;
+    int error = setupRing(depth);
+    if (error != 0 && backend == IoBackend::uring)
+        throw std::system_error(error, std::generic_category(), "io_uring");
+}
+
+/**
+ * @brief Ожидание незавершённых операций и освобождение кольца
+ */
+IoQueue::~IoQueue()
+{
+    while (in_flight > 0) {
+        try {
+            wait();
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    closeRing();
+}
+
+#if CIPHER_IO_URING
+
+/**
+ * @brief Системный вызов io_uring_enter с повтором при EINTR
+ * @param fd - дескриптор кольца
+ * @param submit - количество новых заявок
+ * @param wait - количество ожидаемых завершений
+ * @return Результат вызова или -1
+ */
+static int enterRing(int fd, unsigned submit, unsigned wait)
+{
+    int r;
+    do {
+        r = ::syscall(__NR_io_uring_enter, fd, submit, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+    } while (r < 0 && errno == EINTR);
+    return r;
+}
+
+/**
+ * @brief Смещение внутри отображения как указатель
+ * @param base - начало отображения
+ * @param offset - смещение в байтах
+ * @return Указатель на поле кольца
+ */
+static unsigned* ringField(void* base, unsigned offset)
+{
+    return reinterpret_cast<unsigned*>(static_cast<char*>(base) + offset);
+}
+
+/**
+ * @brief Создание кольца io_uring
+ * @param depth - количество записей кольца
+ * @return 0 при успехе, иначе errno
+ */
+int IoQueue::setupRing(unsigned depth)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = ::syscall(__NR_io_uring_setup, depth, &params);
+    if (fd < 0)
+        return errno;
+    ring_fd = fd;
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    sq_ring = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        sq_ring = nullptr;
+        int error = errno;
+        closeRing();
+        return error;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cq_ring = sq_ring;
+    } else {
+        cq_ring = ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) {
+            cq_ring = nullptr;
+            int error = errno;
+            closeRing();
+            return error;
+        }
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        sqes = nullptr;
+        int error = errno;
+        closeRing();
+        return error;
+    }
+
+    sq_tail = ringField(sq_ring, params.sq_off.tail);
+    sq_mask = ringField(sq_ring, params.sq_off.ring_mask);
+    sq_array = ringField(sq_ring, params.sq_off.array);
+    cq_head = ringField(cq_ring, params.cq_off.head);
+    cq_tail = ringField(cq_ring, params.cq_off.tail);
+    cq_mask = ringField(cq_ring, params.cq_off.ring_mask);
+    cqes = static_cast<char*>(cq_ring) + params.cq_off.cqes;
+    return 0;
+}
+
+/**
+ * @brief Снятие отображений и закрытие кольца
+ */
+void IoQueue::closeRing()
+{
+    if (sqes)
+        ::munmap(sqes, sqes_size);
+    if (cq_ring && cq_ring != sq_ring)
+        ::munmap(cq_ring, cq_ring_size);
+    if (sq_ring)
+        ::munmap(sq_ring, sq_ring_size);
+    sqes = cq_ring = sq_ring = nullptr;
+    if (ring_fd >= 0)
+        ::close(ring_fd);
+    ring_fd = -1;
+}
+
+#else
+
+/**
+ * @brief Создание кольца io_uring (сборка без io_uring)
+ * @param depth - количество записей кольца
+ * @return ENOSYS
+ */
+int IoQueue::setupRing(unsigned depth)
+{
+    (void)depth;
+    return ENOSYS;
+}
+
+/**
+ * @brief Снятие отображений и закрытие кольца (сборка без io_uring)
+ */
+void IoQueue::closeRing()
+{
+}
+
+#endif
+
+/**
+ * @brief Постановка операции
+ * @param request - операция; должна оставаться живой до возврата из wait()
+ * @throw std::system_error если операцию не удалось передать ядру
+ * @details Для io_uring заявка записывается в кольцо отправки, хвост публикуется
+ * с семантикой release и ядро уведомляется вызовом io_uring_enter. Для pread/pwrite
+ * операция выполняется сразу
+ */
+void IoQueue::submit(IoRequest* request)
+{
+    if (ring_fd < 0) {
+        request->result = request->write
+            ? ::pwrite(request->fd, request->data, request->size, request->offset)
+            : ::pread(request->fd, request->data, request->size, request->offset);
+        if (request->result < 0)
+            request->result = -errno;
+        completed.push_back(request);
+        in_flight++;
+        return;
+    }
+#if CIPHER_IO_URING
+    unsigned tail = *sq_tail;
+    unsigned index = tail & *sq_mask;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = request->write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = request->fd;
+    sqe->addr = reinterpret_cast<unsigned long long>(request->data);
+    sqe->len = request->size;
+    sqe->off = request->offset;
+    sqe->user_data = reinterpret_cast<unsigned long long>(request);
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    if (enterRing(ring_fd, 1, 0) < 0)
+        throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+    in_flight++;
+#endif
+}
+
+/**
+ * @brief Ожидание завершения любой операции
+ * @return Завершённая операция с заполненным result
+ * @throw std::system_error при ошибке ожидания
+ */
+IoRequest* IoQueue::wait()
+{
+    if (ring_fd < 0) {
+        IoRequest* request = completed.front();
+        completed.pop_front();
+        in_flight--;
+        return request;
+    }
+#if CIPHER_IO_URING
+    unsigned head = *cq_head;
+    while (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+        if (enterRing(ring_fd, 0, 1) < 0)
+            throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+    }
+    io_uring_cqe* cqe = static_cast<io_uring_cqe*>(cqes) + (head & *cq_mask);
+    IoRequest* request = reinterpret_cast<IoRequest*>(cqe->user_data);
+    request->result = cqe->res;
+    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+    in_flight--;
+    return request;
+#else
+    return nullptr;
+#endif
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+
+/**
+ * @file async_io.h
+ * @brief Заголовочный файл очереди асинхронного ввода-вывода блоками
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details При сборке с CIPHER_IO_URING=1 (по умолчанию в Makefile) чтение и запись
+ * выполняются через io_uring: несколько операций находятся в ядре одновременно,
+ * а поток лишь забирает завершённые. Кольцо создаётся системными вызовами напрямую,
+ * без liburing. Если ядро не поддерживает io_uring или сборка выполнена с
+ * CIPHER_IO_URING=0, используются обычные pread/pwrite.
+ */
+
+#ifndef CIPHER_IO_URING
+#define CIPHER_IO_URING 1
+#endif
+
+/**
+ * @brief Способ ввода-вывода
+ */
+enum class IoBackend {
+    automatic, ///< io_uring, если доступен, иначе pread/pwrite
+    uring,     ///< Только io_uring (ошибка, если недоступен)
+    plain      ///< pread/pwrite
+};
+
+/**
+ * @brief Операция чтения или записи блока
+ */
+struct IoRequest {
+    int fd = -1; ///< Файл
+    bool write = false; ///< true - запись, false - чтение
+    char* data = nullptr; ///< Буфер
+    std::size_t size = 0; ///< Длина операции в байтах
+    unsigned long long offset = 0; ///< Смещение в файле
+    long result = 0; ///< Результат: число байтов или -errno
+    void* owner = nullptr; ///< Данные вызывающей стороны
+};
+
+/**
+ * @brief Очередь операций ввода-вывода одного потока
+ * @details Не потокобезопасна: операции ставит и забирает один поток. Одновременно
+ * в очереди не больше depth операций. С pread/pwrite операция выполняется сразу
+ * в submit(), а wait() лишь возвращает её. Деструктор дожидается всех операций,
+ * чтобы ядро не писало в освобождённые буферы.
+ */
+class IoQueue
+{
+public:
+    /**
+     * @brief Создание очереди
+     * @param depth - наибольшее количество одновременных операций
+     * @param backend - способ ввода-вывода
+     * @throw std::system_error если io_uring запрошен явно, но недоступен
+     */
+    IoQueue(unsigned depth, IoBackend backend);
+
+    /**
+     * @brief Ожидание незавершённых операций и освобождение кольца
+     */
+    ~IoQueue();
+
+    IoQueue(const IoQueue&) = delete; ///< Очередь не копируется
+    IoQueue& operator=(const IoQueue&) = delete; ///< Очередь не копируется
+
+    /**
+     * @brief Постановка операции
+     * @param request - операция; должна оставаться живой до возврата из wait()
+     * @throw std::system_error если операцию не удалось передать ядру
+     */
+    void submit(IoRequest* request);
+
+    /**
+     * @brief Ожидание завершения любой операции
+     * @return Завершённая операция с заполненным result
+     * @throw std::system_error при ошибке ожидания
+     * @details Вызывается, только если pending() > 0
+     */
+    IoRequest* wait();
+
+    /**
+     * @brief Количество незавершённых операций
+     * @return Число операций, поставленных и ещё не возвращённых wait()
+     */
+    std::size_t pending() const
+    {
+        return in_flight;
+    }
+
+    /**
+     * @brief Используется ли io_uring
+     * @return true для io_uring, false для pread/pwrite
+     */
+    bool uring() const
+    {
+        return ring_fd >= 0;
+    }
+
+private:
+    int ring_fd = -1; ///< Дескриптор io_uring (-1 для pread/pwrite)
+    void* sq_ring = nullptr; ///< Отображение кольца отправки
+    void* cq_ring = nullptr; ///< Отображение кольца завершения (может совпадать с sq_ring)
+    void* sqes = nullptr; ///< Отображение массива заявок
+    std::size_t sq_ring_size = 0; ///< Размер отображения кольца отправки
+    std::size_t cq_ring_size = 0; ///< Размер отображения кольца завершения
+    std::size_t sqes_size = 0; ///< Размер отображения массива заявок
+    unsigned* sq_tail = nullptr; ///< Хвост кольца отправки
+    unsigned* sq_mask = nullptr; ///< Маска индексов кольца отправки
+    unsigned* sq_array = nullptr; ///< Индексы заявок кольца отправки
+    unsigned* cq_head = nullptr; ///< Голова кольца завершения
+    unsigned* cq_tail = nullptr; ///< Хвост кольца завершения
+    unsigned* cq_mask = nullptr; ///< Маска индексов кольца завершения
+    void* cqes = nullptr; ///< Записи кольца завершения
+    std::size_t in_flight = 0; ///< Незавершённые операции
+    std::deque<IoRequest*> completed; ///< Операции, выполненные pread/pwrite
+
+    /**
+     * @brief Создание кольца io_uring
+     * @param depth - количество записей кольца
+     * @return 0 при успехе, иначе errno
+     */
+    int setupRing(unsigned depth);
+
+    /**
+     * @brief Снятие отображений и закрытие кольца
+     */
+    void closeRing();
+};
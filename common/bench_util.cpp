@@ -0,0 +1,150 @@
+#include "bench_util.h"
+#include "utf8.h"
+#include "size_arg.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif
+
+/**
+ * @file bench_util.cpp
+ * @brief Реализация общих средств измерения производительности
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Разбор аргументов командной строки
+ * @param argc - количество аргументов
+ * @param argv - аргументы
+ * @return Параметры запуска
+ * @throw std::invalid_argument если аргументы неверны
+ */
+BenchOptions parseBenchOptions(int argc, char* argv[])
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 == argc)
+            throw std::invalid_argument("missing value for " + arg);
+        std::string value = argv[++i];
+        if (arg == "--min-size")
+            options.min_size = parseSize(value);
+        else if (arg == "--max-size")
+            options.max_size = parseSize(value);
+        else if (arg == "--min-time")
+            options.min_time = std::stod(value);
+        else
+            throw std::invalid_argument("unknown option: " + arg);
+    }
+    if (options.min_size == 0 || options.min_size > options.max_size)
+        throw std::invalid_argument("invalid size range");
+    return options;
+}
+
+/**
+ * @brief Размеры входа от min_size до max_size с шагом ×16
+ * @param options - параметры запуска
+ * @return Список размеров в байтах
+ */
+std::vector<std::size_t> benchSizes(const BenchOptions& options)
+{
+    std::vector<std::size_t> sizes;
+    for (std::size_t s = options.min_size; s <= options.max_size; s *= 16) {
+        sizes.push_back(s);
+        if (s > options.max_size / 16)
+            break;
+    }
+    return sizes;
+}
+
+/**
+ * @brief Генерация текста в UTF-8
+ * @param bytes - наибольший размер текста в байтах
+ * @param alphabet - символы, из которых составляется текст
+ * @param seed - зерно генератора
+ * @return Текст не длиннее bytes, без разрезанных символов
+ */
+std::string benchText(std::size_t bytes, const std::wstring& alphabet, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+    std::string text(bytes, '\0');
+    std::size_t used = 0;
+    char buf[4];
+    for (;;) {
+        std::size_t len = utf8Encode(alphabet[pick(rng)], buf);
+        if (used + len > bytes)
+            break;
+        for (std::size_t i = 0; i < len; i++)
+            text[used++] = buf[i];
+    }
+    text.resize(used);
+    return text;
+}
+
+/**
+ * @brief Количество символов в тексте UTF-8
+ * @param text - текст
+ * @return Количество кодовых точек
+ */
+std::size_t utf8Chars(const std::string& text)
+{
+    std::size_t chars = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80)
+            chars++;
+    }
+    return chars;
+}
+
+/**
+ * @brief Измерение одной точки
+ * @param options - параметры запуска
+ * @param run - измеряемое действие
+ * @param result - точка, в которую записываются число повторов и лучшее время
+ */
+void benchMeasure(const BenchOptions& options, const std::function<void()>& run, BenchResult& result)
+{
+    typedef std::chrono::steady_clock clock;
+    double total = 0;
+    double best = 0;
+    std::size_t iterations = 0;
+    do {
+        clock::time_point start = clock::now();
+        run();
+        double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        if (iterations == 0 || elapsed < best)
+            best = elapsed;
+        total += elapsed;
+        iterations++;
+    } while (total < options.min_time);
+    result.iterations = iterations;
+    result.seconds = best;
+}
+
+/**
+ * @brief Вывод результатов в JSON
+ * @param name - название набора измерений
+ * @param results - точки измерений
+ */
+void benchPrintJson(const std::string& name, const std::vector<BenchResult>& results)
+{
+    std::printf("{\n  \"benchmark\": \"%s\",\n  \"commit\": \"%s\",\n  \"compiler\": \"%s\",\n  \"results\": [\n",
+                name.c_str(), BENCH_COMMIT, __VERSION__);
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        double mb_per_s = r.seconds > 0 ? r.bytes / r.seconds / 1e6 : 0;
+        double ns_per_char = r.chars > 0 ? r.seconds * 1e9 / r.chars : 0;
+        std::printf("    {\"op\": \"%s\", \"input\": \"%s\", \"%s\": %zu, \"bytes\": %zu, \"chars\": %zu, "
+                    "\"iterations\": %zu, \"seconds\": %.9f, \"mb_per_s\": %.3f, \"ns_per_char\": %.3f}%s\n",
+                    r.op.c_str(), r.input.c_str(), r.param.c_str(), r.param_value, r.bytes, r.chars,
+                    r.iterations, r.seconds, mb_per_s, ns_per_char, i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file bench_util.h
+ * @brief Общие средства измерения производительности шифров
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Тексты генерируются детерминированно (фиксированное зерно), поэтому
+ * результаты воспроизводимы от запуска к запуску. Результаты выводятся в JSON.
+ */
+
+/**
+ * @brief Параметры запуска измерений
+ */
+struct BenchOptions {
+    std::size_t min_size = 16; ///< Наименьший размер входа в байтах
+    std::size_t max_size = std::size_t(1) << 30; ///< Наибольший размер входа в байтах
+    double min_time = 0.2; ///< Наименьшее суммарное время измерения одной точки, с
+};
+
+/**
+ * @brief Одна точка измерений
+ */
+struct BenchResult {
+    std::string op; ///< Операция: encrypt или decrypt
+    std::string input; ///< Вид входа: valid или dirty
+    std::string param; ///< Имя параметра ключа: key_length или columns
+    std::size_t param_value = 0; ///< Значение параметра ключа
+    std::size_t bytes = 0; ///< Размер входа в байтах
+    std::size_t chars = 0; ///< Количество символов входа
+    std::size_t iterations = 0; ///< Количество повторов
+    double seconds = 0; ///< Лучшее время одного повтора, с
+};
+
+/**
+ * @brief Разбор аргументов командной строки
+ * @param argc - количество аргументов
+ * @param argv - аргументы
+ * @return Параметры запуска
+ * @throw std::invalid_argument если аргументы неверны
+ * @details Поддерживаются --min-size N, --max-size N (суффиксы K, M, G) и --min-time СЕК
+ */
+BenchOptions parseBenchOptions(int argc, char* argv[]);
+
+/**
+ * @brief Размеры входа от min_size до max_size с шагом ×16
+ * @param options - параметры запуска
+ * @return Список размеров в байтах
+ */
+std::vector<std::size_t> benchSizes(const BenchOptions& options);
+
+/**
+ * @brief Генерация текста в UTF-8
+ * @param bytes - наибольший размер текста в байтах
+ * @param alphabet - символы, из которых составляется текст
+ * @param seed - зерно генератора
+ * @return Текст не длиннее bytes, без разрезанных символов
+ */
+std::string benchText(std::size_t bytes, const std::wstring& alphabet, unsigned seed);
+
+/**
+ * @brief Количество символов в тексте UTF-8
+ * @param text - текст
+ * @return Количество кодовых точек
+ */
+std::size_t utf8Chars(const std::string& text);
+
+/**
+ * @brief Измерение одной точки
+ * @param options - параметры запуска
+ * @param run - измеряемое действие
+ * @param result - точка, в которую записываются число повторов и лучшее время
+ * @details Действие повторяется, пока суммарное время меньше min_time (не менее одного раза)
+ */
+void benchMeasure(const BenchOptions& options, const std::function<void()>& run, BenchResult& result);
+
+/**
+ * @brief Вывод результатов в JSON
+ * @param name - название набора измерений
+ * @param results - точки измерений
+ */
+void benchPrintJson(const std::string& name, const std::vector<BenchResult>& results);
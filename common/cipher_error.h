@@ -0,0 +1,34 @@
+#pragma once
+#include <stdexcept>
+#include <string>
+
+/**
+ * @file cipher_error.h
+ * @brief Исключение для ошибок шифрования, общее для обоих шифров
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Вынесено в общий заголовок, чтобы оба шифра можно было подключить
+ * в одну программу (см. конвейер Pipeline)
+ */
+
+/**
+ * @brief Класс исключения для ошибок шифрования
+ * @details Наследуется от std::invalid_argument
+ */
+class cipher_error : public std::invalid_argument {
+public:
+    /**
+     * @brief Конструктор исключения с передачей строки
+     * @param what_arg - сообщение об ошибке
+     */
+    explicit cipher_error(const std::string& what_arg):
+        std::invalid_argument(what_arg) {}
+    
+    /**
+     * @brief Конструктор исключения с передачей строки (C-стиль)
+     * @param what_arg - сообщение об ошибке
+     */
+    explicit cipher_error(const char* what_arg):
+        std::invalid_argument(what_arg) {}
+};
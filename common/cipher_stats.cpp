@@ -0,0 +1,117 @@
+#include "cipher_stats.h"
+#include <cstdio>
+
+/**
+ * @file cipher_stats.cpp
+ * @brief Реализация снимков статистики шифров
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+const std::size_t LatencyHistogram::bucket_count;
+
+/**
+ * @brief Количество замеров
+ * @return Сумма по корзинам
+ */
+std::uint64_t LatencyHistogram::count() const
+{
+    std::uint64_t result = 0;
+    for (std::uint64_t c : buckets)
+        result += c;
+    return result;
+}
+
+/**
+ * @brief Оценка квантиля
+ * @param q - уровень от 0 до 1
+ * @return Верхняя граница корзины, в которую попадает квантиль, в наносекундах
+ */
+std::uint64_t LatencyHistogram::percentile(double q) const
+{
+    std::uint64_t total = count();
+    if (total == 0)
+        return 0;
+    std::uint64_t rank = static_cast<std::uint64_t>(q * (total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < bucket_count; b++) {
+        seen += buckets[b];
+        if (seen >= rank)
+            return (std::uint64_t(1) << b) - 1;
+    }
+    return (std::uint64_t(1) << (bucket_count - 1)) - 1;
+}
+
+/**
+ * @brief Снимок текущих значений
+ * @return Копия счётчиков и гистограмм
+ */
+CipherStatsSnapshot CipherStats::snapshot() const
+{
+    CipherStatsSnapshot result;
+    result.calls = calls.load(std::memory_order_relaxed);
+    result.chars = chars.load(std::memory_order_relaxed);
+    result.rejected = rejected.load(std::memory_order_relaxed);
+    result.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+    for (std::size_t s = 0; s < stages.size(); s++) {
+        for (std::size_t b = 0; b < LatencyHistogram::bucket_count; b++)
+            result.stages[s].buckets[b] = stages[s].buckets[b].load(std::memory_order_relaxed);
+        result.stages[s].total_ns = stages[s].total_ns.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+/**
+ * @brief Обнуление всех счётчиков
+ */
+void CipherStats::reset()
+{
+    calls.store(0, std::memory_order_relaxed);
+    chars.store(0, std::memory_order_relaxed);
+    rejected.store(0, std::memory_order_relaxed);
+    bytes_allocated.store(0, std::memory_order_relaxed);
+    for (StageCounters& s : stages) {
+        for (auto& b : s.buckets)
+            b.store(0, std::memory_order_relaxed);
+        s.total_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Запись снимка в JSON
+ * @param name - имя шифра
+ * @param stats - снимок
+ * @return JSON-объект с счётчиками и гистограммами этапов (пустые корзины в конце опускаются)
+ */
+std::string formatStats(const std::string& name, const CipherStatsSnapshot& stats)
+{
+    static const char* const stage_names[] = { "validate", "transform", "allocate" };
+    char line[256];
+    std::string result = "{\n  \"cipher\": \"" + name + "\",\n";
+    std::snprintf(line, sizeof line,
+                  "  \"enabled\": %s,\n  \"calls\": %llu,\n  \"chars\": %llu,\n  \"rejected\": %llu,\n"
+                  "  \"bytes_allocated\": %llu,\n  \"stages\": {\n",
+                  CipherStats::enabled ? "true" : "false", (unsigned long long)stats.calls,
+                  (unsigned long long)stats.chars, (unsigned long long)stats.rejected,
+                  (unsigned long long)stats.bytes_allocated);
+    result += line;
+    for (std::size_t s = 0; s < stats.stages.size(); s++) {
+        const LatencyHistogram& h = stats.stages[s];
+        std::uint64_t count = h.count();
+        std::snprintf(line, sizeof line,
+                      "    \"%s\": {\"count\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+                      "\"buckets\": [",
+                      stage_names[s], (unsigned long long)count, count ? double(h.total_ns) / count : 0.0,
+                      (unsigned long long)h.percentile(0.5), (unsigned long long)h.percentile(0.99));
+        result += line;
+        std::size_t used = LatencyHistogram::bucket_count;
+        while (used > 0 && h.buckets[used - 1] == 0)
+            used--;
+        for (std::size_t b = 0; b < used; b++)
+            result += (b ? ", " : "") + std::to_string(h.buckets[b]);
+        result += s + 1 < stats.stages.size() ? "]},\n" : "]}\n";
+    }
+    result += "  }\n}\n";
+    return result;
+}
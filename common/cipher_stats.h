@@ -0,0 +1,215 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file cipher_stats.h
+ * @brief Счётчики и гистограммы задержек горячих путей шифров
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Сбор включён по умолчанию и отключается при компиляции: -DCIPHER_STATS=0
+ * (в Makefile — make STATS=0). Тогда все методы записи пусты и вызовы
+ * удаляются компилятором, а снимок состоит из нулей.
+ */
+
+#ifndef CIPHER_STATS
+#define CIPHER_STATS 1
+#endif
+
+/**
+ * @brief Этап вызова шифра
+ */
+enum class CipherStage {
+    validate,  ///< Отдельный проход проверки и очистки текста
+    transform, ///< Преобразование (у modAlphaCipher вместе с проверкой и переводом в номера)
+    allocate   ///< Выделение памяти под результат
+};
+
+/**
+ * @brief Гистограмма задержек с корзинами по степеням двойки
+ * @details Корзина b содержит задержки от 2^(b-1) до 2^b - 1 нс, корзина 0 — нулевые
+ */
+struct LatencyHistogram {
+    static const std::size_t bucket_count = 40; ///< Последняя корзина — от 2^38 нс (~4.6 мин) и больше
+
+    std::array<std::uint64_t, bucket_count> buckets{}; ///< Количество замеров в корзинах
+    std::uint64_t total_ns = 0; ///< Сумма задержек
+
+    /**
+     * @brief Количество замеров
+     * @return Сумма по корзинам
+     */
+    std::uint64_t count() const;
+
+    /**
+     * @brief Оценка квантиля
+     * @param q - уровень от 0 до 1
+     * @return Верхняя граница корзины, в которую попадает квантиль, в наносекундах
+     */
+    std::uint64_t percentile(double q) const;
+};
+
+/**
+ * @brief Снимок статистики шифра
+ */
+struct CipherStatsSnapshot {
+    std::uint64_t calls = 0;           ///< Вызовы шифрования и дешифрования
+    std::uint64_t chars = 0;           ///< Обработанные единицы входа (символы или байты UTF-8)
+    std::uint64_t rejected = 0;        ///< Вызовы, отклонённые из-за ошибки во входе или ключе
+    std::uint64_t bytes_allocated = 0; ///< Байты, выделенные под результаты
+    std::array<LatencyHistogram, 3> stages; ///< Задержки по этапам (индекс — CipherStage)
+};
+
+/**
+ * @brief Счётчики одного шифра
+ * @details Счётчики — атомарные переменные с упорядочением relaxed: запись стоит
+ * несколько атомарных сложений на вызов (не на символ), и методы шифров остаются
+ * потокобезопасными. Снимок не атомарен целиком: счётчики читаются по очереди
+ */
+class CipherStats
+{
+public:
+    static constexpr bool enabled = CIPHER_STATS != 0; ///< Включён ли сбор при компиляции
+
+    CipherStats() = default;
+    CipherStats(const CipherStats&) = delete; ///< Счётчики не копируются
+    CipherStats& operator=(const CipherStats&) = delete; ///< Счётчики не копируются
+
+    /**
+     * @brief Учёт вызова
+     * @param chars - длина входа
+     */
+    void addCall(std::size_t chars)
+    {
+        if constexpr (enabled) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            this->chars.fetch_add(chars, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Учёт отклонённого вызова
+     */
+    void addRejected()
+    {
+        if constexpr (enabled)
+            rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Учёт выделения памяти
+     * @param bytes - размер выделенного буфера
+     */
+    void addAllocated(std::size_t bytes)
+    {
+        if constexpr (enabled)
+            bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Учёт задержки этапа
+     * @param stage - этап
+     * @param ns - задержка в наносекундах
+     */
+    void addLatency(CipherStage stage, std::uint64_t ns)
+    {
+        if constexpr (enabled) {
+            std::size_t b = 0;
+            while (b + 1 < LatencyHistogram::bucket_count && (ns >> b) != 0)
+                b++;
+            StageCounters& s = stages[static_cast<std::size_t>(stage)];
+            s.buckets[b].fetch_add(1, std::memory_order_relaxed);
+            s.total_ns.fetch_add(ns, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Снимок текущих значений
+     * @return Копия счётчиков и гистограмм
+     */
+    CipherStatsSnapshot snapshot() const;
+
+    /**
+     * @brief Обнуление всех счётчиков
+     */
+    void reset();
+
+private:
+    /**
+     * @brief Гистограмма одного этапа
+     */
+    struct StageCounters {
+        std::array<std::atomic<std::uint64_t>, LatencyHistogram::bucket_count> buckets{}; ///< Корзины
+        std::atomic<std::uint64_t> total_ns{0}; ///< Сумма задержек
+    };
+
+    std::atomic<std::uint64_t> calls{0}; ///< Вызовы
+    std::atomic<std::uint64_t> chars{0}; ///< Длина входов
+    std::atomic<std::uint64_t> rejected{0}; ///< Отклонённые вызовы
+    std::atomic<std::uint64_t> bytes_allocated{0}; ///< Выделенные байты
+    std::array<StageCounters, 3> stages; ///< Гистограммы этапов
+};
+
+/**
+ * @brief Замер этапа на время жизни объекта
+ * @details Задержка записывается в деструкторе или вызовом stop(). При CIPHER_STATS=0
+ * часы не читаются
+ */
+class StageTimer
+{
+public:
+    /**
+     * @brief Начало замера
+     * @param stats - счётчики шифра
+     * @param stage - этап
+     */
+    StageTimer(CipherStats& stats, CipherStage stage): stats(stats), stage(stage)
+    {
+        if constexpr (CipherStats::enabled)
+            start = std::chrono::steady_clock::now();
+    }
+
+    StageTimer(const StageTimer&) = delete; ///< Замер не копируется
+    StageTimer& operator=(const StageTimer&) = delete; ///< Замер не копируется
+
+    /**
+     * @brief Завершение замера, если stop() ещё не вызывался
+     */
+    ~StageTimer()
+    {
+        stop();
+    }
+
+    /**
+     * @brief Завершение замера
+     */
+    void stop()
+    {
+        if constexpr (CipherStats::enabled) {
+            if (stopped)
+                return;
+            stopped = true;
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            stats.addLatency(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+private:
+    CipherStats& stats; ///< Счётчики шифра
+    CipherStage stage; ///< Этап
+    std::chrono::steady_clock::time_point start; ///< Начало замера
+    bool stopped = false; ///< Замер уже записан
+};
+
+/**
+ * @brief Запись снимка в JSON
+ * @param name - имя шифра
+ * @param stats - снимок
+ * @return JSON-объект с счётчиками и гистограммами этапов (пустые корзины в конце опускаются)
+ */
+std::string formatStats(const std::string& name, const CipherStatsSnapshot& stats);
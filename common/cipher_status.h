@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include "cipher_error.h"
+
+/**
+ * @file cipher_status.h
+ * @brief Результат проверки и преобразования текста без исключений, общий для обоих шифров
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Методы try_* и check* возвращают cipher_status вместо выброса cipher_error.
+ * Это нужно для пакетной обработки, где часть записей заведомо некорректна
+ * и раскрутка стека на каждой ошибке обходится дороже самого шифрования.
+ * Бросающие методы шифров построены поверх этих методов и переводят результат
+ * в исключение функцией throwIfFailed(), так что у одной ошибки один текст во всех шифрах.
+ */
+
+/**
+ * @brief Вид ошибки
+ */
+enum class cipher_errc {
+    ok,                  ///< Ошибки нет
+    empty_key,           ///< Пустой ключ
+    invalid_key,         ///< Недопустимый символ ключа
+    key_not_positive,    ///< Числовой ключ равен нулю
+    key_too_large,       ///< Числовой ключ не помещается в int
+    empty_open_text,     ///< В открытом тексте нет букв
+    empty_cipher_text,   ///< Пустой шифртекст
+    invalid_cipher_text, ///< В шифртексте есть символ, не являющийся заглавной буквой
+    not_in_alphabet,     ///< Буква вне алфавита шифра
+    invalid_utf8,        ///< Некорректная последовательность UTF-8
+    buffer_too_small,    ///< Буфер вызывающей стороны мал для результата
+    invalid_range,       ///< Запрошенный отрезок выходит за границы текста
+    invalid_route        ///< Неизвестный маршрут или порядок столбцов не является перестановкой
+};
+
+/**
+ * @brief Результат операции: вид ошибки и позиция первого недопустимого символа
+ * @details Позиция отсчитывается от начала входных данных: в символах для широких строк
+ * и в байтах для UTF-8. Для ошибок, не связанных с конкретным символом
+ * (пустой текст, малый буфер), позиция равна 0.
+ */
+struct cipher_status {
+    cipher_errc error = cipher_errc::ok; ///< Вид ошибки
+    std::size_t offset = 0; ///< Позиция первого недопустимого символа
+
+    /**
+     * @brief Успешный результат
+     */
+    cipher_status() = default;
+
+    /**
+     * @brief Результат с ошибкой
+     * @param error - вид ошибки
+     * @param offset - позиция недопустимого символа
+     */
+    cipher_status(cipher_errc error, std::size_t offset = 0):
+        error(error), offset(offset) {}
+
+    /**
+     * @brief Проверка успеха
+     * @return true, если ошибки нет
+     */
+    bool ok() const
+    {
+        return error == cipher_errc::ok;
+    }
+
+    /**
+     * @brief Проверка успеха в условиях
+     * @return true, если ошибки нет
+     */
+    explicit operator bool() const
+    {
+        return ok();
+    }
+};
+
+/**
+ * @brief Текст исключения для вида ошибки
+ * @param error - вид ошибки
+ * @return Сообщение cipher_error
+ */
+inline const char* statusMessage(cipher_errc error)
+{
+    switch (error) {
+    case cipher_errc::ok:
+        return "No error";
+    case cipher_errc::empty_key:
+        return "Empty key";
+    case cipher_errc::invalid_key:
+        return "Invalid key";
+    case cipher_errc::key_not_positive:
+        return "Key must be greater than 0";
+    case cipher_errc::key_too_large:
+        return "Key is too large";
+    case cipher_errc::empty_open_text:
+        return "Empty open text";
+    case cipher_errc::empty_cipher_text:
+        return "Empty cipher text";
+    case cipher_errc::invalid_cipher_text:
+        return "Invalid cipher text - must contain only uppercase letters";
+    case cipher_errc::not_in_alphabet:
+        return "Character is not in alphabet";
+    case cipher_errc::invalid_utf8:
+        return "Invalid UTF-8";
+    case cipher_errc::buffer_too_small:
+        return "Output buffer is too small";
+    case cipher_errc::invalid_range:
+        return "Invalid range";
+    case cipher_errc::invalid_route:
+        return "Invalid route - expected N, order:PERMUTATION, snake:N or spiral:N";
+    }
+    return "Unknown error";
+}
+
+/**
+ * @brief Перевод результата в исключение для бросающих методов
+ * @param status - результат метода try_* или check*
+ * @throw cipher_error если результат содержит ошибку
+ */
+inline void throwIfFailed(const cipher_status& status)
+{
+    if (!status)
+        throw cipher_error(statusMessage(status.error));
+}
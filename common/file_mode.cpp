@@ -0,0 +1,133 @@
+#include "file_mode.h"
+#include "mapped_file.h"
+#include "size_arg.h"
+#include <stdexcept>
+
+/**
+ * @file file_mode.cpp
+ * @brief Реализация неинтерактивного режима обработки файлов
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Разбор командной строки файлового режима
+ * @param argc - количество аргументов
+ * @param argv - аргументы
+ * @return Задание на обработку
+ * @throw std::invalid_argument если аргументы неверны
+ */
+FileJob parseFileJob(int argc, char* argv[])
+{
+    if (argc < 2)
+        throw std::invalid_argument("missing command");
+    FileJob job;
+    std::string command = argv[1];
+    if (command == "enc")
+        job.encrypt = true;
+    else if (command == "dec")
+        job.encrypt = false;
+    else
+        throw std::invalid_argument("unknown command: " + command);
+
+    bool has_key = false;
+    std::string positional[2];
+    int count = 0;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--key" || arg == "-k") {
+            if (++i == argc)
+                throw std::invalid_argument("missing value for " + arg);
+            job.key = argv[i];
+            has_key = true;
+        } else if (arg.compare(0, 6, "--key=") == 0) {
+            job.key = arg.substr(6);
+            has_key = true;
+        } else if (arg == "--memory" || arg == "-m") {
+            if (++i == argc)
+                throw std::invalid_argument("missing value for " + arg);
+            job.memory_budget = parseSize(argv[i]);
+        } else if (arg.compare(0, 9, "--memory=") == 0) {
+            job.memory_budget = parseSize(arg.substr(9));
+        } else if (arg == "--stats") {
+            job.stats = true;
+        } else if (arg == "--pipeline") {
+            job.pipeline = true;
+        } else if (arg == "--io" || arg.compare(0, 5, "--io=") == 0) {
+            std::string value;
+            if (arg == "--io") {
+                if (++i == argc)
+                    throw std::invalid_argument("missing value for " + arg);
+                value = argv[i];
+            } else {
+                value = arg.substr(5);
+            }
+            if (value == "auto")
+                job.io = IoBackend::automatic;
+            else if (value == "uring")
+                job.io = IoBackend::uring;
+            else if (value == "plain")
+                job.io = IoBackend::plain;
+            else
+                throw std::invalid_argument("unknown io backend: " + value);
+            job.pipeline = true;
+        } else if (count < 2) {
+            positional[count++] = arg;
+        } else {
+            throw std::invalid_argument("unexpected argument: " + arg);
+        }
+    }
+    if (!has_key)
+        throw std::invalid_argument("missing --key");
+    if (count < 2)
+        throw std::invalid_argument("missing input or output file");
+    job.input = positional[0];
+    job.output = positional[1];
+    return job;
+}
+
+/**
+ * @brief Справка по файловому режиму
+ * @param program - имя программы
+ * @param key_hint - описание ключа
+ * @return Текст справки
+ */
+std::string fileModeUsage(const std::string& program, const std::string& key_hint)
+{
+    return "Использование: " + program + " enc|dec --key КЛЮЧ [--memory РАЗМЕР] [--stats] [--pipeline]\n"
+           "       [--io auto|uring|plain] ВХОД ВЫХОД\n"
+           "  КЛЮЧ    " + key_hint + "\n"
+           "  РАЗМЕР  ограничение памяти с суффиксом K, M или G (для шифров, которым нужен весь текст)\n"
+           "  --stats  напечатать счётчики и гистограммы задержек шифра в JSON\n"
+           "  --pipeline  читать, шифровать и записывать блоками одновременно в трёх потоках.\n"
+           "          Шифры, которым нужен весь текст, при этом обрабатывают каждую строку отдельно:\n"
+           "          такой файл расшифровывается только с --pipeline, а файл без него - только без него\n"
+           "  --io     ввод-вывод конвейера: io_uring, pread/pwrite или auto (включает --pipeline)\n"
+           "  ВХОД    текстовый файл в UTF-8\n"
+           "  ВЫХОД   файл для результата в UTF-8\n"
+           "Без аргументов программа запускается в интерактивном режиме.\n";
+}
+
+/**
+ * @brief Выполнение задания
+ * @param job - задание
+ * @param transform - преобразование шифра; результат не длиннее входа
+ * @return Длина результата в байтах
+ */
+std::size_t runFileJob(const FileJob& job, const FileTransform& transform)
+{
+    checkDistinctFiles(job.input, job.output);
+    MappedFile in(job.input);
+    std::size_t n = in.size();
+    if (!job.encrypt) {
+        if (n > 0 && in.data()[n - 1] == '\n')
+            n--;
+        if (n > 0 && in.data()[n - 1] == '\r')
+            n--;
+    }
+    MappedOutput out(job.output, n);
+    std::size_t written = transform(in.data(), n, out.data(), out.size());
+    out.commit(written);
+    return written;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include "async_io.h"
+
+/**
+ * @file file_mode.h
+ * @brief Неинтерактивный режим обработки файлов, общий для обоих шифров
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Командная строка: <программа> enc|dec --key КЛЮЧ [--memory РАЗМЕР] [--stats]
+ * [--pipeline] [--io auto|uring|plain] ВХОД ВЫХОД.
+ * Входной файл в UTF-8 отображается в память, выходной создаётся с размером
+ * входного, отображается в память и после преобразования обрезается до длины результата.
+ * Ограничение памяти нужно шифрам, которым для преобразования нужен весь текст.
+ * С --stats после обработки в стандартный вывод печатается статистика шифра в JSON.
+ * С --pipeline файл читается, преобразуется и записывается блоками в трёх потоках;
+ * --io выбирает способ ввода-вывода конвейера и включает его. Шифр, которому нужен
+ * весь текст, в конвейере преобразует каждую строку отдельно, поэтому его результаты
+ * с --pipeline и без него несовместимы между собой.
+ */
+
+/**
+ * @brief Задание на обработку файла
+ */
+struct FileJob {
+    bool encrypt = true; ///< true - шифрование, false - дешифрование
+    std::string key; ///< Ключ в UTF-8
+    std::string input; ///< Путь к входному файлу
+    std::string output; ///< Путь к выходному файлу
+    std::size_t memory_budget = 0; ///< Ограничение памяти в байтах (0 - без ограничения)
+    bool stats = false; ///< Печатать статистику шифра после обработки
+    bool pipeline = false; ///< Конвейерная обработка (см. file_pipeline.h) вместо отображения в память
+    IoBackend io = IoBackend::automatic; ///< Ввод-вывод конвейера
+};
+
+/**
+ * @brief Преобразование буфера UTF-8: (вход, длина, выход, ёмкость) → длина результата
+ */
+typedef std::function<std::size_t(const char*, std::size_t, char*, std::size_t)> FileTransform;
+
+/**
+ * @brief Разбор командной строки файлового режима
+ * @param argc - количество аргументов
+ * @param argv - аргументы
+ * @return Задание на обработку
+ * @throw std::invalid_argument если аргументы неверны
+ */
+FileJob parseFileJob(int argc, char* argv[]);
+
+/**
+ * @brief Справка по файловому режиму
+ * @param program - имя программы
+ * @param key_hint - описание ключа
+ * @return Текст справки
+ */
+std::string fileModeUsage(const std::string& program, const std::string& key_hint);
+
+/**
+ * @brief Выполнение задания
+ * @param job - задание
+ * @param transform - преобразование шифра; результат не длиннее входа
+ * @return Длина результата в байтах
+ * @throw std::system_error при ошибке ввода-вывода или если ВЫХОД - тот же файл, что ВХОД
+ * @throw cipher_error при ошибке шифрования (прежнее содержимое выходного файла в этом случае сохраняется)
+ * @details При дешифровании завершающий перевод строки входного файла не считается
+ * частью шифртекста
+ */
+std::size_t runFileJob(const FileJob& job, const FileTransform& transform);
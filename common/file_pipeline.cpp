@@ -0,0 +1,585 @@
+#include "file_pipeline.h"
+#include "async_io.h"
+#include "mapped_file.h"
+#include "letters.h"
+#include "utf8.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file file_pipeline.cpp
+ * @brief Реализация конвейерной обработки файлов
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+static const std::size_t headroom = 16; ///< Место перед данными входного блока для хвоста предыдущего блока
+
+/**
+ * @brief Блок данных конвейера
+ */
+struct PipelineBlock {
+    std::vector<char> buffer; ///< Память блока (у входного блока данные начинаются после headroom байтов)
+    std::size_t size = 0; ///< Длина данных в байтах
+    unsigned long long offset = 0; ///< Смещение данных в файле
+    std::size_t done = 0; ///< Байты, уже прочитанные или записанные
+    bool ready = false; ///< Чтение блока завершено
+    IoRequest request; ///< Текущая операция ввода-вывода блока
+};
+
+/**
+ * @brief Кольцевая очередь ограниченной длины между двумя потоками
+ * @tparam T - тип элемента
+ * @details push() ждёт свободного места, pop() - элемента. После close() оставшиеся
+ * элементы ещё выдаются, после abort() все операции сразу возвращают false
+ */
+template <class T>
+class RingQueue
+{
+public:
+    /**
+     * @brief Создание очереди
+     * @param capacity - наибольшее количество элементов
+     */
+    explicit RingQueue(std::size_t capacity): items(capacity) {}
+
+    /**
+     * @brief Добавление элемента с ожиданием свободного места
+     * @param item - элемент
+     * @return false если очередь закрыта или прервана
+     */
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [&] { return closed || count < items.size(); });
+        if (closed)
+            return false;
+        items[(head + count) % items.size()] = item;
+        count++;
+        not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Извлечение элемента с ожиданием
+     * @param item - извлечённый элемент
+     * @return false если очередь закрыта и пуста или прервана
+     */
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [&] { return closed || aborted || count > 0; });
+        return take(item);
+    }
+
+    /**
+     * @brief Извлечение элемента без ожидания
+     * @param item - извлечённый элемент
+     * @return false если очередь пуста или прервана
+     */
+    bool tryPop(T& item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return take(item);
+    }
+
+    /**
+     * @brief Конец данных: новых элементов не будет
+     */
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    /**
+     * @brief Прерывание: ожидающие и последующие вызовы возвращают false
+     */
+    void abort()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = aborted = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    std::vector<T> items; ///< Кольцо элементов
+    std::size_t head = 0; ///< Индекс первого элемента
+    std::size_t count = 0; ///< Количество элементов
+    bool closed = false; ///< Новых элементов не будет
+    bool aborted = false; ///< Очередь прервана
+    std::mutex mutex; ///< Защита кольца
+    std::condition_variable not_empty; ///< Появился элемент или очередь закрыта
+    std::condition_variable not_full; ///< Освободилось место или очередь закрыта
+
+    /**
+     * @brief Извлечение первого элемента (вызывается под mutex)
+     * @param item - извлечённый элемент
+     * @return false если очередь пуста или прервана
+     */
+    bool take(T& item)
+    {
+        if (aborted || count == 0)
+            return false;
+        item = items[head];
+        head = (head + 1) % items.size();
+        count--;
+        not_full.notify_one();
+        return true;
+    }
+};
+
+/**
+ * @brief Исключение с текущим errno и именем файла
+ * @param path - путь к файлу
+ * @return Исключение для выброса
+ */
+static std::system_error fileError(const std::string& path)
+{
+    return std::system_error(errno, std::generic_category(), path);
+}
+
+/**
+ * @brief Граница, до которой часть потока можно преобразовать сейчас
+ * @param p - данные
+ * @param n - длина данных
+ * @param hold_newlines - придержать завершающие \\r и \\n (при дешифровании они могут оказаться концом файла)
+ * @return Длина префикса без незавершённого символа UTF-8 в конце; остаток переносится в следующий блок
+ */
+static std::size_t streamCut(const char* p, std::size_t n, bool hold_newlines)
+{
+    std::size_t cut = n;
+    for (int k = 0; hold_newlines && k < 2 && cut > 0 && (p[cut - 1] == '\n' || p[cut - 1] == '\r'); k++)
+        cut--;
+    return utf8CompletePrefix(p, cut);
+}
+
+/**
+ * @brief Проверка, есть ли в строке буквы
+ * @param p - строка
+ * @param n - длина строки
+ * @return true если есть буква или некорректный UTF-8 (о нём сообщит шифр)
+ */
+static bool hasLetters(const char* p, std::size_t n)
+{
+    for (std::size_t i = 0; i < n;) {
+        char32_t c;
+        std::size_t k = utf8Decode(p + i, n - i, c);
+        if (k == 0 || isLetter(c))
+            return true;
+        i += k;
+    }
+    return false;
+}
+
+/**
+ * @brief Конвейер чтение - преобразование - запись для одного задания
+ */
+class FilePipeline
+{
+public:
+    /**
+     * @brief Открытие файлов и выделение блоков
+     * @param job - задание
+     * @param framing - разбиение входа
+     * @param transform - преобразование шифра
+     * @param finish - проверка после последней части (может быть пустой)
+     * @throw std::system_error если файл не удалось открыть или выходной файл совпадает с входным
+     */
+    FilePipeline(const FileJob& job, FileFraming framing, const FileTransform& transform,
+                 const std::function<void()>& finish):
+        job(job), framing(framing), transform(transform), finish(finish),
+        filled(pipeline_depth), free_in(pipeline_depth), done(pipeline_depth), free_out(pipeline_depth)
+    {
+        if (job.memory_budget > 0)
+            block_size = std::max<std::size_t>(job.memory_budget / (2 * pipeline_depth), 4096);
+        checkDistinctFiles(job.input, job.output);
+        in_fd = ::open(job.input.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in_fd < 0)
+            throw fileError(job.input);
+        struct stat st;
+        if (::fstat(in_fd, &st) < 0) {
+            std::system_error e = fileError(job.input);
+            ::close(in_fd);
+            throw e;
+        }
+        length = st.st_size;
+        ::posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        try {
+            out.reset(new OutputFile(job.output));
+        } catch (...) {
+            ::close(in_fd);
+            throw;
+        }
+        out_fd = out->fd();
+
+        blocks.resize(2 * pipeline_depth);
+        for (unsigned i = 0; i < pipeline_depth; i++) {
+            blocks[i].buffer.resize(headroom + block_size);
+            free_in.push(&blocks[i]);
+            blocks[pipeline_depth + i].buffer.resize(headroom + block_size);
+            free_out.push(&blocks[pipeline_depth + i]);
+        }
+    }
+
+    /**
+     * @brief Закрытие файлов
+     */
+    ~FilePipeline()
+    {
+        ::close(in_fd);
+    }
+
+    FilePipeline(const FilePipeline&) = delete; ///< Конвейер не копируется
+    FilePipeline& operator=(const FilePipeline&) = delete; ///< Конвейер не копируется
+
+    /**
+     * @brief Выполнение задания
+     * @return Длина результата в байтах
+     * @throw std::system_error при ошибке ввода-вывода
+     * @throw cipher_error при ошибке шифрования (прежнее содержимое выходного файла сохраняется)
+     * @details Чтение и запись идут в отдельных потоках, преобразование - в вызывающем
+     */
+    std::size_t run()
+    {
+        std::thread reader(&FilePipeline::guarded, this, &FilePipeline::readLoop);
+        std::thread writer(&FilePipeline::guarded, this, &FilePipeline::writeLoop);
+        guarded(&FilePipeline::transformLoop);
+        reader.join();
+        writer.join();
+        if (!error) {
+            try {
+                out->commit();
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        out_fd = -1;
+        if (error)
+            std::rethrow_exception(error);
+        return produced;
+    }
+
+private:
+    const FileJob& job; ///< Задание
+    FileFraming framing; ///< Разбиение входа
+    const FileTransform& transform; ///< Преобразование шифра
+    const std::function<void()>& finish; ///< Проверка после последней части
+    std::size_t block_size = pipeline_block_size; ///< Размер блока
+    int in_fd = -1; ///< Входной файл
+    std::unique_ptr<OutputFile> out; ///< Выходной файл; без commit() цель не меняется
+    int out_fd = -1; ///< Дескриптор выходного файла
+    unsigned long long length = 0; ///< Длина входного файла
+    std::size_t produced = 0; ///< Длина результата
+    std::vector<PipelineBlock> blocks; ///< Все блоки: входные, затем выходные
+    RingQueue<PipelineBlock*> filled; ///< Прочитанные блоки: чтение → преобразование
+    RingQueue<PipelineBlock*> free_in; ///< Освобождённые входные блоки: преобразование → чтение
+    RingQueue<PipelineBlock*> done; ///< Результаты: преобразование → запись
+    RingQueue<PipelineBlock*> free_out; ///< Записанные выходные блоки: запись → преобразование
+    std::mutex error_mutex; ///< Защита error
+    std::exception_ptr error; ///< Первая ошибка любой стадии
+    std::atomic<bool> failed{false}; ///< Одна из стадий завершилась ошибкой
+
+    /**
+     * @brief Запуск стадии с перехватом ошибки
+     * @param stage - метод стадии
+     * @details Ошибка запоминается, а все очереди прерываются, чтобы остальные стадии завершились
+     */
+    void guarded(void (FilePipeline::*stage)())
+    {
+        try {
+            (this->*stage)();
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+            failed = true;
+            filled.abort();
+            free_in.abort();
+            done.abort();
+            free_out.abort();
+        }
+    }
+
+    /**
+     * @brief Постановка операции ввода-вывода для оставшейся части блока
+     * @param io - очередь ввода-вывода
+     * @param block - блок
+     * @param fd - файл
+     * @param write - true для записи
+     * @param data - начало данных блока
+     */
+    static void submitRest(IoQueue& io, PipelineBlock* block, int fd, bool write, char* data)
+    {
+        block->request.fd = fd;
+        block->request.write = write;
+        block->request.data = data + block->done;
+        block->request.size = block->size - block->done;
+        block->request.offset = block->offset + block->done;
+        block->request.owner = block;
+        io.submit(&block->request);
+    }
+
+    /**
+     * @brief Стадия чтения
+     * @throw std::system_error при ошибке чтения или если файл укоротился
+     * @details Держит в IoQueue до pipeline_depth чтений и передаёт блоки дальше строго
+     * в порядке файла, даже если io_uring завершил их в другом порядке
+     */
+    void readLoop()
+    {
+        IoQueue io(pipeline_depth, job.io);
+        std::deque<PipelineBlock*> reading;
+        unsigned long long next = 0;
+        for (;;) {
+            PipelineBlock* block;
+            while (next < length && (reading.empty() ? free_in.pop(block) : free_in.tryPop(block))) {
+                block->offset = next;
+                block->size = std::min<unsigned long long>(block_size, length - next);
+                block->done = 0;
+                block->ready = false;
+                submitRest(io, block, in_fd, false, block->buffer.data() + headroom);
+                reading.push_back(block);
+                next += block->size;
+            }
+            if (reading.empty())
+                break;
+            while (!reading.front()->ready) {
+                IoRequest* request = io.wait();
+                block = static_cast<PipelineBlock*>(request->owner);
+                if (request->result < 0)
+                    throw std::system_error(-request->result, std::generic_category(), job.input);
+                if (request->result == 0)
+                    throw std::system_error(EIO, std::generic_category(), job.input);
+                block->done += request->result;
+                if (block->done < block->size)
+                    submitRest(io, block, in_fd, false, block->buffer.data() + headroom);
+                else
+                    block->ready = true;
+            }
+            block = reading.front();
+            reading.pop_front();
+            if (!filled.push(block))
+                break;
+        }
+        filled.close();
+    }
+
+    /**
+     * @brief Стадия записи
+     * @throw std::system_error при ошибке записи
+     */
+    void writeLoop()
+    {
+        IoQueue io(pipeline_depth, job.io);
+        unsigned long long next = 0;
+        for (;;) {
+            PipelineBlock* block;
+            if (io.pending() == 0 ? done.pop(block) : done.tryPop(block)) {
+                if (block->size == 0) {
+                    free_out.push(block);
+                    continue;
+                }
+                block->offset = next;
+                block->done = 0;
+                submitRest(io, block, out_fd, true, block->buffer.data());
+                next += block->size;
+                continue;
+            }
+            if (io.pending() == 0)
+                break;
+            IoRequest* request = io.wait();
+            block = static_cast<PipelineBlock*>(request->owner);
+            if (request->result < 0)
+                throw std::system_error(-request->result, std::generic_category(), job.output);
+            if (request->result == 0)
+                throw std::system_error(EIO, std::generic_category(), job.output);
+            block->done += request->result;
+            if (block->done < block->size)
+                submitRest(io, block, out_fd, true, block->buffer.data());
+            else
+                free_out.push(block);
+        }
+    }
+
+    /**
+     * @brief Стадия преобразования
+     * @throw cipher_error при ошибке шифрования
+     */
+    void transformLoop()
+    {
+        if (framing == FileFraming::stream)
+            transformStream();
+        else
+            transformRecords();
+    }
+
+    /**
+     * @brief Получение свободного выходного блока
+     * @return Блок или nullptr, если конвейер прерван
+     */
+    PipelineBlock* outputBlock()
+    {
+        PipelineBlock* block;
+        if (!free_out.pop(block))
+            return nullptr;
+        block->size = 0;
+        return block;
+    }
+
+    /**
+     * @brief Преобразование потока
+     * @details Незавершённый символ UTF-8 в конце блока (а при дешифровании и завершающие
+     * \\r, \\n) переносится в headroom следующего блока. Остаток после последнего блока
+     * обрабатывается как конец файла
+     */
+    void transformStream()
+    {
+        char carry[headroom];
+        std::size_t carry_len = 0;
+        PipelineBlock* in;
+        while (filled.pop(in)) {
+            char* begin = in->buffer.data() + headroom - carry_len;
+            std::memcpy(begin, carry, carry_len);
+            std::size_t n = in->size + carry_len;
+            std::size_t cut = streamCut(begin, n, !job.encrypt);
+            carry_len = n - cut;
+            std::memcpy(carry, begin + cut, carry_len);
+            PipelineBlock* out = outputBlock();
+            if (!out)
+                return;
+            if (cut > 0)
+                out->size = transform(begin, cut, out->buffer.data(), out->buffer.size());
+            produced += out->size;
+            if (!free_in.push(in) || !done.push(out))
+                return;
+        }
+        if (failed)
+            return;
+
+        std::size_t n = carry_len;
+        if (!job.encrypt && n > 0 && carry[n - 1] == '\n')
+            n--;
+        if (!job.encrypt && n > 0 && carry[n - 1] == '\r')
+            n--;
+        if (n > 0) {
+            PipelineBlock* out = outputBlock();
+            if (!out)
+                return;
+            out->size = transform(carry, n, out->buffer.data(), out->buffer.size());
+            produced += out->size;
+            if (!done.push(out))
+                return;
+        }
+        if (finish)
+            finish();
+        done.close();
+    }
+
+    /**
+     * @brief Преобразование одной записи
+     * @param record - строка без \\n
+     * @param n - длина строки
+     * @param newline - строка завершалась \\n
+     * @param out - выходной блок; при нехватке места расширяется
+     * @details При шифровании строка без букв, как и пустая, даёт пустую запись
+     */
+    void emitRecord(const char* record, std::size_t n, bool newline, PipelineBlock* out)
+    {
+        if (n > 0 && record[n - 1] == '\r')
+            n--;
+        if (out->buffer.size() < out->size + n + 1)
+            out->buffer.resize(std::max(out->size + n + 1, 2 * out->buffer.size()));
+        if (n > 0 && (!job.encrypt || hasLetters(record, n)))
+            out->size += transform(record, n, out->buffer.data() + out->size, out->buffer.size() - out->size);
+        if (newline)
+            out->buffer[out->size++] = '\n';
+    }
+
+    /**
+     * @brief Преобразование по строкам
+     * @details Строки, целиком лежащие в блоке, преобразуются на месте; строка,
+     * пересекающая границу блоков, собирается в pending
+     */
+    void transformRecords()
+    {
+        std::string pending;
+        PipelineBlock* in;
+        while (filled.pop(in)) {
+            PipelineBlock* out = outputBlock();
+            if (!out)
+                return;
+            const char* p = in->buffer.data() + headroom;
+            std::size_t pos = 0;
+            while (pos < in->size) {
+                const void* nl = std::memchr(p + pos, '\n', in->size - pos);
+                if (!nl) {
+                    pending.append(p + pos, in->size - pos);
+                    break;
+                }
+                std::size_t end = static_cast<const char*>(nl) - p;
+                if (pending.empty()) {
+                    emitRecord(p + pos, end - pos, true, out);
+                } else {
+                    pending.append(p + pos, end - pos);
+                    emitRecord(pending.data(), pending.size(), true, out);
+                    pending.clear();
+                }
+                pos = end + 1;
+            }
+            produced += out->size;
+            if (!free_in.push(in) || !done.push(out))
+                return;
+        }
+        if (failed)
+            return;
+
+        if (!pending.empty()) {
+            PipelineBlock* out = outputBlock();
+            if (!out)
+                return;
+            emitRecord(pending.data(), pending.size(), false, out);
+            produced += out->size;
+            if (!done.push(out))
+                return;
+        }
+        if (finish)
+            finish();
+        done.close();
+    }
+};
+
+/**
+ * @brief Конвейерное выполнение задания
+ * @param job - задание
+ * @param framing - разбиение входа
+ * @param transform - преобразование шифра
+ * @param finish - проверка после последней части (может быть пустой)
+ * @return Длина результата в байтах
+ */
+std::size_t runPipelinedFileJob(const FileJob& job, FileFraming framing, const FileTransform& transform,
+                                const std::function<void()>& finish)
+{
+    FilePipeline pipeline(job, framing, transform, finish);
+    return pipeline.run();
+}
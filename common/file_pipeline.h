@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include "file_mode.h"
+
+/**
+ * @file file_pipeline.h
+ * @brief Заголовочный файл конвейерной обработки файлов
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Чтение, преобразование и запись выполняются тремя потоками, связанными
+ * кольцевыми очередями блоков ограниченной длины: пока шифр обрабатывает один блок,
+ * следующий уже читается, а предыдущий записывается. Память ограничена числом блоков
+ * (pipeline_depth входных и столько же выходных). Чтение и запись идут через IoQueue
+ * (см. async_io.h): с io_uring в ядре одновременно находится несколько операций.
+ */
+
+/**
+ * @brief Разбиение входа на части для преобразования
+ */
+enum class FileFraming {
+    stream, ///< Поток: части режутся по границам символов UTF-8, шифр хранит состояние между частями
+    records ///< Записи: каждая строка преобразуется целиком и независимо от остальных
+};
+
+static const std::size_t pipeline_block_size = std::size_t(1) << 20; ///< Размер блока по умолчанию
+static const unsigned pipeline_depth = 4; ///< Количество блоков в каждой очереди
+
+/**
+ * @brief Конвейерное выполнение задания
+ * @param job - задание; job.memory_budget ограничивает суммарный размер блоков, job.io задаёт ввод-вывод
+ * @param framing - разбиение входа
+ * @param transform - преобразование шифра; результат не длиннее входа.
+ * Вызывается из одного потока последовательно, в порядке частей файла
+ * @param finish - проверка после последней части (может быть пустой); исключение считается ошибкой задания
+ * @return Длина результата в байтах
+ * @throw std::system_error при ошибке ввода-вывода или если выходной файл совпадает с входным
+ * @throw cipher_error при ошибке шифрования (прежнее содержимое выходного файла в этом случае сохраняется)
+ * @details В потоковом режиме при дешифровании завершающий перевод строки входного файла
+ * не считается частью шифртекста, как в runFileJob(). В режиме записей каждая строка
+ * без завершающих \\r и \\n передаётся transform отдельно, пустые строки и (при шифровании)
+ * строки без букв дают пустую запись, а после результата строки, завершённой \\n,
+ * пишется \\n. Строка длиннее блока собирается в памяти целиком
+ */
+std::size_t runPipelinedFileJob(const FileJob& job, FileFraming framing, const FileTransform& transform,
+                                const std::function<void()>& finish = nullptr);
@@ -0,0 +1,163 @@
+#include "letters.h"
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @file letters.cpp
+ * @brief Проверка и очистка участков широкого текста
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details На x86 (SSE2 входит в базовый набор x86-64) символы обрабатываются по 4:
+ * принадлежность диапазону [lo, lo + width) проверяется одним сравнением
+ * (c - lo) < width; беззнаковое сравнение 32-битных чисел, которого нет в SSE2,
+ * заменяется знаковым после инверсии старшего бита. Группа, в которой все символы —
+ * буквы, обрабатывается целиком, прочие группы и хвост — поштучно по таблице
+ * из letters.h. Результат совпадает со скалярными isLetter/toUpperLetter.
+ */
+
+#ifdef __SSE2__
+
+/**
+ * @brief Маска символов из диапазона [lo, lo + width)
+ * @param c - 4 символа
+ * @param lo - начало диапазона
+ * @param width - ширина диапазона
+ * @return Все единицы в элементах, попавших в диапазон
+ */
+static inline __m128i inRange(__m128i c, unsigned lo, unsigned width)
+{
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    __m128i d = _mm_xor_si128(_mm_sub_epi32(c, _mm_set1_epi32(static_cast<int>(lo))), bias);
+    return _mm_cmplt_epi32(d, _mm_set1_epi32(static_cast<int>(width ^ 0x80000000u)));
+}
+
+/**
+ * @brief Маска заглавных букв
+ * @param c - 4 символа
+ * @return Все единицы в элементах, содержащих заглавную букву
+ */
+static inline __m128i upperMask(__m128i c)
+{
+    return _mm_or_si128(inRange(c, 'A', 26), inRange(c, 0x400, 0x30));
+}
+
+/**
+ * @brief Маска букв
+ * @param c - 4 символа
+ * @return Все единицы в элементах, содержащих букву
+ */
+static inline __m128i letterMask(__m128i c)
+{
+    return _mm_or_si128(inRange(_mm_or_si128(c, _mm_set1_epi32(0x20)), 'a', 26), inRange(c, 0x400, 0x60));
+}
+
+/**
+ * @brief Перевод 4 букв в верхний регистр
+ * @param c - 4 буквы
+ * @return Заглавные формы: a..z и а..я сдвигаются на 0x20, ѐ..џ — на 0x50
+ */
+static inline __m128i toUpper(__m128i c)
+{
+    __m128i lower = _mm_or_si128(inRange(c, 'a', 26), inRange(c, 0x430, 0x20));
+    __m128i delta = _mm_or_si128(_mm_and_si128(lower, _mm_set1_epi32(0x20)),
+                                 _mm_and_si128(inRange(c, 0x450, 0x10), _mm_set1_epi32(0x50)));
+    return _mm_sub_epi32(c, delta);
+}
+
+#endif
+
+/**
+ * @brief Длина начала текста, состоящего из заглавных букв
+ * @param text - текст
+ * @param n - длина текста
+ * @return Позиция первого символа, не являющегося заглавной буквой, или n
+ */
+std::size_t upperLetterSpan(const wchar_t* text, std::size_t n)
+{
+    std::size_t i = 0;
+#ifdef __SSE2__
+    if constexpr (sizeof(wchar_t) == 4) {
+        for (; i + 8 <= n; i += 8) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + 4));
+            if (_mm_movemask_epi8(_mm_and_si128(upperMask(a), upperMask(b))) != 0xFFFF)
+                break;
+        }
+    }
+#endif
+    while (i < n && isUpperLetter(text[i]))
+        i++;
+    return i;
+}
+
+/**
+ * @brief Подсчёт букв
+ * @param text - текст
+ * @param n - длина текста
+ * @return Количество букв в тексте
+ */
+std::size_t letterCount(const wchar_t* text, std::size_t n)
+{
+    std::size_t count = 0;
+    std::size_t i = 0;
+#ifdef __SSE2__
+    if constexpr (sizeof(wchar_t) == 4) {
+        // Маска элемента — -1, поэтому вычитание масок считает буквы. Суммы сбрасываются
+        // в count каждые chunk символов, чтобы 32-битные элементы не переполнялись
+        const std::size_t chunk = std::size_t(1) << 20;
+        while (n - i >= 4) {
+            const std::size_t end = i + (std::min(n - i, chunk) & ~std::size_t(3));
+            __m128i sum = _mm_setzero_si128();
+            for (; i < end; i += 4) {
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+                sum = _mm_sub_epi32(sum, letterMask(c));
+            }
+            alignas(16) unsigned lanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+            count += std::size_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+        }
+    }
+#endif
+    for (; i < n; i++)
+        count += isLetter(text[i]);
+    return count;
+}
+
+/**
+ * @brief Очистка текста от не-букв с переводом в верхний регистр
+ * @param in - исходный текст
+ * @param n - длина текста
+ * @param out - буфер для букв (не меньше letterCount(in, n)); может совпадать с in
+ * @return Количество записанных букв
+ * @details Запись никогда не опережает чтение, поэтому очистка на месте безопасна
+ */
+std::size_t foldLetters(const wchar_t* in, std::size_t n, wchar_t* out)
+{
+    std::size_t length = 0;
+    std::size_t i = 0;
+#ifdef __SSE2__
+    if constexpr (sizeof(wchar_t) == 4) {
+        for (; i + 4 <= n; i += 4) {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            if (_mm_movemask_epi8(letterMask(c)) == 0xFFFF) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + length), toUpper(c));
+                length += 4;
+                continue;
+            }
+            for (std::size_t k = i; k < i + 4; k++) {
+                if (isLetter(in[k]))
+                    out[length++] = toUpperLetter(in[k]);
+            }
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (isLetter(in[i]))
+            out[length++] = toUpperLetter(in[i]);
+    }
+    return length;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @file letters.h
+ * @brief Классификация и перевод в верхний регистр букв без участия локали
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Поддерживаются буквы латиницы ASCII и основной части кириллицы
+ * (U+0400..U+045F: русский алфавит, Ё, а также буквы украинского, белорусского,
+ * сербского и македонского алфавитов). Прочие символы буквами не считаются.
+ * Классы и заглавные формы символов U+0000..U+045F берутся из таблицы, построенной
+ * при компиляции, поэтому результат не зависит от std::locale и setlocale и
+ * одинаков на всех системах. Для широких строк есть функции, проверяющие и
+ * переводящие в верхний регистр целые участки текста (на x86 — по 4 символа SSE2).
+ */
+
+/**
+ * @brief Таблица классов и заглавных форм символов U+0000..U+045F
+ */
+struct LetterTable {
+    static const std::size_t size = 0x460; ///< Количество символов в таблице
+
+    unsigned char kind[size];  ///< 0 — не буква, 1 — строчная буква, 2 — заглавная буква
+    char16_t upper[size];      ///< Заглавная форма буквы или сам символ
+};
+
+/**
+ * @brief Построение таблицы букв
+ * @return Таблица для латиницы ASCII и кириллицы U+0400..U+045F
+ */
+constexpr LetterTable makeLetterTable()
+{
+    LetterTable table{};
+    for (std::size_t c = 0; c < LetterTable::size; c++) {
+        table.kind[c] = 0;
+        table.upper[c] = static_cast<char16_t>(c);
+    }
+    for (std::size_t c = 'A'; c <= 'Z'; c++) {
+        table.kind[c] = 2;
+        table.kind[c + 0x20] = 1;
+        table.upper[c + 0x20] = static_cast<char16_t>(c);
+    }
+    for (std::size_t c = 0x400; c < 0x430; c++)
+        table.kind[c] = 2;
+    for (std::size_t c = 0x430; c < 0x450; c++) {
+        table.kind[c] = 1;
+        table.upper[c] = static_cast<char16_t>(c - 0x20);
+    }
+    for (std::size_t c = 0x450; c < 0x460; c++) {
+        table.kind[c] = 1;
+        table.upper[c] = static_cast<char16_t>(c - 0x50);
+    }
+    return table;
+}
+
+/**
+ * @brief Таблица букв, общая для всех единиц трансляции
+ */
+inline constexpr LetterTable letter_table = makeLetterTable();
+
+/**
+ * @brief Проверка, является ли символ буквой
+ * @param c - код символа
+ * @return true для латинской или кириллической буквы
+ */
+inline bool isLetter(char32_t c)
+{
+    return c < LetterTable::size && letter_table.kind[c] != 0;
+}
+
+/**
+ * @brief Проверка, является ли символ заглавной буквой
+ * @param c - код символа
+ * @return true для заглавной латинской или кириллической буквы
+ */
+inline bool isUpperLetter(char32_t c)
+{
+    return c < LetterTable::size && letter_table.kind[c] == 2;
+}
+
+/**
+ * @brief Перевод буквы в верхний регистр
+ * @param c - код символа
+ * @return Заглавная буква или исходный символ, если он не строчная буква
+ */
+inline char32_t toUpperLetter(char32_t c)
+{
+    return c < LetterTable::size ? letter_table.upper[c] : c;
+}
+
+/**
+ * @brief Проверка, является ли широкий символ буквой
+ * @param c - символ
+ * @return true для латинской или кириллической буквы
+ */
+inline bool isLetter(wchar_t c)
+{
+    return isLetter(static_cast<char32_t>(c));
+}
+
+/**
+ * @brief Проверка, является ли широкий символ заглавной буквой
+ * @param c - символ
+ * @return true для заглавной латинской или кириллической буквы
+ */
+inline bool isUpperLetter(wchar_t c)
+{
+    return isUpperLetter(static_cast<char32_t>(c));
+}
+
+/**
+ * @brief Перевод широкого символа в верхний регистр
+ * @param c - символ
+ * @return Заглавная буква или исходный символ, если он не строчная буква
+ */
+inline wchar_t toUpperLetter(wchar_t c)
+{
+    return static_cast<wchar_t>(toUpperLetter(static_cast<char32_t>(c)));
+}
+
+/**
+ * @brief Длина начала текста, состоящего из заглавных букв
+ * @param text - текст
+ * @param n - длина текста
+ * @return Позиция первого символа, не являющегося заглавной буквой, или n
+ */
+std::size_t upperLetterSpan(const wchar_t* text, std::size_t n);
+
+/**
+ * @brief Подсчёт букв
+ * @param text - текст
+ * @param n - длина текста
+ * @return Количество букв в тексте
+ */
+std::size_t letterCount(const wchar_t* text, std::size_t n);
+
+/**
+ * @brief Очистка текста от не-букв с переводом в верхний регистр
+ * @param in - исходный текст
+ * @param n - длина текста
+ * @param out - буфер для букв (не меньше letterCount(in, n)); может совпадать с in
+ * @return Количество записанных букв
+ */
+std::size_t foldLetters(const wchar_t* in, std::size_t n, wchar_t* out);
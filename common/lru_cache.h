@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+
+/**
+ * @file lru_cache.h
+ * @brief Ограниченный потокобезопасный LRU-кэш
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Ограниченный LRU-кэш со счётчиками попаданий и промахов
+ * @tparam Key - ключ (упорядочиваемый через operator<)
+ * @tparam Value - значение; обычно shared_ptr, чтобы значение оставалось действительным
+ * после вытеснения, а пустое значение означало промах
+ * @details Методы потокобезопасны. Значение строится вызывающим вне блокировки:
+ * сначала find(), при промахе - построение и insert()
+ */
+template <class Key, class Value>
+class LruCache
+{
+public:
+    /**
+     * @brief Создание пустого кэша
+     * @param capacity - наибольшее количество значений (0 отключает кэш)
+     */
+    explicit LruCache(std::size_t capacity): limit(capacity) {}
+
+    LruCache(const LruCache&) = delete; ///< Кэш не копируется
+    LruCache& operator=(const LruCache&) = delete; ///< Кэш не копируется
+
+    /**
+     * @brief Поиск значения с учётом счётчиков попаданий и промахов
+     * @param key - ключ
+     * @return Значение или Value() при промахе
+     */
+    Value find(const Key& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end()) {
+            miss_count++;
+            return Value();
+        }
+        hit_count++;
+        order.splice(order.begin(), order, it->second);
+        return it->second->second;
+    }
+
+    /**
+     * @brief Добавление значения; при переполнении вытесняется давно не используемое
+     * @param key - ключ
+     * @param value - значение
+     * @return Добавленное значение (или уже имеющееся, если его успел добавить другой поток)
+     */
+    Value insert(const Key& key, Value value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (limit == 0)
+            return value;
+        auto it = index.find(key);
+        if (it != index.end()) {
+            order.splice(order.begin(), order, it->second);
+            return it->second->second;
+        }
+        order.emplace_front(key, std::move(value));
+        index[key] = order.begin();
+        evict();
+        return order.front().second;
+    }
+
+    /**
+     * @brief Изменение ёмкости с вытеснением лишних значений
+     * @param capacity - наибольшее количество значений (0 отключает кэш)
+     */
+    void setCapacity(std::size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        limit = capacity;
+        evict();
+    }
+
+    /**
+     * @brief Удаление всех значений и обнуление счётчиков
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.clear();
+        index.clear();
+        hit_count = 0;
+        miss_count = 0;
+    }
+
+    /**
+     * @brief Ёмкость кэша
+     * @return Наибольшее количество значений
+     */
+    std::size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return limit;
+    }
+
+    /**
+     * @brief Количество значений в кэше
+     * @return Число значений
+     */
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return index.size();
+    }
+
+    /**
+     * @brief Количество попаданий
+     * @return Число вызовов find(), нашедших значение
+     */
+    unsigned long long hits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hit_count;
+    }
+
+    /**
+     * @brief Количество промахов
+     * @return Число вызовов find(), не нашедших значение
+     */
+    unsigned long long misses() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return miss_count;
+    }
+
+private:
+    typedef std::list<std::pair<Key, Value>> Order; ///< Значения от недавно использованных к давно не используемым
+
+    Order order; ///< Очередь вытеснения
+    std::map<Key, typename Order::iterator> index; ///< Поиск значения по ключу
+    std::size_t limit; ///< Ёмкость кэша
+    unsigned long long hit_count = 0; ///< Счётчик попаданий
+    unsigned long long miss_count = 0; ///< Счётчик промахов
+    mutable std::mutex mutex; ///< Защита кэша и счётчиков
+
+    /**
+     * @brief Вытеснение значений сверх ёмкости (вызывается под mutex)
+     */
+    void evict()
+    {
+        while (index.size() > limit) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+    }
+};
@@ -0,0 +1,212 @@
+#include "mapped_file.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file mapped_file.cpp
+ * @brief Реализация отображения файлов в память
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Исключение с текущим errno и именем файла
+ * @param path - путь к файлу
+ * @return Исключение для выброса
+ */
+static std::system_error fileError(const std::string& path)
+{
+    return std::system_error(errno, std::generic_category(), path);
+}
+
+/**
+ * @brief Открытие и отображение файла
+ * @param path - путь к файлу
+ * @throw std::system_error если файл не удалось открыть или отобразить
+ */
+MappedFile::MappedFile(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw fileError(path);
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        std::system_error e = fileError(path);
+        ::close(fd);
+        throw e;
+    }
+    length = st.st_size;
+    if (length > 0) {
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            std::system_error e = fileError(path);
+            ::close(fd);
+            throw e;
+        }
+        ::madvise(p, length, MADV_SEQUENTIAL);
+        addr = static_cast<const char*>(p);
+    }
+    ::close(fd);
+}
+
+/**
+ * @brief Снятие отображения
+ */
+MappedFile::~MappedFile()
+{
+    if (addr != nullptr)
+        ::munmap(const_cast<char*>(addr), length);
+}
+
+/**
+ * @brief Открытие временного файла или цели для записи
+ * @param path - путь к цели
+ * @throw std::system_error если файл не удалось создать или открыть
+ * @details Ссылка раскрывается, чтобы временный файл оказался в одном каталоге
+ * (и на одной файловой системе) с настоящей целью и rename() был атомарным
+ */
+OutputFile::OutputFile(const std::string& path):
+    target(path), destination(path)
+{
+    char resolved[PATH_MAX];
+    if (::realpath(path.c_str(), resolved) != nullptr)
+        destination = resolved;
+    struct stat st;
+    bool exists = ::stat(destination.c_str(), &st) == 0;
+    if (exists && !S_ISREG(st.st_mode)) {
+        handle = ::open(destination.c_str(), O_WRONLY | O_CLOEXEC);
+        if (handle < 0)
+            throw fileError(path);
+        return;
+    }
+    std::string name = destination + ".XXXXXX";
+    handle = ::mkstemp(&name[0]);
+    if (handle < 0)
+        throw fileError(path);
+    temp = name;
+    if (::fchmod(handle, exists ? st.st_mode & 07777 : 0644) < 0) {
+        std::system_error e = fileError(path);
+        ::close(handle);
+        ::unlink(temp.c_str());
+        throw e;
+    }
+}
+
+/**
+ * @brief Закрытие; незафиксированный временный файл удаляется
+ */
+OutputFile::~OutputFile()
+{
+    if (handle >= 0)
+        ::close(handle);
+    if (!committed && !temp.empty())
+        ::unlink(temp.c_str());
+}
+
+/**
+ * @brief Запись всех байтов с текущей позиции файла
+ * @param data - данные
+ * @param n - количество байтов
+ * @throw std::system_error при ошибке записи
+ */
+void OutputFile::write(const char* data, std::size_t n)
+{
+    std::size_t done = 0;
+    while (done < n) {
+        ssize_t k = ::write(handle, data + done, n - done);
+        if (k < 0) {
+            if (errno == EINTR)
+                continue;
+            throw fileError(target);
+        }
+        done += k;
+    }
+}
+
+/**
+ * @brief Фиксация результата: закрытие и переименование временного файла поверх цели
+ * @throw std::system_error если файл не удалось закрыть или переименовать
+ */
+void OutputFile::commit()
+{
+    int fd = handle;
+    handle = -1;
+    if (::close(fd) < 0)
+        throw fileError(target);
+    if (!temp.empty() && ::rename(temp.c_str(), destination.c_str()) < 0)
+        throw fileError(target);
+    committed = true;
+}
+
+/**
+ * @brief Создание временного файла и отображение его в память
+ * @param path - путь к цели
+ * @param capacity - наибольший размер результата в байтах
+ * @throw std::system_error если файл не удалось создать или отобразить
+ */
+MappedOutput::MappedOutput(const std::string& path, std::size_t capacity):
+    file(path), capacity(capacity)
+{
+    if (capacity == 0)
+        return;
+    void* p;
+    if (file.regular()) {
+        if (::ftruncate(file.fd(), capacity) < 0)
+            throw fileError(path);
+        p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd(), 0);
+    } else {
+        p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (p == MAP_FAILED)
+        throw fileError(path);
+    addr = static_cast<char*>(p);
+}
+
+/**
+ * @brief Снятие отображения; незавершённый временный файл удаляется
+ */
+MappedOutput::~MappedOutput()
+{
+    if (addr != nullptr)
+        ::munmap(addr, capacity);
+}
+
+/**
+ * @brief Фиксация результата
+ * @param used - фактическая длина результата (не больше size())
+ * @throw std::system_error если результат не удалось записать, обрезать или переименовать
+ */
+void MappedOutput::commit(std::size_t used)
+{
+    if (!file.regular() && used > 0)
+        file.write(addr, used);
+    if (addr != nullptr) {
+        ::munmap(addr, capacity);
+        addr = nullptr;
+    }
+    if (file.regular() && ::ftruncate(file.fd(), used) < 0)
+        throw fileError(file.path());
+    file.commit();
+}
+
+/**
+ * @brief Проверка, что выходной файл не совпадает с входным
+ * @param input - путь к входному файлу
+ * @param output - путь к выходному файлу
+ * @throw std::system_error если оба пути ведут к одному файлу
+ */
+void checkDistinctFiles(const std::string& input, const std::string& output)
+{
+    struct stat in, out;
+    if (::stat(input.c_str(), &in) < 0 || ::stat(output.c_str(), &out) < 0)
+        return;
+    if (in.st_dev == out.st_dev && in.st_ino == out.st_ino)
+        throw std::system_error(EINVAL, std::generic_category(), output + " is the input file");
+}
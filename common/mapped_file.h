@@ -0,0 +1,198 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @file mapped_file.h
+ * @brief Отображение файлов в память для пакетной обработки больших текстов
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Ошибки ввода-вывода сообщаются исключением std::system_error с именем файла.
+ */
+
+/**
+ * @brief Входной файл, отображённый в память только для чтения
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Открытие и отображение файла
+     * @param path - путь к файлу
+     * @throw std::system_error если файл не удалось открыть или отобразить
+     */
+    explicit MappedFile(const std::string& path);
+
+    /**
+     * @brief Снятие отображения
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete; ///< Отображение не копируется
+    MappedFile& operator=(const MappedFile&) = delete; ///< Отображение не копируется
+
+    /**
+     * @brief Содержимое файла
+     * @return Указатель на первый байт (nullptr для пустого файла)
+     */
+    const char* data() const
+    {
+        return addr;
+    }
+
+    /**
+     * @brief Размер файла
+     * @return Количество байтов
+     */
+    std::size_t size() const
+    {
+        return length;
+    }
+
+private:
+    const char* addr = nullptr; ///< Начало отображения
+    std::size_t length = 0; ///< Размер файла
+};
+
+/**
+ * @brief Выходной файл, заменяющий цель только после успешной записи
+ * @details Если цель - обычный файл, ссылка на него или ещё не существует, данные
+ * пишутся во временный файл в каталоге цели, и commit() переименовывает его поверх
+ * цели (ссылка при этом сохраняется). Без commit() удаляется только временный файл,
+ * так что прежнее содержимое цели не теряется. Устройство, канал или сокет
+ * открываются для записи напрямую, без обрезки, и никогда не удаляются
+ */
+class OutputFile
+{
+public:
+    /**
+     * @brief Открытие временного файла или цели для записи
+     * @param path - путь к цели
+     * @throw std::system_error если файл не удалось создать или открыть
+     */
+    explicit OutputFile(const std::string& path);
+
+    /**
+     * @brief Закрытие; незафиксированный временный файл удаляется
+     */
+    ~OutputFile();
+
+    OutputFile(const OutputFile&) = delete; ///< Файл не копируется
+    OutputFile& operator=(const OutputFile&) = delete; ///< Файл не копируется
+
+    /**
+     * @brief Дескриптор для записи
+     * @return Дескриптор временного файла или цели
+     */
+    int fd() const
+    {
+        return handle;
+    }
+
+    /**
+     * @brief Запись идёт во временный обычный файл
+     * @return true, если файл можно увеличивать, обрезать и отображать в память
+     */
+    bool regular() const
+    {
+        return !temp.empty();
+    }
+
+    /**
+     * @brief Путь к цели для сообщений об ошибках
+     * @return Путь, переданный конструктору
+     */
+    const std::string& path() const
+    {
+        return target;
+    }
+
+    /**
+     * @brief Запись всех байтов с текущей позиции файла
+     * @param data - данные
+     * @param n - количество байтов
+     * @throw std::system_error при ошибке записи
+     */
+    void write(const char* data, std::size_t n);
+
+    /**
+     * @brief Фиксация результата: закрытие и переименование временного файла поверх цели
+     * @throw std::system_error если файл не удалось закрыть или переименовать
+     */
+    void commit();
+
+private:
+    std::string target; ///< Путь к цели
+    std::string destination; ///< Цель после раскрытия ссылок: сюда переименовывается результат
+    std::string temp; ///< Временный файл (пуст при записи напрямую)
+    int handle = -1; ///< Дескриптор файла
+    bool committed = false; ///< Признак зафиксированного результата
+};
+
+/**
+ * @brief Выходной файл, заранее увеличенный до заданного размера и отображённый в память
+ * @details Запись идёт через OutputFile: после commit() результат обрезается до фактической
+ * длины и заменяет цель, без commit() цель остаётся нетронутой. Если цель - устройство
+ * или канал, результат собирается в анонимной памяти и записывается в commit()
+ */
+class MappedOutput
+{
+public:
+    /**
+     * @brief Создание временного файла и отображение его в память
+     * @param path - путь к цели
+     * @param capacity - наибольший размер результата в байтах
+     * @throw std::system_error если файл не удалось создать или отобразить
+     */
+    MappedOutput(const std::string& path, std::size_t capacity);
+
+    /**
+     * @brief Снятие отображения; незавершённый временный файл удаляется
+     */
+    ~MappedOutput();
+
+    MappedOutput(const MappedOutput&) = delete; ///< Отображение не копируется
+    MappedOutput& operator=(const MappedOutput&) = delete; ///< Отображение не копируется
+
+    /**
+     * @brief Буфер для записи
+     * @return Указатель на первый байт (nullptr при нулевой ёмкости)
+     */
+    char* data()
+    {
+        return addr;
+    }
+
+    /**
+     * @brief Ёмкость буфера
+     * @return Количество байтов
+     */
+    std::size_t size() const
+    {
+        return capacity;
+    }
+
+    /**
+     * @brief Фиксация результата
+     * @param used - фактическая длина результата (не больше size())
+     * @throw std::system_error если результат не удалось записать, обрезать или переименовать
+     */
+    void commit(std::size_t used);
+
+private:
+    OutputFile file; ///< Выходной файл
+    char* addr = nullptr; ///< Начало отображения
+    std::size_t capacity = 0; ///< Размер отображения
+};
+
+/**
+ * @brief Проверка, что выходной файл не совпадает с входным
+ * @param input - путь к входному файлу
+ * @param output - путь к выходному файлу
+ * @throw std::system_error если оба пути ведут к одному файлу, в том числе через ссылку
+ * @details Результат заменил бы исходный текст, и ошибку в ключе уже нельзя было бы
+ * исправить, поэтому такие задания отклоняются. Файлы сравниваются по устройству
+ * и номеру inode; о несуществующем файле сообщит его открытие
+ */
+void checkDistinctFiles(const std::string& input, const std::string& output);
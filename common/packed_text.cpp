@@ -0,0 +1,216 @@
+#include "packed_text.h"
+#include "utf8.h"
+#include "letters.h"
+#include <stdexcept>
+
+/**
+ * @file packed_text.cpp
+ * @brief Реализация класса PackedText
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Кодирование открытого текста
+ * @param text - открытый текст
+ * @param alphabet - алфавит
+ * @param packed - результат (изменяется только при успехе)
+ * @return Вид ошибки и позиция первого недопустимого символа
+ */
+cipher_status PackedText::fromOpenText(const std::wstring& text, const Alphabet& alphabet, PackedText& packed)
+{
+    std::vector<unsigned char> result;
+    result.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); i++) {
+        wchar_t c = text[i];
+        if (!isLetter(c))
+            continue;
+        int a = alphabet.index(toUpperLetter(c));
+        if (a == Alphabet::npos)
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+        result.push_back(a);
+    }
+    if (result.empty())
+        return cipher_status(cipher_errc::empty_open_text);
+    packed.letters = std::move(result);
+    return cipher_status();
+}
+
+/**
+ * @brief Кодирование открытого текста в UTF-8
+ * @param text - открытый текст в UTF-8
+ * @param alphabet - алфавит
+ * @param packed - результат (изменяется только при успехе)
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ * @details Буквы классифицируются по letters.h, а не через локаль
+ */
+cipher_status PackedText::fromOpenText(std::string_view text, const Alphabet& alphabet, PackedText& packed)
+{
+    std::vector<unsigned char> result;
+    result.reserve(text.size() / 2);
+    for (std::size_t i = 0; i < text.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(text.data() + i, text.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        if (isLetter(c)) {
+            int a = alphabet.index(toUpperLetter(c));
+            if (a == Alphabet::npos)
+                return cipher_status(cipher_errc::not_in_alphabet, i);
+            result.push_back(a);
+        }
+        i += k;
+    }
+    if (result.empty())
+        return cipher_status(cipher_errc::empty_open_text);
+    packed.letters = std::move(result);
+    return cipher_status();
+}
+
+/**
+ * @brief Кодирование шифртекста
+ * @param text - шифртекст из заглавных букв алфавита
+ * @param alphabet - алфавит
+ * @param packed - результат (изменяется только при успехе)
+ * @return Вид ошибки и позиция первого недопустимого символа
+ */
+cipher_status PackedText::fromCipherText(const std::wstring& text, const Alphabet& alphabet, PackedText& packed)
+{
+    if (text.empty())
+        return cipher_status(cipher_errc::empty_cipher_text);
+    std::vector<unsigned char> result(text.size());
+    for (std::size_t i = 0; i < text.size(); i++) {
+        if (!isUpperLetter(text[i]))
+            return cipher_status(cipher_errc::invalid_cipher_text, i);
+        int a = alphabet.index(text[i]);
+        if (a == Alphabet::npos)
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+        result[i] = a;
+    }
+    packed.letters = std::move(result);
+    return cipher_status();
+}
+
+/**
+ * @brief Кодирование шифртекста в UTF-8
+ * @param text - шифртекст в UTF-8 из заглавных букв алфавита
+ * @param alphabet - алфавит
+ * @param packed - результат (изменяется только при успехе)
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status PackedText::fromCipherText(std::string_view text, const Alphabet& alphabet, PackedText& packed)
+{
+    if (text.empty())
+        return cipher_status(cipher_errc::empty_cipher_text);
+    std::vector<unsigned char> result;
+    result.reserve(text.size() / 2);
+    for (std::size_t i = 0; i < text.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(text.data() + i, text.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        if (!isUpperLetter(c))
+            return cipher_status(cipher_errc::invalid_cipher_text, i);
+        int a = alphabet.index(c);
+        if (a == Alphabet::npos)
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+        result.push_back(a);
+        i += k;
+    }
+    packed.letters = std::move(result);
+    return cipher_status();
+}
+
+/**
+ * @brief Восстановление текста из 6-битной формы
+ * @param bits - упакованные номера, как их возвращает toBits6()
+ * @param length - количество букв
+ * @return Текст
+ * @throw std::length_error если в bits меньше (length * 6 + 7) / 8 байтов
+ */
+PackedText PackedText::fromBits6(const std::vector<unsigned char>& bits, std::size_t length)
+{
+    if (bits.size() < (length * 6 + 7) / 8)
+        throw std::length_error("Packed text is truncated");
+    std::vector<unsigned char> result(length);
+    std::size_t i = 0;
+    const unsigned char* p = bits.data();
+    // Полные группы: три байта — четыре буквы
+    for (; i + 4 <= length; i += 4, p += 3) {
+        result[i] = p[0] & 0x3F;
+        result[i + 1] = (p[0] >> 6 | p[1] << 2) & 0x3F;
+        result[i + 2] = (p[1] >> 4 | p[2] << 4) & 0x3F;
+        result[i + 3] = p[2] >> 2;
+    }
+    for (; i < length; i++) {
+        std::size_t bit = i * 6;
+        unsigned value = bits[bit / 8];
+        if (bit / 8 + 1 < bits.size())
+            value |= bits[bit / 8 + 1] << 8;
+        result[i] = (value >> bit % 8) & 0x3F;
+    }
+    return PackedText(std::move(result));
+}
+
+/**
+ * @brief Декодирование в широкую строку
+ * @param alphabet - алфавит, которым текст кодировался
+ * @return Строка из букв алфавита
+ */
+std::wstring PackedText::toWide(const Alphabet& alphabet) const
+{
+    std::wstring result(letters.size(), L'\0');
+    for (std::size_t i = 0; i < letters.size(); i++)
+        result[i] = alphabet.symbol(letters[i]);
+    return result;
+}
+
+/**
+ * @brief Декодирование в UTF-8
+ * @param alphabet - алфавит, которым текст кодировался
+ * @return Строка из букв алфавита в UTF-8
+ */
+std::string PackedText::toUtf8(const Alphabet& alphabet) const
+{
+    std::string result(letters.size() * 4, '\0');
+    std::size_t written = 0;
+    for (unsigned char a : letters)
+        written += utf8Encode(alphabet.symbol(a), &result[written]);
+    result.resize(written);
+    return result;
+}
+
+/**
+ * @brief Упаковка по 6 бит на букву
+ * @return (size() * 6 + 7) / 8 байтов; четыре буквы занимают три байта
+ * @throw std::length_error если в тексте есть номер больше 63
+ * @details Биты идут от младших к старшим: буква i занимает биты 6i..6i+5 потока
+ */
+std::vector<unsigned char> PackedText::toBits6() const
+{
+    const std::size_t n = letters.size();
+    std::vector<unsigned char> result((n * 6 + 7) / 8, 0);
+    unsigned char any = 0;
+    for (unsigned char a : letters)
+        any |= a;
+    if (any > 0x3F)
+        throw std::length_error("Alphabet is too large for 6-bit packing");
+
+    std::size_t i = 0;
+    unsigned char* p = result.data();
+    for (; i + 4 <= n; i += 4, p += 3) {
+        const unsigned char* a = &letters[i];
+        p[0] = a[0] | a[1] << 6;
+        p[1] = a[1] >> 2 | a[2] << 4;
+        p[2] = a[2] >> 4 | a[3] << 2;
+    }
+    for (; i < n; i++) {
+        std::size_t bit = i * 6;
+        unsigned value = unsigned(letters[i]) << bit % 8;
+        result[bit / 8] |= value & 0xFF;
+        if (value >> 8)
+            result[bit / 8 + 1] |= value >> 8;
+    }
+    return result;
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "alphabet.h"
+#include "cipher_status.h"
+
+/**
+ * @file packed_text.h
+ * @brief Заголовочный файл класса PackedText — текста в виде номеров букв алфавита
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Текст как последовательность номеров букв алфавита, по байту на букву
+ * @details Вчетверо компактнее std::wstring. Оба шифра принимают и возвращают его
+ * напрямую, поэтому цепочку шифров и очереди текстов можно держать в этом виде,
+ * а перевод в UTF-8 и широкие строки выполнять только на входе и на выходе.
+ * Для хранения и передачи есть ещё более плотная 6-битная форма (алфавиты до 64 букв).
+ * Сам текст алфавит не хранит: кодировать и декодировать нужно одним алфавитом,
+ * а все номера меньше его мощности
+ */
+class PackedText
+{
+public:
+    /**
+     * @brief Пустой текст
+     */
+    PackedText() = default;
+
+    /**
+     * @brief Текст из готовых номеров букв
+     * @param indices - номера букв (меньше мощности алфавита; не проверяются)
+     */
+    explicit PackedText(std::vector<unsigned char> indices): letters(std::move(indices)) {}
+
+    /**
+     * @brief Кодирование открытого текста
+     * @param text - открытый текст
+     * @param alphabet - алфавит
+     * @param packed - результат (изменяется только при успехе)
+     * @return Вид ошибки и позиция первого недопустимого символа
+     * @details Как у шифров: не-буквы отбрасываются, строчные буквы переводятся в заглавные
+     */
+    static cipher_status fromOpenText(const std::wstring& text, const Alphabet& alphabet, PackedText& packed);
+
+    /**
+     * @brief Кодирование открытого текста в UTF-8
+     * @param text - открытый текст в UTF-8
+     * @param alphabet - алфавит
+     * @param packed - результат (изменяется только при успехе)
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status fromOpenText(std::string_view text, const Alphabet& alphabet, PackedText& packed);
+
+    /**
+     * @brief Кодирование шифртекста
+     * @param text - шифртекст из заглавных букв алфавита
+     * @param alphabet - алфавит
+     * @param packed - результат (изменяется только при успехе)
+     * @return Вид ошибки и позиция первого недопустимого символа
+     */
+    static cipher_status fromCipherText(const std::wstring& text, const Alphabet& alphabet, PackedText& packed);
+
+    /**
+     * @brief Кодирование шифртекста в UTF-8
+     * @param text - шифртекст в UTF-8 из заглавных букв алфавита
+     * @param alphabet - алфавит
+     * @param packed - результат (изменяется только при успехе)
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status fromCipherText(std::string_view text, const Alphabet& alphabet, PackedText& packed);
+
+    /**
+     * @brief Восстановление текста из 6-битной формы
+     * @param bits - упакованные номера, как их возвращает toBits6()
+     * @param length - количество букв
+     * @return Текст
+     */
+    static PackedText fromBits6(const std::vector<unsigned char>& bits, std::size_t length);
+
+    /**
+     * @brief Декодирование в широкую строку
+     * @param alphabet - алфавит, которым текст кодировался
+     * @return Строка из букв алфавита
+     */
+    std::wstring toWide(const Alphabet& alphabet) const;
+
+    /**
+     * @brief Декодирование в UTF-8
+     * @param alphabet - алфавит, которым текст кодировался
+     * @return Строка из букв алфавита в UTF-8
+     */
+    std::string toUtf8(const Alphabet& alphabet) const;
+
+    /**
+     * @brief Упаковка по 6 бит на букву
+     * @return (size() * 6 + 7) / 8 байтов; четыре буквы занимают три байта
+     * @throw std::length_error если в тексте есть номер больше 63
+     */
+    std::vector<unsigned char> toBits6() const;
+
+    /**
+     * @brief Количество букв
+     * @return Длина текста
+     */
+    std::size_t size() const
+    {
+        return letters.size();
+    }
+
+    /**
+     * @brief Проверка на пустоту
+     * @return true если в тексте нет букв
+     */
+    bool empty() const
+    {
+        return letters.empty();
+    }
+
+    /**
+     * @brief Номера букв
+     * @return Указатель на первый номер
+     */
+    const unsigned char* data() const
+    {
+        return letters.data();
+    }
+
+    /**
+     * @brief Номера букв для изменения на месте
+     * @return Указатель на первый номер
+     */
+    unsigned char* data()
+    {
+        return letters.data();
+    }
+
+    /**
+     * @brief Номер буквы
+     * @param i - позиция (i < size())
+     * @return Номер буквы в алфавите
+     */
+    unsigned char operator[](std::size_t i) const
+    {
+        return letters[i];
+    }
+
+    /**
+     * @brief Номера букв в виде вектора
+     * @return Вектор номеров
+     */
+    const std::vector<unsigned char>& indices() const
+    {
+        return letters;
+    }
+
+    /**
+     * @brief Сравнение текстов
+     * @param other - другой текст
+     * @return true если номера букв совпадают
+     */
+    bool operator==(const PackedText& other) const
+    {
+        return letters == other.letters;
+    }
+
+    /**
+     * @brief Сравнение текстов
+     * @param other - другой текст
+     * @return true если номера букв различаются
+     */
+    bool operator!=(const PackedText& other) const
+    {
+        return letters != other.letters;
+    }
+
+private:
+    std::vector<unsigned char> letters; ///< Номера букв по порядку
+};
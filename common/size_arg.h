@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @file size_arg.h
+ * @brief Разбор размеров в аргументах командной строки
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Разбор размера с необязательным суффиксом K, M или G
+ * @param s - строка с размером
+ * @return Размер в байтах
+ * @throw std::invalid_argument если строка не является размером (в том числе
+ * отрицательным) или размер не помещается в std::size_t
+ */
+inline std::size_t parseSize(const std::string& s)
+{
+    if (s.empty() || s[0] < '0' || s[0] > '9')
+        throw std::invalid_argument("invalid size: " + s);
+    std::size_t pos;
+    unsigned long long value;
+    try {
+        value = std::stoull(s, &pos);
+    } catch (const std::out_of_range&) {
+        throw std::invalid_argument("size is too large: " + s);
+    }
+    std::string suffix = s.substr(pos);
+    unsigned shift = 0;
+    if (suffix == "K")
+        shift = 10;
+    else if (suffix == "M")
+        shift = 20;
+    else if (suffix == "G")
+        shift = 30;
+    else if (!suffix.empty())
+        throw std::invalid_argument("invalid size: " + s);
+    if (value > (std::numeric_limits<std::size_t>::max() >> shift))
+        throw std::invalid_argument("size is too large: " + s);
+    return static_cast<std::size_t>(value) << shift;
+}
+
+/**
+ * @brief Разбор неотрицательного целого параметра в заданных пределах
+ * @param s - строка с числом
+ * @param name - имя параметра для сообщения об ошибке
+ * @param min - наименьшее допустимое значение
+ * @param max - наибольшее допустимое значение
+ * @return Значение параметра
+ * @throw std::invalid_argument если строка не является десятичным числом (в том числе
+ * отрицательным) или число вне пределов
+ */
+inline std::size_t parseCount(const std::string& s, const std::string& name,
+                              std::size_t min, std::size_t max)
+{
+    if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos)
+        throw std::invalid_argument("invalid " + name + ": " + s);
+    unsigned long long value;
+    try {
+        value = std::stoull(s);
+    } catch (const std::out_of_range&) {
+        value = std::numeric_limits<unsigned long long>::max();
+    }
+    if (value < min || value > max)
+        throw std::invalid_argument(name + " must be from " + std::to_string(min) + " to " + std::to_string(max));
+    return static_cast<std::size_t>(value);
+}
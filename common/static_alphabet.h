@@ -0,0 +1,152 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "alphabet.h"
+
+/**
+ * @file static_alphabet.h
+ * @brief Алфавиты, известные на этапе компиляции
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Русский алфавит из 33 букв
+ */
+struct RussianLetters
+{
+    static constexpr std::wstring_view letters = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"; ///< Буквы по порядку
+};
+
+/**
+ * @brief Русский алфавит без буквы Ё (32 буквы)
+ */
+struct RussianNoYoLetters
+{
+    static constexpr std::wstring_view letters = L"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"; ///< Буквы по порядку
+};
+
+/**
+ * @brief Латинский алфавит из 26 букв
+ */
+struct LatinLetters
+{
+    static constexpr std::wstring_view letters = L"ABCDEFGHIJKLMNOPQRSTUVWXYZ"; ///< Буквы по порядку
+};
+
+/**
+ * @brief Наименьший или наибольший код буквы
+ * @param letters - буквы алфавита
+ * @param largest - true для наибольшего
+ * @return Код буквы
+ */
+constexpr wchar_t alphabetBound(std::wstring_view letters, bool largest)
+{
+    wchar_t result = letters[0];
+    for (wchar_t c : letters) {
+        if (largest ? c > result : c < result)
+            result = c;
+    }
+    return result;
+}
+
+/**
+ * @brief Проверка, что все буквы различны
+ * @param letters - буквы алфавита
+ * @return true если повторов нет
+ */
+constexpr bool alphabetDistinct(std::wstring_view letters)
+{
+    for (std::size_t i = 0; i < letters.size(); i++) {
+        for (std::size_t j = i + 1; j < letters.size(); j++) {
+            if (letters[i] == letters[j])
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Построение таблицы «символ → номер»
+ * @tparam Span - длина таблицы
+ * @param letters - буквы алфавита
+ * @param lowest - код, с которого начинается таблица
+ * @param unknown - метка символа вне алфавита
+ * @return Таблица номеров букв
+ */
+template <std::size_t Span>
+constexpr std::array<unsigned char, Span> alphabetTable(std::wstring_view letters, wchar_t lowest,
+                                                        unsigned char unknown)
+{
+    std::array<unsigned char, Span> result{};
+    for (std::size_t i = 0; i < Span; i++)
+        result[i] = unknown;
+    for (std::size_t i = 0; i < letters.size(); i++)
+        result[letters[i] - lowest] = static_cast<unsigned char>(i);
+    return result;
+}
+
+/**
+ * @brief Алфавит, таблица которого строится при компиляции
+ * @tparam Letters - описание алфавита: структура со статическим constexpr полем letters
+ * @details Таблица «символ → номер» покрывает отрезок от наименьшего до наибольшего
+ * кода буквы, поэтому для русского алфавита занимает 47 байт, для латинского — 26.
+ * Мощность алфавита — константа, и взятие остатка по ней компилятор сворачивает
+ */
+template <class Letters>
+class StaticAlphabet
+{
+public:
+    static constexpr std::wstring_view letters = Letters::letters; ///< Буквы по порядку
+    static constexpr std::size_t size = letters.size(); ///< Мощность алфавита
+    static constexpr int npos = Alphabet::npos; ///< Признак символа вне алфавита
+
+    StaticAlphabet() = delete; ///< Только статические члены
+
+    /**
+     * @brief Номер символа в алфавите
+     * @param c - символ
+     * @return Номер символа или npos, если символа нет в алфавите
+     */
+    static constexpr int index(wchar_t c)
+    {
+        unsigned long off = static_cast<unsigned long>(c) - static_cast<unsigned long>(lowest);
+        if (off >= span)
+            return npos;
+        return table[off] == unknown ? npos : table[off];
+    }
+
+    /**
+     * @brief Символ по номеру
+     * @param i - номер символа (0 <= i < size)
+     * @return Символ алфавита
+     */
+    static constexpr wchar_t symbol(int i)
+    {
+        return letters[i];
+    }
+
+    /**
+     * @brief Тот же алфавит в виде Alphabet
+     * @return Алфавит для PackedText и других мест, где он выбирается во время работы
+     */
+    static const Alphabet& runtime()
+    {
+        static const Alphabet alphabet{std::wstring(letters)};
+        return alphabet;
+    }
+
+private:
+    static constexpr unsigned char unknown = 0xFF; ///< Метка отсутствующего символа
+    static constexpr wchar_t lowest = alphabetBound(letters, false); ///< Начало таблицы
+    static constexpr std::size_t span = alphabetBound(letters, true) - lowest + 1; ///< Длина таблицы
+
+    static_assert(size > 0 && size < unknown, "alphabet must have 1..254 letters");
+    static_assert(alphabetDistinct(letters), "alphabet letters must be distinct");
+
+    static constexpr std::array<unsigned char, span> table =
+        alphabetTable<span>(letters, lowest, unknown); ///< Таблица «символ → номер»
+};
@@ -0,0 +1,93 @@
+#include "thread_pool.h"
+
+/**
+ * @file thread_pool.cpp
+ * @brief Реализация пула потоков
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Запуск исполнителей
+ * @param workers - количество потоков; 0 означает std::thread::hardware_concurrency()
+ */
+ThreadPool::ThreadPool(std::size_t workers)
+{
+    if (workers == 0)
+        workers = std::thread::hardware_concurrency();
+    if (workers == 0)
+        workers = 1;
+    threads.reserve(workers);
+    for (std::size_t i = 0; i < workers; i++)
+        threads.emplace_back(&ThreadPool::run, this);
+}
+
+/**
+ * @brief Остановка пула
+ * @details Дожидается выполнения уже поставленных задач
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (auto& t : threads)
+        t.join();
+}
+
+/**
+ * @brief Постановка задачи в очередь
+ * @param task - задача
+ * @return Будущий результат, через который передаётся исключение задачи
+ */
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> result = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(packaged));
+    }
+    ready.notify_one();
+    return result;
+}
+
+/**
+ * @brief Выполнение задачи для каждого номера от 0 до count - 1
+ * @param count - количество задач
+ * @param task - задача, получающая номер
+ * @throw Первое исключение, выброшенное задачей, после завершения всех задач
+ */
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task)
+{
+    std::vector<std::future<void>> done;
+    done.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+        done.push_back(submit([&task, i] { task(i); }));
+    for (auto& f : done)
+        f.wait();
+    for (auto& f : done)
+        f.get();
+}
+
+/**
+ * @brief Цикл исполнителя
+ */
+void ThreadPool::run()
+{
+    for (;;) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @file thread_pool.h
+ * @brief Заголовочный файл пула потоков, общего для обоих шифров
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Пул потоков с фиксированным числом исполнителей
+ * @details Задачи выполняются в порядке постановки. Исключение, выброшенное задачей,
+ * передаётся вызывающей стороне через std::future.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Запуск исполнителей
+     * @param workers - количество потоков; 0 означает std::thread::hardware_concurrency()
+     */
+    explicit ThreadPool(std::size_t workers = 0);
+
+    /**
+     * @brief Остановка пула
+     * @details Дожидается выполнения уже поставленных задач
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete; ///< Пул не копируется
+    ThreadPool& operator=(const ThreadPool&) = delete; ///< Пул не копируется
+
+    /**
+     * @brief Постановка задачи в очередь
+     * @param task - задача
+     * @return Будущий результат, через который передаётся исключение задачи
+     */
+    std::future<void> submit(std::function<void()> task);
+
+    /**
+     * @brief Выполнение задачи для каждого номера от 0 до count - 1
+     * @param count - количество задач
+     * @param task - задача, получающая номер
+     * @throw Первое исключение, выброшенное задачей, после завершения всех задач
+     * @details Вызывающий поток ждёт завершения; вызывать из задач этого же пула нельзя
+     */
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    /**
+     * @brief Количество исполнителей
+     * @return Число потоков пула
+     */
+    std::size_t size() const
+    {
+        return threads.size();
+    }
+
+private:
+    std::vector<std::thread> threads; ///< Исполнители
+    std::queue<std::packaged_task<void()>> tasks; ///< Очередь задач
+    std::mutex mutex; ///< Защита очереди
+    std::condition_variable ready; ///< Сигнал о новой задаче или остановке
+    bool stopping = false; ///< Признак остановки пула
+
+    /**
+     * @brief Цикл исполнителя
+     */
+    void run();
+};
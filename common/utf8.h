@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @file utf8.h
+ * @brief Кодирование и декодирование UTF-8 без участия локали
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Функции не выделяют памяти и рассчитаны на вызов для каждого символа
+ * в горячих циклах обоих шифров.
+ */
+
+/**
+ * @brief Декодирование одного символа UTF-8
+ * @param s - начало последовательности
+ * @param left - количество доступных байтов (больше 0)
+ * @param cp - декодированный код символа
+ * @return Длина последовательности в байтах или 0, если она некорректна или обрезана
+ */
+inline std::size_t utf8Decode(const char* s, std::size_t left, char32_t& cp)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    if (p[0] < 0x80) {
+        cp = p[0];
+        return 1;
+    }
+    if (p[0] < 0xC2)
+        return 0;
+    if (p[0] < 0xE0) {
+        if (left < 2 || (p[1] & 0xC0) != 0x80)
+            return 0;
+        cp = (char32_t(p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+        return 2;
+    }
+    if (p[0] < 0xF0) {
+        if (left < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80)
+            return 0;
+        cp = (char32_t(p[0] & 0x0F) << 12) | (char32_t(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        if (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))
+            return 0;
+        return 3;
+    }
+    if (p[0] < 0xF5) {
+        if (left < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80)
+            return 0;
+        cp = (char32_t(p[0] & 0x07) << 18) | (char32_t(p[1] & 0x3F) << 12)
+           | (char32_t(p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        if (cp < 0x10000 || cp > 0x10FFFF)
+            return 0;
+        return 4;
+    }
+    return 0;
+}
+
+/**
+ * @brief Длина символа в UTF-8
+ * @param cp - код символа
+ * @return Количество байтов (1..4)
+ */
+inline std::size_t utf8Length(char32_t cp)
+{
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+/**
+ * @brief Кодирование одного символа в UTF-8
+ * @param cp - код символа (не больше 0x10FFFF)
+ * @param out - буфер не меньше utf8Length(cp) байтов
+ * @return Количество записанных байтов
+ */
+inline std::size_t utf8Encode(char32_t cp, char* out)
+{
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/**
+ * @brief Длина префикса без обрезанного символа в конце
+ * @param s - данные в UTF-8
+ * @param n - длина данных
+ * @return n или начало последнего символа, если получены не все его байты (отрезается не больше 3 байтов)
+ * @details Смотрит только на последние байты; остальное проверяет utf8Decode
+ */
+inline std::size_t utf8CompletePrefix(const char* s, std::size_t n)
+{
+    std::size_t i = n;
+    std::size_t continuation = 0;
+    while (i > 0 && continuation < 3 && (static_cast<unsigned char>(s[i - 1]) & 0xC0) == 0x80) {
+        i--;
+        continuation++;
+    }
+    if (i > 0) {
+        unsigned char lead = s[i - 1];
+        std::size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+        if (length > continuation + 1)
+            return i - 1;
+    }
+    return n;
+}
@@ -0,0 +1,111 @@
+#include "gronsfeld.h"
+
+/**
+ * @file gronsfeld.cpp
+ * @brief Реализация GronsfeldCipher
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Шифр с конкретным алфавитом за интерфейсом Concept
+ * @tparam Letters - описание алфавита
+ */
+template <class Letters>
+struct GronsfeldCipher::Model : GronsfeldCipher::Concept
+{
+    BasicGronsfeld<Letters> cipher; ///< Специализированный шифр
+
+    explicit Model(const std::wstring& skey): cipher(skey) {}
+
+    std::wstring encrypt(const std::wstring& text) const override
+    {
+        return cipher.encrypt(text);
+    }
+
+    std::wstring decrypt(const std::wstring& text) const override
+    {
+        return cipher.decrypt(text);
+    }
+
+    std::string encrypt(std::string_view text) const override
+    {
+        return cipher.encrypt(text);
+    }
+
+    std::string decrypt(std::string_view text) const override
+    {
+        return cipher.decrypt(text);
+    }
+
+    PackedText encrypt(const PackedText& text) const override
+    {
+        return cipher.encrypt(text);
+    }
+
+    PackedText decrypt(const PackedText& text) const override
+    {
+        return cipher.decrypt(text);
+    }
+
+    std::size_t keyLength() const override
+    {
+        return cipher.keyLength();
+    }
+};
+
+/**
+ * @brief Конструктор с выбором алфавита
+ * @param alphabet - алфавит
+ * @param skey - ключ шифрования из букв этого алфавита
+ * @throw cipher_error если ключ невалиден
+ */
+GronsfeldCipher::GronsfeldCipher(GronsfeldAlphabet alphabet, const std::wstring& skey): id(alphabet)
+{
+    switch (alphabet) {
+    case GronsfeldAlphabet::russian_no_yo:
+        impl = std::make_shared<const Model<RussianNoYoLetters>>(skey);
+        break;
+    case GronsfeldAlphabet::latin:
+        impl = std::make_shared<const Model<LatinLetters>>(skey);
+        break;
+    default:
+        impl = std::make_shared<const Model<RussianLetters>>(skey);
+        break;
+    }
+}
+
+/**
+ * @brief Проверка ключа без исключений
+ * @param alphabet - алфавит
+ * @param skey - ключ шифрования
+ * @return Вид ошибки и позиция первого недопустимого символа ключа
+ */
+cipher_status GronsfeldCipher::checkKey(GronsfeldAlphabet alphabet, const std::wstring& skey)
+{
+    switch (alphabet) {
+    case GronsfeldAlphabet::russian_no_yo:
+        return BasicGronsfeld<RussianNoYoLetters>::checkKey(skey);
+    case GronsfeldAlphabet::latin:
+        return BasicGronsfeld<LatinLetters>::checkKey(skey);
+    default:
+        return BasicGronsfeld<RussianLetters>::checkKey(skey);
+    }
+}
+
+/**
+ * @brief Выбранный алфавит в виде Alphabet
+ * @return Алфавит для кодирования PackedText
+ */
+const Alphabet& GronsfeldCipher::alphabet() const
+{
+    switch (id) {
+    case GronsfeldAlphabet::russian_no_yo:
+        return StaticAlphabet<RussianNoYoLetters>::runtime();
+    case GronsfeldAlphabet::latin:
+        return StaticAlphabet<LatinLetters>::runtime();
+    default:
+        return StaticAlphabet<RussianLetters>::runtime();
+    }
+}
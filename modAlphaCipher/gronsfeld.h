@@ -0,0 +1,695 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "cipher_error.h"
+#include "cipher_status.h"
+#include "gronsfeld_kernel.h"
+#include "letters.h"
+#include "packed_text.h"
+#include "static_alphabet.h"
+#include "utf8.h"
+
+/**
+ * @file gronsfeld.h
+ * @brief Шифр Гронсфельда, специализированный под алфавит на этапе компиляции
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Шифр Гронсфельда над алфавитом, известным при компиляции
+ * @tparam Letters - описание алфавита (RussianLetters, RussianNoYoLetters, LatinLetters)
+ * @details Таблица «символ → номер» и мощность алфавита — константы StaticAlphabet,
+ * поэтому поиск буквы не обращается к данным объекта, а сдвиг по модулю сводится
+ * к сложению и сравнению с константой. Буквы определяются по letters.h без участия
+ * локали, одинаково для широких строк и UTF-8: остальные символы открытого текста
+ * отбрасываются, строчные буквы переводятся в заглавные.
+ * Сдвиг номеров букв у всех методов один - shiftLetters() на векторном ядре
+ * gronsfeldKernel(): текст разбирается в блок номеров по block_size букв, блок
+ * сдвигается ядром и записывается символами алфавита. Буквы алфавита заглавные,
+ * поэтому при дешифровании символ сначала ищется в таблице, а вид символа
+ * уточняется только для сообщения об ошибке.
+ * modAlphaCipher строит свои методы на BasicGronsfeld<RussianLetters>,
+ * добавляя к ним статистику и пул потоков
+ */
+template <class Letters>
+class BasicGronsfeld
+{
+public:
+    typedef StaticAlphabet<Letters> alphabet_type; ///< Алфавит шифра
+
+    BasicGronsfeld() = delete; ///< Удалённый конструктор по умолчанию
+
+    /**
+     * @brief Конструктор с установкой ключа
+     * @param skey - ключ шифрования из букв алфавита (регистр не важен)
+     * @throw cipher_error если ключ пуст или содержит символы вне алфавита
+     */
+    explicit BasicGronsfeld(const std::wstring& skey): kernel(gronsfeldKernel())
+    {
+        throwIfFailed(checkKey(skey));
+        for (wchar_t c : skey)
+            enc_key.push_back(alphabet_type::index(toUpperLetter(c)));
+        enc_stream.resize(enc_key.size() + block_size);
+        dec_stream.resize(enc_key.size() + block_size);
+        for (std::size_t i = 0; i < enc_stream.size(); i++) {
+            enc_stream[i] = enc_key[i % enc_key.size()];
+            dec_stream[i] = (alphabet_type::size - enc_stream[i]) % alphabet_type::size;
+        }
+    }
+
+    /**
+     * @brief Конструктор с установкой ключа в UTF-8
+     * @param skey - ключ шифрования в UTF-8
+     * @throw cipher_error если ключ не в UTF-8, пуст или содержит символы вне алфавита
+     */
+    explicit BasicGronsfeld(std::string_view skey): BasicGronsfeld(decodeKey(skey)) {}
+
+    /**
+     * @brief Проверка ключа без исключений
+     * @param skey - ключ шифрования
+     * @return Вид ошибки и позиция первого недопустимого символа ключа
+     */
+    static cipher_status checkKey(const std::wstring& skey)
+    {
+        if (skey.empty())
+            return cipher_status(cipher_errc::empty_key);
+        for (std::size_t i = 0; i < skey.size(); i++) {
+            if (!isLetter(skey[i]) || alphabet_type::index(toUpperLetter(skey[i])) == alphabet_type::npos)
+                return cipher_status(cipher_errc::invalid_key, i);
+        }
+        return cipher_status();
+    }
+
+    /**
+     * @brief Шифрование текста
+     * @param open_text - открытый текст
+     * @return Зашифрованная строка
+     * @throw cipher_error если текст пуст после очистки или содержит буквы вне алфавита
+     */
+    std::wstring encrypt(const std::wstring& open_text) const
+    {
+        std::wstring result(open_text.size(), L'\0');
+        std::size_t written;
+        throwIfFailed(try_encrypt_into(open_text.data(), open_text.size(), &result[0], result.size(), written));
+        result.resize(written);
+        return result;
+    }
+
+    /**
+     * @brief Дешифрование текста
+     * @param cipher_text - шифртекст
+     * @return Расшифрованная строка
+     * @throw cipher_error если текст пуст или содержит не заглавные буквы алфавита
+     */
+    std::wstring decrypt(const std::wstring& cipher_text) const
+    {
+        std::wstring result(cipher_text.size(), L'\0');
+        std::size_t written;
+        throwIfFailed(try_decrypt_into(cipher_text.data(), cipher_text.size(), &result[0], result.size(), written));
+        return result;
+    }
+
+    /**
+     * @brief Шифрование текста в UTF-8
+     * @param open_text - открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8, пуст после очистки или содержит буквы вне алфавита
+     */
+    std::string encrypt(std::string_view open_text) const
+    {
+        std::string result(open_text.size(), '\0');
+        std::size_t written;
+        throwIfFailed(try_encrypt_into(open_text.data(), open_text.size(), &result[0], result.size(), written));
+        result.resize(written);
+        return result;
+    }
+
+    /**
+     * @brief Дешифрование текста в UTF-8
+     * @param cipher_text - шифртекст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы алфавита
+     */
+    std::string decrypt(std::string_view cipher_text) const
+    {
+        std::string result(cipher_text.size(), '\0');
+        std::size_t written;
+        throwIfFailed(try_decrypt_into(cipher_text.data(), cipher_text.size(), &result[0], result.size(), written));
+        result.resize(written);
+        return result;
+    }
+
+    /**
+     * @brief Шифрование текста в виде номеров букв
+     * @param open_text - открытый текст, закодированный алфавитом alphabet_type::runtime()
+     * @return Шифртекст в том же виде
+     * @throw cipher_error если текст пуст
+     */
+    PackedText encrypt(const PackedText& open_text) const
+    {
+        if (open_text.empty())
+            throwIfFailed(cipher_status(cipher_errc::empty_open_text));
+        std::vector<unsigned char> result(open_text.size());
+        encrypt_packed(open_text.data(), result.data(), result.size(), 0);
+        return PackedText(std::move(result));
+    }
+
+    /**
+     * @brief Дешифрование текста в виде номеров букв
+     * @param cipher_text - шифртекст, закодированный алфавитом alphabet_type::runtime()
+     * @return Открытый текст в том же виде
+     * @throw cipher_error если текст пуст
+     */
+    PackedText decrypt(const PackedText& cipher_text) const
+    {
+        if (cipher_text.empty())
+            throwIfFailed(cipher_status(cipher_errc::empty_cipher_text));
+        std::vector<unsigned char> result(cipher_text.size());
+        decrypt_packed(cipher_text.data(), result.data(), result.size(), 0);
+        return PackedText(std::move(result));
+    }
+
+    /**
+     * @brief Шифрование номеров букв с заданной позиции ключа
+     * @param in - номера букв открытого текста (каждый меньше alphabet_type::size)
+     * @param out - номера букв шифртекста (может совпадать с in)
+     * @param n - количество букв
+     * @param key_position - количество букв текста до in
+     */
+    void encrypt_packed(const unsigned char* in, unsigned char* out, std::size_t n,
+                        unsigned long long key_position) const
+    {
+        shiftLetters(in, out, n, key_position % enc_key.size(), enc_stream);
+    }
+
+    /**
+     * @brief Дешифрование номеров букв с заданной позиции ключа
+     * @param in - номера букв шифртекста (каждый меньше alphabet_type::size)
+     * @param out - номера букв открытого текста (может совпадать с in)
+     * @param n - количество букв
+     * @param key_position - количество букв текста до in
+     */
+    void decrypt_packed(const unsigned char* in, unsigned char* out, std::size_t n,
+                        unsigned long long key_position) const
+    {
+        shiftLetters(in, out, n, key_position % enc_key.size(), dec_stream);
+    }
+
+    /**
+     * @brief Шифрование в буфер вызывающей стороны без исключений
+     * @param in - открытый текст
+     * @param n - длина открытого текста
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера (не меньше n)
+     * @param written - количество записанных символов
+     * @return Вид ошибки и позиция первого недопустимого символа
+     */
+    cipher_status try_encrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                   std::size_t& written) const
+    {
+        unsigned long long key_position = 0;
+        cipher_status status = try_encrypt_chunk(in, n, out, out_size, key_position, written);
+        if (status && written == 0)
+            return cipher_status(cipher_errc::empty_open_text);
+        return status;
+    }
+
+    /**
+     * @brief Дешифрование в буфер вызывающей стороны без исключений
+     * @param in - шифртекст
+     * @param n - длина шифртекста
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера (не меньше n)
+     * @param written - количество записанных символов
+     * @return Вид ошибки и позиция первого недопустимого символа
+     */
+    cipher_status try_decrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                   std::size_t& written) const
+    {
+        written = 0;
+        if (n == 0)
+            return cipher_status(cipher_errc::empty_cipher_text);
+        unsigned long long key_position = 0;
+        return try_decrypt_chunk(in, n, out, out_size, key_position, written);
+    }
+
+    /**
+     * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+     * @param in - открытый текст в UTF-8
+     * @param n - длина открытого текста в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     * @details Буква заменяется буквой того же алфавита, поэтому при out_size >= n
+     * шифртекст не длиннее входа
+     */
+    cipher_status try_encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written) const
+    {
+        unsigned long long key_position = 0;
+        cipher_status status = try_encrypt_chunk(in, n, out, out_size, key_position, written);
+        if (status && key_position == 0)
+            return cipher_status(cipher_errc::empty_open_text);
+        return status;
+    }
+
+    /**
+     * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+     * @param in - шифртекст в UTF-8
+     * @param n - длина шифртекста в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written) const
+    {
+        written = 0;
+        if (n == 0)
+            return cipher_status(cipher_errc::empty_cipher_text);
+        unsigned long long key_position = 0;
+        return try_decrypt_chunk(in, n, out, out_size, key_position, written);
+    }
+
+    /**
+     * @brief Шифрование фрагмента текста с заданной позиции ключа без исключений
+     * @param in - фрагмент открытого текста
+     * @param n - длина фрагмента
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+     * @param written - количество записанных символов (может быть 0)
+     * @return Вид ошибки и позиция первой буквы вне алфавита
+     * @details Номера букв копятся в блоке по block_size и сдвигаются shiftLetters();
+     * последовательные вызовы с одной переменной key_position дают результат
+     * try_encrypt_into для всего текста
+     */
+    cipher_status try_encrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const
+    {
+        written = 0;
+        if (out_size < n)
+            return cipher_status(cipher_errc::buffer_too_small);
+        std::size_t phase = key_position % enc_key.size();
+        unsigned char letters[block_size];
+        for (std::size_t i = 0; i < n;) {
+            const std::size_t end = std::min(n, i + block_size);
+            std::size_t count = 0;
+            for (; i < end; i++) {
+                if (!isLetter(in[i]))
+                    continue;
+                int a = alphabet_type::index(toUpperLetter(in[i]));
+                if (a == alphabet_type::npos)
+                    return cipher_status(cipher_errc::not_in_alphabet, i);
+                letters[count++] = a;
+            }
+            written += shiftBlock(letters, count, phase, enc_stream, out + written);
+        }
+        key_position += written;
+        return cipher_status();
+    }
+
+    /**
+     * @brief Дешифрование фрагмента шифртекста с заданной позиции ключа без исключений
+     * @param in - фрагмент шифртекста
+     * @param n - длина фрагмента
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на n
+     * @param written - количество записанных символов (равно n при успехе)
+     * @return Вид ошибки и позиция первого недопустимого символа
+     */
+    cipher_status try_decrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const
+    {
+        written = 0;
+        if (out_size < n)
+            return cipher_status(cipher_errc::buffer_too_small);
+        std::size_t phase = key_position % enc_key.size();
+        unsigned char letters[block_size];
+        for (std::size_t i = 0; i < n;) {
+            const std::size_t end = std::min(n, i + block_size);
+            std::size_t count = 0;
+            for (; i < end; i++) {
+                int a = alphabet_type::index(in[i]);
+                if (a == alphabet_type::npos)
+                    return cipher_status(isUpperLetter(in[i]) ? cipher_errc::not_in_alphabet
+                                                              : cipher_errc::invalid_cipher_text, i);
+                letters[count++] = a;
+            }
+            written += shiftBlock(letters, count, phase, dec_stream, out + written);
+        }
+        key_position += n;
+        return cipher_status();
+    }
+
+    /**
+     * @brief Шифрование фрагмента текста в UTF-8 с заданной позиции ключа без исключений
+     * @param in - фрагмент открытого текста в UTF-8, не разрезающий символы
+     * @param n - длина фрагмента в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+     * @param written - количество записанных байтов (может быть 0)
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_encrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const
+    {
+        written = 0;
+        if (out_size < n)
+            return cipher_status(cipher_errc::buffer_too_small);
+        std::size_t phase = key_position % enc_key.size();
+        unsigned char letters[block_size];
+        unsigned long long total = 0;
+        for (std::size_t i = 0; i < n;) {
+            const std::size_t end = std::min(n, i + block_size);
+            std::size_t count = 0;
+            while (i < end) {
+                char32_t c;
+                std::size_t k = utf8Decode(in + i, n - i, c);
+                if (k == 0)
+                    return cipher_status(cipher_errc::invalid_utf8, i);
+                if (isLetter(c)) {
+                    int a = alphabet_type::index(toUpperLetter(c));
+                    if (a == alphabet_type::npos)
+                        return cipher_status(cipher_errc::not_in_alphabet, i);
+                    letters[count++] = a;
+                }
+                i += k;
+            }
+            written += shiftBlock(letters, count, phase, enc_stream, out + written);
+            total += count;
+        }
+        key_position += total;
+        return cipher_status();
+    }
+
+    /**
+     * @brief Дешифрование фрагмента шифртекста в UTF-8 с заданной позиции ключа без исключений
+     * @param in - фрагмент шифртекста в UTF-8, не разрезающий символы
+     * @param n - длина фрагмента в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_decrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const
+    {
+        written = 0;
+        if (out_size < n)
+            return cipher_status(cipher_errc::buffer_too_small);
+        std::size_t phase = key_position % enc_key.size();
+        unsigned char letters[block_size];
+        unsigned long long total = 0;
+        for (std::size_t i = 0; i < n;) {
+            const std::size_t end = std::min(n, i + block_size);
+            std::size_t count = 0;
+            while (i < end) {
+                char32_t c;
+                std::size_t k = utf8Decode(in + i, n - i, c);
+                if (k == 0)
+                    return cipher_status(cipher_errc::invalid_utf8, i);
+                int a = alphabet_type::index(c);
+                if (a == alphabet_type::npos)
+                    return cipher_status(isUpperLetter(c) ? cipher_errc::not_in_alphabet
+                                                          : cipher_errc::invalid_cipher_text, i);
+                letters[count++] = a;
+                i += k;
+            }
+            written += shiftBlock(letters, count, phase, dec_stream, out + written);
+            total += count;
+        }
+        key_position += total;
+        return cipher_status();
+    }
+
+    /**
+     * @brief Длина ключа
+     * @return Количество букв ключа
+     */
+    std::size_t keyLength() const
+    {
+        return enc_key.size();
+    }
+
+    /**
+     * @brief Сдвиг ключа для буквы с заданным номером
+     * @param position - номер буквы в тексте
+     * @return Номер буквы ключа в алфавите, прибавляемый при шифровании
+     */
+    int keyShift(unsigned long long position) const
+    {
+        return enc_key[position % enc_key.size()];
+    }
+
+    static constexpr std::size_t block_size = 1024; ///< Число букв, сдвигаемых ядром за один вызов
+
+private:
+    std::vector<unsigned char> enc_key; ///< Ключ в числовом виде
+    std::vector<unsigned char> enc_stream; ///< Ключ, развёрнутый на keyLength() + block_size позиций, для шифрования
+    std::vector<unsigned char> dec_stream; ///< Дополнения ключа до мощности алфавита, развёрнутые так же
+    GronsfeldKernel kernel; ///< Вариант ядра, выбранный для процессора
+
+    /**
+     * @brief Перевод ключа из UTF-8
+     * @param skey - ключ в UTF-8
+     * @return Ключ широкой строкой
+     * @throw cipher_error если ключ не в UTF-8
+     */
+    static std::wstring decodeKey(std::string_view skey)
+    {
+        std::wstring result;
+        for (std::size_t i = 0; i < skey.size();) {
+            char32_t c;
+            std::size_t k = utf8Decode(skey.data() + i, skey.size() - i, c);
+            if (k == 0)
+                throw cipher_error("Invalid key");
+            result.push_back(c);
+            i += k;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Сдвиг номеров букв векторным ядром по ключевому потоку
+     * @param in - номера букв
+     * @param out - результат (может совпадать с in)
+     * @param n - количество букв
+     * @param phase - позиция в ключе для первой буквы (меньше keyLength())
+     * @param stream - enc_stream или dec_stream
+     * @details Поток длиной keyLength() + block_size позволяет начинать блок с любой
+     * фазы ключа и читать его подряд без взятия остатка
+     */
+    void shiftLetters(const unsigned char* in, unsigned char* out, std::size_t n, std::size_t phase,
+                      const std::vector<unsigned char>& stream) const
+    {
+        for (std::size_t i = 0; i < n; i += block_size) {
+            kernel(in + i, &stream[phase], out + i, std::min(block_size, n - i), alphabet_type::size);
+            phase = (phase + block_size) % enc_key.size();
+        }
+    }
+
+    /**
+     * @brief Сдвиг блока номеров букв и запись его символами алфавита
+     * @param letters - номера букв разобранного текста; сдвигаются на месте
+     * @param count - количество букв (не больше block_size)
+     * @param phase - позиция в ключе для первой буквы; сдвигается на count
+     * @param stream - enc_stream или dec_stream
+     * @param out - место записи
+     * @return Количество записанных символов или байтов
+     */
+    template <class Char>
+    std::size_t shiftBlock(unsigned char* letters, std::size_t count, std::size_t& phase,
+                           const std::vector<unsigned char>& stream, Char* out) const
+    {
+        shiftLetters(letters, letters, count, phase, stream);
+        phase = (phase + count) % enc_key.size();
+        std::size_t written = 0;
+        for (std::size_t j = 0; j < count; j++)
+            written += putSymbol(alphabet_type::symbol(letters[j]), out + written);
+        return written;
+    }
+
+    /**
+     * @brief Запись символа в широкую строку
+     * @param c - символ
+     * @param out - место записи
+     * @return 1
+     */
+    static std::size_t putSymbol(wchar_t c, wchar_t* out)
+    {
+        *out = c;
+        return 1;
+    }
+
+    /**
+     * @brief Запись символа в UTF-8
+     * @param c - символ
+     * @param out - место записи
+     * @return Количество записанных байтов
+     */
+    static std::size_t putSymbol(wchar_t c, char* out)
+    {
+        return utf8Encode(c, out);
+    }
+};
+
+/**
+ * @brief Алфавиты, для которых собран GronsfeldCipher
+ */
+enum class GronsfeldAlphabet {
+    russian,       ///< RussianLetters, 33 буквы
+    russian_no_yo, ///< RussianNoYoLetters, 32 буквы
+    latin          ///< LatinLetters, 26 букв
+};
+
+/**
+ * @brief Шифр Гронсфельда с алфавитом, выбираемым во время работы
+ * @details Хранит один из BasicGronsfeld<...> за виртуальным интерфейсом; виртуальный
+ * вызов приходится на весь текст, внутренний цикл остаётся специализированным.
+ * Копии разделяют неизменяемый шифр, методы константны и потокобезопасны
+ */
+class GronsfeldCipher
+{
+public:
+    GronsfeldCipher() = delete; ///< Удалённый конструктор по умолчанию
+
+    /**
+     * @brief Конструктор с выбором алфавита
+     * @param alphabet - алфавит
+     * @param skey - ключ шифрования из букв этого алфавита
+     * @throw cipher_error если ключ невалиден
+     */
+    GronsfeldCipher(GronsfeldAlphabet alphabet, const std::wstring& skey);
+
+    /**
+     * @brief Проверка ключа без исключений
+     * @param alphabet - алфавит
+     * @param skey - ключ шифрования
+     * @return Вид ошибки и позиция первого недопустимого символа ключа
+     */
+    static cipher_status checkKey(GronsfeldAlphabet alphabet, const std::wstring& skey);
+
+    /**
+     * @brief Выбранный алфавит
+     * @return Алфавит шифра
+     */
+    GronsfeldAlphabet alphabetId() const
+    {
+        return id;
+    }
+
+    /**
+     * @brief Выбранный алфавит в виде Alphabet
+     * @return Алфавит для кодирования PackedText
+     */
+    const Alphabet& alphabet() const;
+
+    /**
+     * @brief Шифрование текста
+     * @param open_text - открытый текст
+     * @return Зашифрованная строка
+     * @throw cipher_error если текст пуст после очистки или содержит буквы вне алфавита
+     */
+    std::wstring encrypt(const std::wstring& open_text) const
+    {
+        return impl->encrypt(open_text);
+    }
+
+    /**
+     * @brief Дешифрование текста
+     * @param cipher_text - шифртекст
+     * @return Расшифрованная строка
+     * @throw cipher_error если текст пуст или содержит не заглавные буквы алфавита
+     */
+    std::wstring decrypt(const std::wstring& cipher_text) const
+    {
+        return impl->decrypt(cipher_text);
+    }
+
+    /**
+     * @brief Шифрование текста в UTF-8
+     * @param open_text - открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8, пуст после очистки или содержит буквы вне алфавита
+     */
+    std::string encrypt(std::string_view open_text) const
+    {
+        return impl->encrypt(open_text);
+    }
+
+    /**
+     * @brief Дешифрование текста в UTF-8
+     * @param cipher_text - шифртекст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы алфавита
+     */
+    std::string decrypt(std::string_view cipher_text) const
+    {
+        return impl->decrypt(cipher_text);
+    }
+
+    /**
+     * @brief Шифрование текста в виде номеров букв
+     * @param open_text - открытый текст, закодированный алфавитом alphabet()
+     * @return Шифртекст в том же виде
+     * @throw cipher_error если текст пуст
+     */
+    PackedText encrypt(const PackedText& open_text) const
+    {
+        return impl->encrypt(open_text);
+    }
+
+    /**
+     * @brief Дешифрование текста в виде номеров букв
+     * @param cipher_text - шифртекст, закодированный алфавитом alphabet()
+     * @return Открытый текст в том же виде
+     * @throw cipher_error если текст пуст
+     */
+    PackedText decrypt(const PackedText& cipher_text) const
+    {
+        return impl->decrypt(cipher_text);
+    }
+
+    /**
+     * @brief Длина ключа
+     * @return Количество букв ключа
+     */
+    std::size_t keyLength() const
+    {
+        return impl->keyLength();
+    }
+
+private:
+    /**
+     * @brief Интерфейс шифра с конкретным алфавитом
+     */
+    struct Concept
+    {
+        virtual ~Concept() = default;
+        virtual std::wstring encrypt(const std::wstring& text) const = 0; ///< BasicGronsfeld::encrypt
+        virtual std::wstring decrypt(const std::wstring& text) const = 0; ///< BasicGronsfeld::decrypt
+        virtual std::string encrypt(std::string_view text) const = 0; ///< BasicGronsfeld::encrypt (UTF-8)
+        virtual std::string decrypt(std::string_view text) const = 0; ///< BasicGronsfeld::decrypt (UTF-8)
+        virtual PackedText encrypt(const PackedText& text) const = 0; ///< BasicGronsfeld::encrypt (номера)
+        virtual PackedText decrypt(const PackedText& text) const = 0; ///< BasicGronsfeld::decrypt (номера)
+        virtual std::size_t keyLength() const = 0; ///< BasicGronsfeld::keyLength
+    };
+
+    template <class Letters>
+    struct Model;
+
+    GronsfeldAlphabet id; ///< Выбранный алфавит
+    std::shared_ptr<const Concept> impl; ///< Шифр с этим алфавитом
+};
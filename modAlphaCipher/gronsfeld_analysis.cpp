@@ -0,0 +1,246 @@
+#include "gronsfeld_analysis.h"
+#include "modAlphaCipher.h"
+#include "utf8.h"
+#include <algorithm>
+#include <cstdio>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @file gronsfeld_analysis.cpp
+ * @brief Реализация восстановления ключа шифра Гронсфельда
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Частоты букв русского языка, %, в порядке алфавита modAlphaCipher (А..Я с Ё после Е)
+ */
+static const double russian_frequency[] = {
+    8.01, 1.59, 4.54, 1.70, 2.98, 8.45, 0.04, 0.94, 1.65, 7.35, 1.21,
+    3.49, 4.40, 3.21, 6.70, 10.97, 2.81, 4.73, 5.47, 6.26, 2.62, 0.26,
+    0.97, 0.48, 1.44, 0.73, 0.36, 0.04, 1.90, 1.74, 0.32, 0.64, 2.01
+};
+
+static const std::size_t letter_count = sizeof(russian_frequency) / sizeof(russian_frequency[0]); ///< Мощность алфавита
+
+/**
+ * @brief Количество совпадающих букв на заданном сдвиге
+ * @param text - номера букв
+ * @param n - длина текста
+ * @param shift - сдвиг
+ * @return Число позиций i < n - shift, где text[i] == text[i + shift]
+ */
+std::size_t coincidences(const unsigned char* text, std::size_t n, std::size_t shift)
+{
+    if (shift >= n)
+        return 0;
+    const std::size_t len = n - shift;
+    const unsigned char* a = text;
+    const unsigned char* b = text + shift;
+    std::size_t total = 0;
+    std::size_t i = 0;
+#ifdef __SSE2__
+    // Совпадение даёт байт 0xFF (-1); вычитание копит счётчик в каждом байте, 255 итераций без переполнения
+    const __m128i zero = _mm_setzero_si128();
+    while (len - i >= 16) {
+        std::size_t end = i + std::min<std::size_t>((len - i) / 16, 255) * 16;
+        __m128i acc = zero;
+        for (; i < end; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(x, y));
+        }
+        __m128i sums = _mm_sad_epu8(acc, zero);
+        total += _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+    }
+#endif
+    for (; i < len; i++)
+        total += a[i] == b[i];
+    return total;
+}
+
+/**
+ * @brief Средний индекс совпадений столбцов для длины ключа
+ * @param text - номера букв
+ * @param n - длина текста
+ * @param length - длина ключа (количество столбцов)
+ * @return Среднее по столбцам из двух и более букв значение sum f(f-1) / (N(N-1))
+ */
+static double columnIoc(const unsigned char* text, std::size_t n, std::size_t length)
+{
+    std::vector<unsigned> counts(length * letter_count);
+    std::size_t column = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        counts[column * letter_count + text[i]]++;
+        if (++column == length)
+            column = 0;
+    }
+    double sum = 0;
+    std::size_t used = 0;
+    for (std::size_t c = 0; c < length; c++) {
+        const unsigned* f = &counts[c * letter_count];
+        unsigned long long total = 0;
+        unsigned long long pairs = 0;
+        for (std::size_t k = 0; k < letter_count; k++) {
+            total += f[k];
+            pairs += static_cast<unsigned long long>(f[k]) * (f[k] > 0 ? f[k] - 1 : 0);
+        }
+        if (total < 2)
+            continue;
+        sum += double(pairs) / (double(total) * (total - 1));
+        used++;
+    }
+    return used ? sum / used : 0;
+}
+
+/**
+ * @brief Подбор буквы ключа для столбца
+ * @param text - номера букв
+ * @param n - длина текста
+ * @param length - длина ключа
+ * @param column - номер столбца
+ * @param chi_squared - минимальный хи-квадрат
+ * @return Номер буквы ключа (сдвиг столбца)
+ * @details Для сдвига k открытый текст столбца имеет частоты f[(c + k) mod 33]
+ */
+static unsigned char columnShift(const unsigned char* text, std::size_t n, std::size_t length,
+                                 std::size_t column, double& chi_squared)
+{
+    unsigned long long f[letter_count] = {};
+    unsigned long long total = 0;
+    for (std::size_t i = column; i < n; i += length) {
+        f[text[i]]++;
+        total++;
+    }
+    unsigned char best = 0;
+    chi_squared = 0;
+    for (std::size_t k = 0; k < letter_count; k++) {
+        double chi = 0;
+        for (std::size_t c = 0; c < letter_count; c++) {
+            double expected = russian_frequency[c] / 100 * total;
+            double d = f[(c + k) % letter_count] - expected;
+            chi += d * d / expected;
+        }
+        if (k == 0 || chi < chi_squared) {
+            chi_squared = chi;
+            best = k;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Восстановление ключа по шифртексту
+ * @param cipher_text - шифртекст, закодированный алфавитом modAlphaCipher::alphabet()
+ * @param pool - пул потоков
+ * @param max_length - наибольшая проверяемая длина ключа
+ * @return Оценки длин, выбранная длина и ключ
+ * @throw cipher_error если в шифртексте меньше двух букв
+ */
+KeyRecovery recoverKey(const PackedText& cipher_text, ThreadPool& pool, std::size_t max_length)
+{
+    const unsigned char* text = cipher_text.data();
+    const std::size_t n = cipher_text.size();
+    if (n < 2)
+        throw cipher_error("Cipher text too short");
+    max_length = std::max<std::size_t>(1, std::min(max_length, n / 2));
+
+    // Сдвиги для автокорреляции: у каждой длины не меньше четырёх кратных
+    const std::size_t max_shift = std::min(4 * max_length, n - 1);
+    std::vector<std::size_t> same(max_shift + 1);
+    pool.parallelFor(max_shift, [&](std::size_t s) {
+        same[s + 1] = coincidences(text, n, s + 1);
+    });
+
+    KeyRecovery result;
+    result.letters = n;
+    result.scores.resize(max_length);
+    pool.parallelFor(max_length, [&](std::size_t i) {
+        KeyLengthScore& score = result.scores[i];
+        score.length = i + 1;
+        score.ioc = columnIoc(text, n, score.length);
+        unsigned long long hits = 0;
+        unsigned long long pairs = 0;
+        for (std::size_t s = score.length; s <= max_shift; s += score.length) {
+            hits += same[s];
+            pairs += n - s;
+        }
+        score.autocorrelation = pairs ? double(hits) / pairs : 0;
+    });
+
+    const double random = 1.0 / letter_count;
+    double best = -1;
+    for (const KeyLengthScore& score : result.scores) {
+        double value = (score.ioc + score.autocorrelation) / 2;
+        if (value > best) {
+            best = value;
+            result.key_length = score.length;
+        }
+    }
+    const double threshold = random + 0.8 * (best - random);
+    for (const KeyLengthScore& score : result.scores) {
+        if ((score.ioc + score.autocorrelation) / 2 >= threshold) {
+            result.key_length = std::min(result.key_length, score.length);
+            break;
+        }
+    }
+
+    const std::size_t length = result.key_length;
+    std::vector<unsigned char> shifts(length);
+    std::vector<double> chi(length);
+    pool.parallelFor(length, [&](std::size_t c) {
+        shifts[c] = columnShift(text, n, length, c, chi[c]);
+    });
+    for (std::size_t c = 0; c < length; c++) {
+        char buffer[4];
+        result.key.append(buffer, utf8Encode(modAlphaCipher::alphabet().symbol(shifts[c]), buffer));
+        result.chi_squared += chi[c] / length;
+    }
+    return result;
+}
+
+/**
+ * @brief Восстановление ключа по шифртексту в UTF-8
+ * @param cipher_text - шифртекст; не-буквы пропускаются, строчные буквы считаются заглавными
+ * @param pool - пул потоков
+ * @param max_length - наибольшая проверяемая длина ключа
+ * @return Оценки длин, выбранная длина и ключ
+ * @throw cipher_error если текст не в UTF-8, содержит буквы вне алфавита или меньше двух букв
+ */
+KeyRecovery recoverKey(std::string_view cipher_text, ThreadPool& pool, std::size_t max_length)
+{
+    PackedText packed;
+    cipher_status status = PackedText::fromOpenText(cipher_text, modAlphaCipher::alphabet(), packed);
+    if (!status && status.error != cipher_errc::empty_open_text)
+        throw cipher_error("Invalid cipher text");
+    return recoverKey(packed, pool, max_length);
+}
+
+/**
+ * @brief Результат восстановления в JSON
+ * @param recovery - результат
+ * @param seconds - время анализа в секундах
+ * @return Текст JSON с переводом строки в конце
+ */
+std::string formatRecovery(const KeyRecovery& recovery, double seconds)
+{
+    char line[256];
+    std::snprintf(line, sizeof line,
+                  "{\n  \"letters\": %zu,\n  \"seconds\": %.6f,\n  \"key_length\": %zu,\n  \"key\": \"",
+                  recovery.letters, seconds, recovery.key_length);
+    std::string result = line;
+    result += recovery.key;
+    std::snprintf(line, sizeof line, "\",\n  \"chi_squared\": %.2f,\n  \"lengths\": [\n", recovery.chi_squared);
+    result += line;
+    for (std::size_t i = 0; i < recovery.scores.size(); i++) {
+        const KeyLengthScore& score = recovery.scores[i];
+        std::snprintf(line, sizeof line, "    {\"length\": %zu, \"ioc\": %.5f, \"autocorrelation\": %.5f}%s\n",
+                      score.length, score.ioc, score.autocorrelation, i + 1 < recovery.scores.size() ? "," : "");
+        result += line;
+    }
+    result += "  ]\n}\n";
+    return result;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "packed_text.h"
+#include "thread_pool.h"
+
+/**
+ * @file gronsfeld_analysis.h
+ * @brief Восстановление ключа шифра Гронсфельда по шифртексту
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Длина ключа оценивается двумя способами. Индекс совпадений столбцов: текст
+ * раскладывается на L столбцов, и для правильной длины каждый столбец сдвинут одной
+ * буквой ключа, поэтому сохраняет индекс совпадений русского языка (около 0,055),
+ * а при неправильной длине приближается к 1/33. Автокорреляция шифртекста: доля
+ * позиций i, где буквы i и i + s совпадают, велика, когда s кратно длине ключа; эта
+ * доля считается векторно по 16 байтов. Затем каждая буква ключа подбирается по
+ * минимуму хи-квадрат между частотами букв столбца и частотами русского языка
+ * в алфавите modAlphaCipher. Длины ключа и столбцы обрабатываются параллельно в пуле потоков.
+ */
+
+/**
+ * @brief Оценка одной длины ключа
+ */
+struct KeyLengthScore {
+    std::size_t length = 0; ///< Длина ключа
+    double ioc = 0; ///< Средний индекс совпадений столбцов
+    double autocorrelation = 0; ///< Доля совпадающих букв на сдвигах, кратных длине
+};
+
+/**
+ * @brief Результат восстановления ключа
+ */
+struct KeyRecovery {
+    std::size_t letters = 0; ///< Количество букв шифртекста
+    std::vector<KeyLengthScore> scores; ///< Оценки длин 1..max_length
+    std::size_t key_length = 0; ///< Выбранная длина ключа
+    std::string key; ///< Восстановленный ключ в UTF-8
+    double chi_squared = 0; ///< Средний хи-квадрат столбцов для найденного ключа
+};
+
+static const std::size_t default_max_key_length = 32; ///< Наибольшая проверяемая длина ключа по умолчанию
+static const std::size_t max_key_length_limit = 1000; ///< Предел для --max-key: оценка каждой длины - отдельный проход по тексту
+
+/**
+ * @brief Количество совпадающих букв на заданном сдвиге
+ * @param text - номера букв
+ * @param n - длина текста
+ * @param shift - сдвиг
+ * @return Число позиций i < n - shift, где text[i] == text[i + shift]
+ * @details На x86 сравнивается по 16 байтов (SSE2), совпадения копятся в байтовых
+ * счётчиках и сбрасываются в общую сумму каждые 255 итераций
+ */
+std::size_t coincidences(const unsigned char* text, std::size_t n, std::size_t shift);
+
+/**
+ * @brief Восстановление ключа по шифртексту
+ * @param cipher_text - шифртекст, закодированный алфавитом modAlphaCipher::alphabet()
+ * @param pool - пул потоков
+ * @param max_length - наибольшая проверяемая длина ключа
+ * @return Оценки длин, выбранная длина и ключ
+ * @throw cipher_error если в шифртексте меньше двух букв
+ * @details Выбирается наименьшая длина, чья оценка не хуже 80% от лучшей над уровнем
+ * случайного текста: кратные правильной длины оцениваются так же высоко, как она сама
+ */
+KeyRecovery recoverKey(const PackedText& cipher_text, ThreadPool& pool,
+                       std::size_t max_length = default_max_key_length);
+
+/**
+ * @brief Восстановление ключа по шифртексту в UTF-8
+ * @param cipher_text - шифртекст; не-буквы пропускаются, строчные буквы считаются заглавными
+ * @param pool - пул потоков
+ * @param max_length - наибольшая проверяемая длина ключа
+ * @return Оценки длин, выбранная длина и ключ
+ * @throw cipher_error если текст не в UTF-8, содержит буквы вне алфавита или меньше двух букв
+ */
+KeyRecovery recoverKey(std::string_view cipher_text, ThreadPool& pool,
+                       std::size_t max_length = default_max_key_length);
+
+/**
+ * @brief Результат восстановления в JSON
+ * @param recovery - результат
+ * @param seconds - время анализа в секундах
+ * @return Текст JSON с переводом строки в конце
+ */
+std::string formatRecovery(const KeyRecovery& recovery, double seconds);
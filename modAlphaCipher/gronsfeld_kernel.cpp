@@ -0,0 +1,180 @@
+#include "gronsfeld_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GRONSFELD_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @file gronsfeld_kernel.cpp
+ * @brief Реализация векторных ядер шифра Гронсфельда и выбора варианта во время выполнения
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Векторные варианты используют приём s' = min(s, s - m) над беззнаковыми байтами:
+ * при s < m разность переполняется и становится больше s, при s >= m она меньше s.
+ * Это одно сравнение и одно вычитание без ветвлений; сумма s не превышает 2m - 2,
+ * поэтому m ограничено 128.
+ */
+
+/**
+ * @brief Скалярный вариант ядра
+ * @details Используется для хвостов векторных вариантов и на процессорах без SIMD
+ */
+static void addScalar(const unsigned char* in, const unsigned char* ks,
+                      unsigned char* out, std::size_t n, unsigned char m)
+{
+    for (std::size_t i = 0; i < n; i++) {
+        unsigned s = in[i] + ks[i];
+        out[i] = static_cast<unsigned char>(s >= m ? s - m : s);
+    }
+}
+
+#ifdef GRONSFELD_X86
+
+/**
+ * @brief Вариант ядра на SSE2 (16 байт за итерацию)
+ */
+__attribute__((target("sse2")))
+static void addSSE2(const unsigned char* in, const unsigned char* ks,
+                    unsigned char* out, std::size_t n, unsigned char m)
+{
+    const __m128i vm = _mm_set1_epi8(static_cast<char>(m));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i s = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(ks + i)));
+        s = _mm_min_epu8(s, _mm_sub_epi8(s, vm));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), s);
+    }
+    addScalar(in + i, ks + i, out + i, n - i, m);
+}
+
+/**
+ * @brief Вариант ядра на AVX2 (32 байта за итерацию)
+ */
+__attribute__((target("avx2")))
+static void addAVX2(const unsigned char* in, const unsigned char* ks,
+                    unsigned char* out, std::size_t n, unsigned char m)
+{
+    const __m256i vm = _mm256_set1_epi8(static_cast<char>(m));
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i s = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ks + i)));
+        s = _mm256_min_epu8(s, _mm256_sub_epi8(s, vm));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), s);
+    }
+    addScalar(in + i, ks + i, out + i, n - i, m);
+}
+
+/**
+ * @brief Вариант ядра на AVX-512BW (64 байта за итерацию)
+ */
+__attribute__((target("avx512f,avx512bw")))
+static void addAVX512(const unsigned char* in, const unsigned char* ks,
+                      unsigned char* out, std::size_t n, unsigned char m)
+{
+    const __m512i vm = _mm512_set1_epi8(static_cast<char>(m));
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512i s = _mm512_add_epi8(_mm512_loadu_si512(in + i), _mm512_loadu_si512(ks + i));
+        s = _mm512_min_epu8(s, _mm512_sub_epi8(s, vm));
+        _mm512_storeu_si512(out + i, s);
+    }
+    addScalar(in + i, ks + i, out + i, n - i, m);
+}
+
+#endif
+
+/**
+ * @brief Проверка, может ли текущий процессор выполнить вариант ядра
+ * @param isa - набор инструкций
+ * @return true если вариант собран и поддерживается процессором
+ */
+bool kernelSupported(KernelIsa isa)
+{
+    switch (isa) {
+    case KernelIsa::Scalar:
+        return true;
+#ifdef GRONSFELD_X86
+    case KernelIsa::SSE2:
+        return __builtin_cpu_supports("sse2");
+    case KernelIsa::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case KernelIsa::AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Получение конкретного варианта ядра
+ * @param isa - набор инструкций
+ * @return Указатель на ядро или nullptr, если вариант не поддерживается
+ */
+GronsfeldKernel kernelFor(KernelIsa isa)
+{
+    if (!kernelSupported(isa))
+        return nullptr;
+    switch (isa) {
+#ifdef GRONSFELD_X86
+    case KernelIsa::SSE2:
+        return addSSE2;
+    case KernelIsa::AVX2:
+        return addAVX2;
+    case KernelIsa::AVX512:
+        return addAVX512;
+#endif
+    default:
+        return addScalar;
+    }
+}
+
+/**
+ * @brief Имя варианта ядра для вывода
+ * @param isa - набор инструкций
+ * @return Строка с названием набора инструкций
+ */
+const char* kernelName(KernelIsa isa)
+{
+    switch (isa) {
+    case KernelIsa::SSE2:
+        return "SSE2";
+    case KernelIsa::AVX2:
+        return "AVX2";
+    case KernelIsa::AVX512:
+        return "AVX-512";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * @brief Самый быстрый вариант, поддерживаемый процессором
+ * @return Набор инструкций, выбранный при первом вызове
+ */
+KernelIsa bestKernelIsa()
+{
+    static const KernelIsa best = [] {
+        const KernelIsa order[] = { KernelIsa::AVX512, KernelIsa::AVX2, KernelIsa::SSE2 };
+        for (KernelIsa isa : order) {
+            if (kernelSupported(isa))
+                return isa;
+        }
+        return KernelIsa::Scalar;
+    }();
+    return best;
+}
+
+/**
+ * @brief Самое быстрое ядро, поддерживаемое процессором
+ * @return Указатель на ядро, выбранное при первом вызове
+ */
+GronsfeldKernel gronsfeldKernel()
+{
+    static const GronsfeldKernel kernel = kernelFor(bestKernelIsa());
+    return kernel;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @file gronsfeld_kernel.h
+ * @brief Векторные ядра сложения по модулю для шифра Гронсфельда
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ * @details Ядро вычисляет out[i] = (in[i] + ks[i]) mod m над однобайтовыми номерами букв
+ * и заранее развёрнутым ключевым потоком ks. Деление по модулю заменено сравнением
+ * и вычитанием. Вариант выбирается один раз во время выполнения по возможностям процессора.
+ */
+
+/**
+ * @brief Набор инструкций, под который собрано ядро
+ */
+enum class KernelIsa {
+    Scalar, ///< Переносимый скалярный вариант
+    SSE2,   ///< 16 байт за итерацию
+    AVX2,   ///< 32 байта за итерацию
+    AVX512  ///< 64 байта за итерацию (AVX-512BW)
+};
+
+/**
+ * @brief Сигнатура ядра сложения по модулю
+ * @param in - номера букв текста (каждый меньше m)
+ * @param ks - ключевой поток (каждый элемент меньше m)
+ * @param out - результат (может совпадать с in)
+ * @param n - количество элементов
+ * @param m - мощность алфавита (не больше 128)
+ */
+typedef void (*GronsfeldKernel)(const unsigned char* in, const unsigned char* ks,
+                                unsigned char* out, std::size_t n, unsigned char m);
+
+/**
+ * @brief Проверка, может ли текущий процессор выполнить вариант ядра
+ * @param isa - набор инструкций
+ * @return true если вариант собран и поддерживается процессором
+ */
+bool kernelSupported(KernelIsa isa);
+
+/**
+ * @brief Получение конкретного варианта ядра
+ * @param isa - набор инструкций
+ * @return Указатель на ядро или nullptr, если вариант не поддерживается
+ */
+GronsfeldKernel kernelFor(KernelIsa isa);
+
+/**
+ * @brief Имя варианта ядра для вывода
+ * @param isa - набор инструкций
+ * @return Строка с названием набора инструкций
+ */
+const char* kernelName(KernelIsa isa);
+
+/**
+ * @brief Самый быстрый вариант, поддерживаемый процессором
+ * @return Набор инструкций, выбранный при первом вызове
+ */
+KernelIsa bestKernelIsa();
+
+/**
+ * @brief Самое быстрое ядро, поддерживаемое процессором
+ * @return Указатель на ядро, выбранное при первом вызове
+ */
+GronsfeldKernel gronsfeldKernel();
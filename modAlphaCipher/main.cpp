@@ -1,7 +1,21 @@
+#include <chrono>
+#include <cwchar>
 #include <iostream>
 #include <locale>
-#include <codecvt>
+#include <system_error>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
 #include "modAlphaCipher.h"
+#include "gronsfeld.h"
+#include "modAlphaStream.h"
+#include "gronsfeld_kernel.h"
+#include "file_mode.h"
+#include "file_pipeline.h"
+#include "gronsfeld_analysis.h"
+#include "mapped_file.h"
 
 /**
  * @file main.cpp
@@ -47,6 +61,451 @@ void check(const std::wstring& Text, const std::wstring& key, bool destructCiphe
     std::wcout << std::endl;
 }
 
+/**
+ * @brief Проверка совпадения векторных ядер со скалярным
+ * @return true если все поддерживаемые процессором ядра совпали со скалярным
+ * @details Для каждого варианта ядра сравнивает результат со скалярным на
+ * псевдослучайных данных всех длин до 300 и с невыровненным началом,
+ * включая крайнюю сумму (m - 1) + (m - 1). Ядра, которые процессор
+ * не поддерживает, пропускаются
+ */
+bool checkKernels()
+{
+    const unsigned char m = 33;
+    const std::size_t size = 320;
+    std::vector<unsigned char> in(size), ks(size), expected(size), actual(size);
+    unsigned seed = 1;
+    for (std::size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        in[i] = (seed >> 16) % m;
+        ks[i] = (seed >> 8) % m;
+    }
+    for (std::size_t i = size - 40; i < size; i++)
+        in[i] = ks[i] = m - 1;
+
+    GronsfeldKernel scalar = kernelFor(KernelIsa::Scalar);
+    const KernelIsa variants[] = { KernelIsa::SSE2, KernelIsa::AVX2, KernelIsa::AVX512 };
+    for (KernelIsa isa : variants) {
+        GronsfeldKernel kernel = kernelFor(isa);
+        if (kernel == nullptr)
+            continue;
+        for (std::size_t off = 0; off < 8; off++) {
+            for (std::size_t n = 0; off + n <= size && n <= 300; n++) {
+                scalar(&in[off], &ks[off], &expected[0], n, m);
+                kernel(&in[off], &ks[off], &actual[0], n, m);
+                if (!std::equal(expected.begin(), expected.begin() + n, actual.begin()))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Проверка общего сдвига на тексте длиннее блока ядра
+ * @param cipher - шифр с установленным ключом
+ * @return true если широкие строки, UTF-8, PackedText и шифрование фрагментами
+ * совпали с побуквенным сложением номеров по модулю
+ * @details Текст из нескольких блоков BasicGronsfeld::block_size с буквами обоих
+ * регистров и небуквенными символами сверяется с суммой номеров буквы и ключа
+ * keyShift(). Фрагменты режутся рядом с границами блока, чтобы блоки начинались
+ * с разных позиций ключа
+ */
+bool checkBlocks(const modAlphaCipher& cipher)
+{
+    const Alphabet& alphabet = modAlphaCipher::alphabet();
+    const std::size_t block = BasicGronsfeld<RussianLetters>::block_size;
+    const std::wstring source = L"Съешь же ещё этих мягких французских булок, да выпей чаю! 123 ";
+    std::wstring text, plain, expected;
+    while (plain.size() < 3 * block + 37) {
+        text += source;
+        for (wchar_t c : source) {
+            if (!isLetter(c))
+                continue;
+            int a = alphabet.index(toUpperLetter(c));
+            expected += alphabet.symbol((a + cipher.keyShift(plain.size())) % alphabet.size());
+            plain += alphabet.symbol(a);
+        }
+    }
+    auto utf8 = [](const std::wstring& s) {
+        std::string result;
+        char buffer[4];
+        for (wchar_t c : s)
+            result.append(buffer, utf8Encode(c, buffer));
+        return result;
+    };
+    const std::size_t cuts[] = { 1, block - 1, block, block + 1, 2 * block + 5, text.size() };
+
+    try {
+        if (cipher.encrypt(text) != expected || cipher.decrypt(expected) != plain)
+            return false;
+        if (cipher.encrypt(std::string_view(utf8(text))) != utf8(expected) ||
+            cipher.decrypt(std::string_view(utf8(expected))) != utf8(plain))
+            return false;
+        PackedText packed;
+        if (!PackedText::fromOpenText(text, alphabet, packed).ok() ||
+            cipher.encrypt(packed).toWide(alphabet) != expected ||
+            cipher.decrypt(cipher.encrypt(packed)).toWide(alphabet) != plain)
+            return false;
+
+        std::wstring out(text.size(), L'\0');
+        std::wstring encrypted;
+        unsigned long long position = 0;
+        std::size_t from = 0;
+        for (std::size_t cut : cuts) {
+            std::size_t n = cipher.encrypt_chunk(text.data() + from, cut - from, &out[0], out.size(), position);
+            encrypted.append(out, 0, n);
+            from = cut;
+        }
+        if (encrypted != expected || position != plain.size())
+            return false;
+        std::wstring decrypted;
+        position = 0;
+        from = 0;
+        for (std::size_t cut : cuts) {
+            cut = std::min(cut, expected.size());
+            std::size_t n = cipher.decrypt_chunk(expected.data() + from, cut - from, &out[0], out.size(), position);
+            decrypted.append(out, 0, n);
+            from = cut;
+        }
+        return decrypted == plain && position == plain.size();
+    } catch (const cipher_error&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Проверка одновременных вызовов одного экземпляра шифра из нескольких потоков
+ * @param cipher - общий неизменяемый экземпляр шифра
+ * @return true если все результаты совпали с ожидаемыми
+ * @details Потоки шифруют и расшифровывают разные тексты через один const-объект,
+ * сравнивают шифртекст с однопоточным, а расшифровку - с очищенным исходным текстом.
+ * Для поиска гонок программу следует собрать целью make tsan (ThreadSanitizer),
+ * которая запускает эту проверку через --self-test
+ */
+bool checkConcurrent(const modAlphaCipher& cipher)
+{
+    struct Sample {
+        std::wstring text; ///< Открытый текст
+        std::wstring plain; ///< Ожидаемый результат decrypt(encrypt(text))
+    };
+    const Sample samples[] = {
+        {L"ПРИВЕТ", L"ПРИВЕТ"},
+        {L"Шифр Гронсфельда", L"ШИФРГРОНСФЕЛЬДА"},
+        {L"Съешь же ещё этих мягких французских булок, да выпей чаю",
+         L"СЪЕШЬЖЕЕЩЁЭТИХМЯГКИХФРАНЦУЗСКИХБУЛОКДАВЫПЕЙЧАЮ"},
+        {L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ", L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"}
+    };
+    const std::size_t count = sizeof samples / sizeof samples[0];
+    std::vector<std::wstring> expected;
+    try {
+        for (const auto& sample : samples)
+            expected.push_back(cipher.encrypt(sample.text));
+    } catch (const cipher_error&) {
+        return false;
+    }
+
+    const unsigned threads = std::max(4u, std::thread::hardware_concurrency());
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            try {
+                for (std::size_t round = 0; round < 1000; round++) {
+                    std::size_t i = (t + round) % count;
+                    std::wstring cipherText = cipher.encrypt(samples[i].text);
+                    if (cipherText != expected[i] || cipher.decrypt(cipherText) != samples[i].plain)
+                        ok = false;
+                }
+            } catch (const cipher_error&) {
+                ok = false;
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    return ok;
+}
+
+/**
+ * @brief Прогон текста через потоковый шифр, разрезанного в заданной позиции
+ * @param cipher - шифр с установленным ключом
+ * @param mode - направление преобразования
+ * @param text - текст в UTF-8
+ * @param cut - позиция разреза в байтах (может попасть внутрь символа)
+ * @return Результат обеих частей
+ * @throw cipher_error если текст некорректен
+ */
+static std::string streamTwoParts(const modAlphaCipher& cipher, modAlphaStream::Mode mode,
+                                  const std::string& text, std::size_t cut)
+{
+    modAlphaStream stream(cipher, mode);
+    std::string result = stream.update(text.substr(0, cut));
+    result += stream.update(text.substr(cut));
+    stream.finish();
+    return result;
+}
+
+/**
+ * @brief Ожидание ошибки шифра с заданным видом
+ * @param action - вызов, который должен выбросить cipher_error
+ * @param error - ожидаемый вид ошибки
+ * @return true если выброшено исключение с текстом statusMessage(error)
+ */
+template <class Action>
+static bool throwsCipherError(Action action, cipher_errc error)
+{
+    try {
+        action();
+    } catch (const cipher_error& e) {
+        return std::string(e.what()) == statusMessage(error);
+    }
+    return false;
+}
+
+/**
+ * @brief Проверка потокового шифрования UTF-8 на всех разбиениях текста
+ * @param cipher - шифр с установленным ключом
+ * @return true если результаты совпали с однократным шифрованием
+ * @details Текст режется на две части в каждой байтовой позиции, в том числе внутри
+ * символов, и подаётся побайтно; шифртекст расшифровывается так же. Поток,
+ * оборванный посреди символа или не содержащий букв, должен завершаться ошибкой,
+ * а фрагмент с ошибкой - не менять состояние потока. Локаль не используется
+ */
+bool checkStream(const modAlphaCipher& cipher)
+{
+    const std::string text = "Съешь же ещё этих мягких французских булок, да выпей чаю";
+    const modAlphaStream::Mode enc = modAlphaStream::Mode::Encrypt;
+    const modAlphaStream::Mode dec = modAlphaStream::Mode::Decrypt;
+    try {
+        const std::string expected = cipher.encrypt(std::string_view(text));
+        const std::string plain = cipher.decrypt(std::string_view(expected));
+        for (std::size_t cut = 0; cut <= text.size(); cut++) {
+            if (streamTwoParts(cipher, enc, text, cut) != expected)
+                return false;
+        }
+        for (std::size_t cut = 0; cut <= expected.size(); cut++) {
+            if (streamTwoParts(cipher, dec, expected, cut) != plain)
+                return false;
+        }
+
+        modAlphaStream bytes(cipher, enc);
+        std::string result;
+        for (char b : text)
+            result += bytes.update(std::string(1, b));
+        bytes.finish();
+        if (result != expected)
+            return false;
+    } catch (const cipher_error&) {
+        return false;
+    }
+
+    modAlphaStream truncated(cipher, enc);
+    truncated.update(text.substr(0, 1));
+    if (!throwsCipherError([&] { truncated.finish(); }, cipher_errc::invalid_utf8))
+        return false;
+
+    modAlphaStream empty(cipher, enc);
+    empty.update("123, !");
+    if (!throwsCipherError([&] { empty.finish(); }, cipher_errc::empty_open_text))
+        return false;
+    modAlphaStream empty_dec(cipher, dec);
+    if (!throwsCipherError([&] { empty_dec.finish(); }, cipher_errc::empty_cipher_text))
+        return false;
+
+    // "ё" разрезана между фрагментами; отклонённый фрагмент не должен сдвинуть ни ключ, ни перенос
+    modAlphaStream retry(cipher, enc);
+    std::string result = retry.update("Пр\xd1");
+    if (!throwsCipherError([&] { retry.update("\x91w"); }, cipher_errc::not_in_alphabet))
+        return false;
+    result += retry.update("\x91вет");
+    retry.finish();
+    return result == cipher.encrypt(std::string_view("Прёвет"));
+}
+
+/**
+ * @brief Проверка API без исключений на заведомо некорректных записях
+ * @param cipher - шифр с установленным ключом
+ * @param log - поток для вида ошибки и позиции каждой записи (nullptr - без вывода)
+ * @return true если все виды ошибок и позиции совпали с ожидаемыми
+ * @details Для каждой записи в UTF-8 сверяет вид ошибки и позицию первого
+ * недопустимого символа (в байтах) с ожидаемыми
+ */
+bool checkStatus(const modAlphaCipher& cipher, std::wostream* log)
+{
+    struct Record {
+        std::string text; ///< Запись в UTF-8
+        bool encrypt; ///< Направление преобразования
+        cipher_errc error; ///< Ожидаемый вид ошибки
+        std::size_t offset; ///< Ожидаемая позиция
+    };
+    const Record records[] = {
+        {"Привет, мир", true, cipher_errc::ok, 0},
+        {"Привет, world", true, cipher_errc::not_in_alphabet, 14},
+        {"Привет\xff", true, cipher_errc::invalid_utf8, 12},
+        {"123", true, cipher_errc::empty_open_text, 0},
+        {"ПРИВЕТ", false, cipher_errc::ok, 0},
+        {"ПРИвЕТ", false, cipher_errc::invalid_cipher_text, 6},
+        {"", false, cipher_errc::empty_cipher_text, 0}
+    };
+    bool ok = true;
+    std::string out;
+    for (const auto& r : records) {
+        out.assign(r.text.size(), '\0');
+        std::size_t written;
+        cipher_status status = r.encrypt
+            ? cipher.try_encrypt_into(r.text.data(), r.text.size(), &out[0], out.size(), written)
+            : cipher.try_decrypt_into(r.text.data(), r.text.size(), &out[0], out.size(), written);
+        if (log)
+            *log << L"error=" << static_cast<int>(status.error) << L" offset=" << status.offset << std::endl;
+        if (status.error != r.error || status.offset != r.offset)
+            ok = false;
+    }
+    cipher_status key = modAlphaCipher::checkKey(std::string_view("КЛЮЧ1"));
+    if (key.error != cipher_errc::invalid_key || key.offset != 8)
+        ok = false;
+    return ok;
+}
+
+/**
+ * @brief Проверка 6-битной упаковки PackedText
+ * @return true если toBits6()/fromBits6() восстанавливают текст
+ * @details Длины от 0 до 13 и 33 дают все остатки от деления на 4 (неполную последнюю
+ * группу из трёх байтов); каждый номер от 0 до 63 встречается в каждой позиции группы.
+ * Текст из всех букв русского алфавита проходит через fromOpenText и toWide, а номер
+ * больше 63 и усечённые байты должны отклоняться
+ */
+static bool checkBits6()
+{
+    const std::size_t lengths[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 33 };
+    for (std::size_t length : lengths) {
+        for (unsigned start = 0; start < 64; start++) {
+            std::vector<unsigned char> indices(length);
+            for (std::size_t i = 0; i < length; i++)
+                indices[i] = (start + i * 5) % 64;
+            const PackedText text(indices);
+            const std::vector<unsigned char> bits = text.toBits6();
+            if (bits.size() != (length * 6 + 7) / 8 || !(PackedText::fromBits6(bits, length) == text))
+                return false;
+        }
+    }
+
+    const Alphabet& alphabet = modAlphaCipher::alphabet();
+    const std::wstring letters = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    PackedText packed;
+    if (!PackedText::fromOpenText(letters, alphabet, packed).ok() || packed.size() != letters.size())
+        return false;
+    const PackedText restored = PackedText::fromBits6(packed.toBits6(), packed.size());
+    if (!(restored == packed) || restored.toWide(alphabet) != letters)
+        return false;
+
+    try {
+        PackedText(std::vector<unsigned char>{ 1, 64 }).toBits6();
+        return false;
+    } catch (const std::length_error&) {
+    }
+    try {
+        PackedText::fromBits6(std::vector<unsigned char>(2), 3);
+        return false;
+    } catch (const std::length_error&) {
+    }
+    return true;
+}
+
+/**
+ * @brief Проверка GronsfeldCipher со всеми алфавитами
+ * @return true если для каждого алфавита шифрование обратимо в широких строках, UTF-8
+ * и номерах букв, представления согласованы, а буквы и ключи вне алфавита отклоняются
+ */
+static bool checkGronsfeldAlphabets()
+{
+    struct Case {
+        GronsfeldAlphabet alphabet; ///< Алфавит
+        const wchar_t* key; ///< Ключ
+        const wchar_t* text; ///< Открытый текст
+        const char* utf8; ///< Тот же текст в UTF-8
+        const wchar_t* plain; ///< Очищенный открытый текст
+        const wchar_t* foreign; ///< Текст с буквой вне алфавита
+        const wchar_t* foreign_key; ///< Ключ с буквой вне алфавита
+    };
+    const Case cases[] = {
+        {GronsfeldAlphabet::russian, L"КЛЮЧ", L"Ёлка, привет!", "Ёлка, привет!", L"ЁЛКАПРИВЕТ",
+         L"Привет, world", L"КЛЮЧ1"},
+        {GronsfeldAlphabet::russian_no_yo, L"КЛЮЧ", L"Ель, привет!", "Ель, привет!", L"ЕЛЬПРИВЕТ",
+         L"Ёлка", L"ЁЖ"},
+        {GronsfeldAlphabet::latin, L"KEY", L"Hello, world!", "Hello, world!", L"HELLOWORLD",
+         L"Hello, мир", L"КЛЮЧ"}
+    };
+    try {
+        for (const Case& t : cases) {
+            const GronsfeldCipher cipher(t.alphabet, t.key);
+            if (cipher.alphabetId() != t.alphabet || cipher.keyLength() != std::wcslen(t.key))
+                return false;
+            const std::wstring encrypted = cipher.encrypt(std::wstring(t.text));
+            if (encrypted.size() != std::wcslen(t.plain) || cipher.decrypt(encrypted) != t.plain)
+                return false;
+            const std::string encrypted_utf8 = cipher.encrypt(std::string_view(t.utf8));
+            PackedText packed;
+            if (!PackedText::fromOpenText(std::wstring(t.text), cipher.alphabet(), packed).ok())
+                return false;
+            const PackedText packed_encrypted = cipher.encrypt(packed);
+            if (packed_encrypted.toWide(cipher.alphabet()) != encrypted ||
+                packed_encrypted.toUtf8(cipher.alphabet()) != encrypted_utf8 ||
+                !(cipher.decrypt(packed_encrypted) == packed) ||
+                cipher.decrypt(std::string_view(encrypted_utf8)) != packed.toUtf8(cipher.alphabet()))
+                return false;
+
+            if (!throwsCipherError([&] { cipher.encrypt(std::wstring(t.foreign)); }, cipher_errc::not_in_alphabet))
+                return false;
+            const cipher_status key = GronsfeldCipher::checkKey(t.alphabet, t.foreign_key);
+            if (key.ok() || !throwsCipherError([&] { GronsfeldCipher(t.alphabet, t.foreign_key); }, key.error))
+                return false;
+        }
+        // Известный ответ для латиницы: сдвиги K=10, E=4, Y=24
+        if (GronsfeldCipher(GronsfeldAlphabet::latin, L"KEY").encrypt(std::wstring(L"HELLO")) != L"RIJVS")
+            return false;
+    } catch (const cipher_error&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Печать результата проверки
+ * @param name - название проверки
+ * @param ok - результат
+ * @return ok
+ */
+static bool report(const char* name, bool ok)
+{
+    std::cout << name << ": " << (ok ? "Ok" : "Err") << std::endl;
+    return ok;
+}
+
+/**
+ * @brief Неинтерактивная проверка шифра
+ * @return 0 если все проверки прошли, 1 при ошибке
+ * @details Запускается с --self-test из целей make test и make tsan, без ввода
+ * и без локали: сверяет векторные ядра со скалярным, сдвиг текста блоками ядра,
+ * одновременные вызовы шифра,
+ * потоковое шифрование modAlphaStream, виды ошибок API без исключений,
+ * 6-битную упаковку PackedText и GronsfeldCipher со всеми алфавитами.
+ * Результат каждой проверки печатается отдельной строкой
+ */
+int selfTest()
+{
+    const modAlphaCipher cipher(std::string_view("МОРОЗКО"));
+    bool ok = true;
+    ok &= report("kernels", checkKernels());
+    ok &= report("blocks", checkBlocks(cipher));
+    ok &= report("concurrent", checkConcurrent(cipher));
+    ok &= report("stream", checkStream(cipher));
+    ok &= report("status", checkStatus(cipher, nullptr));
+    ok &= report("bits6", checkBits6());
+    ok &= report("alphabets", checkGronsfeldAlphabets());
+    return ok ? 0 : 1;
+}
+
 /**
  * @brief Интерактивный режим работы программы
  * @details Позволяет пользователю вводить ключ, шифровать/дешифровать тексты
@@ -97,6 +556,11 @@ void interactiveMode()
                 check(L"123456", key);
                 check(L"", key);
                 check(L"ПРИВЕТ", key, true);
+                std::wcout << L"kernels: " << (checkKernels() ? L"Ok\n" : L"Err\n") << std::endl;
+                std::wcout << L"blocks: " << (checkBlocks(cipher) ? L"Ok\n" : L"Err\n") << std::endl;
+                std::wcout << L"concurrent: " << (checkConcurrent(cipher) ? L"Ok\n" : L"Err\n") << std::endl;
+                std::wcout << L"stream: " << (checkStream(cipher) ? L"Ok\n" : L"Err\n") << std::endl;
+                std::wcout << L"status: " << (checkStatus(cipher, &std::wcout) ? L"Ok\n" : L"Err\n") << std::endl;
             } else if (operation != 0) {
                 std::wcout << L"Неверная операция!" << std::endl;
             }
@@ -109,13 +573,176 @@ void interactiveMode()
     }
 }
 
+/**
+ * @brief Неинтерактивная обработка файла
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
+ * @return 0 при успешном завершении, 1 при ошибке
+ * @details Файл обрабатывается в UTF-8 через отображение в память, без локали и широких потоков.
+ * С --pipeline файл обрабатывается блоками с переносом позиции ключа между ними.
+ * С --stats статистика шифра печатается и при ошибке
+ */
+int fileMode(int argc, char* argv[])
+{
+    FileJob job;
+    try {
+        job = parseFileJob(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n"
+                  << fileModeUsage(argv[0], "буквы русского алфавита");
+        return 1;
+    }
+
+    int result = 0;
+    try {
+        modAlphaCipher cipher(std::string_view(job.key));
+        if (job.pipeline) {
+            // Позиция ключа переходит от блока к блоку, поэтому результат совпадает с encrypt_into
+            unsigned long long key_position = 0;
+            runPipelinedFileJob(job, FileFraming::stream,
+                [&](const char* in, std::size_t n, char* out, std::size_t out_size) {
+                    return job.encrypt ? cipher.encrypt_chunk(in, n, out, out_size, key_position)
+                                       : cipher.decrypt_chunk(in, n, out, out_size, key_position);
+                },
+                [&] {
+                    if (key_position == 0)
+                        throw cipher_error(job.encrypt ? "Empty open text" : "Empty cipher text");
+                });
+        } else {
+            runFileJob(job, [&](const char* in, std::size_t n, char* out, std::size_t out_size) {
+                return job.encrypt ? cipher.encrypt_into(in, n, out, out_size)
+                                   : cipher.decrypt_into(in, n, out, out_size);
+            });
+        }
+    } catch (const cipher_error& e) {
+        std::cerr << "Ошибка обработки файла: " << e.what() << std::endl;
+        result = 1;
+    } catch (const std::system_error& e) {
+        std::cerr << "Ошибка ввода-вывода: " << e.what() << std::endl;
+        result = 1;
+    }
+    if (job.stats)
+        std::cout << formatStats("modAlphaCipher", modAlphaCipher::stats().snapshot());
+    return result;
+}
+
+/**
+ * @brief Справка по режиму восстановления ключа
+ * @param program - имя программы
+ * @return Текст справки
+ */
+static std::string analyzeUsage(const std::string& program)
+{
+    return "Использование: " + program + " analyze [--max-key N] ШИФРТЕКСТ [ВЫХОД]\n"
+           "  --max-key  наибольшая проверяемая длина ключа, от 1 до 1000 (по умолчанию 32)\n"
+           "  ВЫХОД      файл для текста, расшифрованного найденным ключом\n"
+           "Оценки длин ключа и найденный ключ печатаются в JSON.\n";
+}
+
+/**
+ * @brief Разбор значения --max-key
+ * @param s - строка со значением
+ * @return Длина ключа от 1 до max_key_length_limit
+ * @throw std::invalid_argument если строка не является числом в этих пределах
+ */
+static std::size_t parseMaxKey(const std::string& s)
+{
+    if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos)
+        throw std::invalid_argument("invalid max-key: " + s);
+    unsigned long value;
+    try {
+        value = std::stoul(s);
+    } catch (const std::out_of_range&) {
+        value = max_key_length_limit + 1;
+    }
+    if (value == 0)
+        throw std::invalid_argument("max-key must be positive");
+    if (value > max_key_length_limit)
+        throw std::invalid_argument("max-key must be at most " + std::to_string(max_key_length_limit));
+    return value;
+}
+
+/**
+ * @brief Восстановление ключа по шифртексту
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
+ * @return 0 при успешном завершении, 1 при ошибке
+ * @details Шифртекст отображается в память; с файлом ВЫХОД он расшифровывается найденным ключом
+ */
+int analyzeMode(int argc, char* argv[])
+{
+    std::size_t max_length = default_max_key_length;
+    std::string files[2];
+    int count = 0;
+    try {
+        for (int i = 2; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--max-key") {
+                if (++i == argc)
+                    throw std::invalid_argument("missing value for " + arg);
+                max_length = parseMaxKey(argv[i]);
+            } else if (count < 2) {
+                files[count++] = arg;
+            } else {
+                throw std::invalid_argument("unexpected argument: " + arg);
+            }
+        }
+        if (count == 0)
+            throw std::invalid_argument("missing cipher text file");
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n" << analyzeUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        ThreadPool pool;
+        auto start = std::chrono::steady_clock::now();
+        KeyRecovery recovery;
+        {
+            MappedFile in(files[0]);
+            recovery = recoverKey(std::string_view(in.data(), in.size()), pool, max_length);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << formatRecovery(recovery, seconds);
+        if (count == 2) {
+            FileJob job;
+            job.encrypt = false;
+            job.key = recovery.key;
+            job.input = files[0];
+            job.output = files[1];
+            modAlphaCipher cipher(std::string_view(job.key));
+            runFileJob(job, [&](const char* in, std::size_t n, char* out, std::size_t out_size) {
+                return cipher.decrypt_into(in, n, out, out_size);
+            });
+        }
+    } catch (const cipher_error& e) {
+        std::cerr << "Ошибка анализа: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::system_error& e) {
+        std::cerr << "Ошибка ввода-вывода: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * @brief Главная функция программы
- * @return 0 при успешном завершении
- * @details Устанавливает локаль и запускает интерактивный режим
+ * @param argc - количество аргументов
+ * @param argv - аргументы командной строки
+ * @return 0 при успешном завершении, 1 при ошибке в файловом режиме
+ * @details С --self-test проверяет шифр (см. selfTest), с командой analyze восстанавливает
+ * ключ по шифртексту, с другими аргументами
+ * обрабатывает файл, без аргументов устанавливает локаль и запускает интерактивный режим
  */
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string(argv[1]) == "--self-test")
+        return selfTest();
+    if (argc > 1 && std::string(argv[1]) == "analyze")
+        return analyzeMode(argc, argv);
+    if (argc > 1)
+        return fileMode(argc, argv);
+
     std::locale::global(std::locale(""));
     std::wcout.imbue(std::locale());
     
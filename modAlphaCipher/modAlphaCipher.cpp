@@ -1,6 +1,9 @@
 #include "modAlphaCipher.h"
+#include "thread_pool.h"
+#include "utf8.h"
+#include "letters.h"
+#include "cipher_stats.h"
 #include <algorithm>
-#include <cwctype>
 
 /**
  * @file modAlphaCipher.cpp
@@ -10,34 +13,79 @@
  * @date 2025
  */
 
+/**
+ * @brief Счётчики шифра, общие для всех объектов класса
+ * @return Статистика вызовов
+ */
+CipherStats& modAlphaCipher::stats()
+{
+    static CipherStats counters;
+    return counters;
+}
+
+/**
+ * @brief Учёт отклонённого вызова
+ * @param status - результат с ошибкой
+ * @return Тот же результат
+ */
+static cipher_status rejected(const cipher_status& status)
+{
+    modAlphaCipher::stats().addRejected();
+    return status;
+}
+
+/**
+ * @brief Выделение буфера результата с учётом в статистике
+ * @tparam Buffer - строка или вектор
+ * @param n - количество элементов
+ * @return Буфер из n нулевых элементов
+ */
+template <typename Buffer>
+static Buffer allocateResult(std::size_t n)
+{
+    StageTimer timer(modAlphaCipher::stats(), CipherStage::allocate);
+    modAlphaCipher::stats().addAllocated(n * sizeof(typename Buffer::value_type));
+    return Buffer(n, typename Buffer::value_type());
+}
+
+/**
+ * @brief Русский алфавит с таблицей "символ → номер"
+ * @return Алфавит, общий для всех объектов класса
+ */
+const Alphabet& modAlphaCipher::alphabet()
+{
+    return StaticAlphabet<RussianLetters>::runtime();
+}
+
 /**
  * @brief Конструктор класса
  * @param skey - ключ шифрования
  * @throw cipher_error если ключ невалиден
- * @details Инициализирует алфавит и преобразует ключ в числовой вид
+ * @details Ключ проверяется и переводится в номера букв шифром text_cipher
  */
-modAlphaCipher::modAlphaCipher(const std::wstring& skey)
-{
-    for (unsigned i=0; i<numAlpha.size(); i++) {
-        alphaNum[numAlpha[i]]=i;
-    }
-    key = convert(getValidKey(skey));
-}
+modAlphaCipher::modAlphaCipher(const std::wstring& skey): text_cipher(skey) {}
+
+/**
+ * @brief Конструктор с установкой ключа в UTF-8
+ * @param skey - ключ шифрования в UTF-8
+ * @throw cipher_error если ключ невалиден
+ */
+modAlphaCipher::modAlphaCipher(std::string_view skey): text_cipher(skey) {}
+
+const std::size_t modAlphaCipher::parallel_threshold;
 
 /**
  * @brief Шифрование текста методом Гронсфельда
  * @param open_text - открытый текст
  * @return Зашифрованная строка
  * @throw cipher_error если текст пуст после очистки
- * @details Текст очищается, преобразуется в числа, складывается с ключом по модулю 33
+ * @details Обёртка над encrypt_into с буфером размером с исходный текст
  */
-std::wstring modAlphaCipher::encrypt(const std::wstring& open_text)
+std::wstring modAlphaCipher::encrypt(const std::wstring& open_text) const
 {
-    std::vector<int> work = convert(getValidOpenText(open_text));
-    for(unsigned i=0; i < work.size(); i++) {
-        work[i] = (work[i] + key[i % key.size()]) % numAlpha.size();
-    }
-    return convert(work);
+    std::wstring result = allocateResult<std::wstring>(open_text.size());
+    result.resize(encrypt_into(open_text.data(), open_text.size(), &result[0], result.size()));
+    return result;
 }
 
 /**
@@ -45,100 +93,574 @@ std::wstring modAlphaCipher::encrypt(const std::wstring& open_text)
  * @param cipher_text - шифртекст
  * @return Расшифрованная строка
  * @throw cipher_error если текст пуст или содержит не заглавные буквы
- * @details Выполняется обратное сложение с ключом по модулю 33
+ * @details Обёртка над decrypt_into с буфером размером с шифртекст
+ */
+std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text) const
+{
+    std::wstring result = allocateResult<std::wstring>(cipher_text.size());
+    result.resize(decrypt_into(cipher_text.data(), cipher_text.size(), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Разбиение текста на фрагменты для пула потоков
+ * @param n - длина текста
+ * @param workers - количество исполнителей
+ * @return Границы фрагментов: bounds[i]..bounds[i + 1]
+ * @details Фрагментов в несколько раз больше, чем исполнителей, чтобы выровнять нагрузку
  */
-std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text)
+static std::vector<std::size_t> splitChunks(std::size_t n, std::size_t workers)
 {
-    std::vector<int> work = convert(getValidCipherText(cipher_text));
-    for(unsigned i=0; i < work.size(); i++) {
-        work[i] = (work[i] + numAlpha.size() - key[i % key.size()]) % numAlpha.size();
+    std::size_t chunks = std::min(workers * 4, n);
+    std::vector<std::size_t> bounds(chunks + 1);
+    for (std::size_t i = 0; i <= chunks; i++)
+        bounds[i] = n / chunks * i + std::min(i, n % chunks);
+    return bounds;
+}
+
+/**
+ * @brief Многопоточное шифрование текста
+ * @param open_text - открытый текст
+ * @param pool - пул потоков
+ * @param threshold - длина текста, ниже которой шифрование выполняется в вызывающем потоке
+ * @return Зашифрованная строка, совпадающая с encrypt(open_text)
+ * @throw cipher_error если текст пуст после очистки или содержит буквы вне алфавита
+ */
+std::wstring modAlphaCipher::encrypt(const std::wstring& open_text, ThreadPool& pool, std::size_t threshold) const
+{
+    const std::size_t n = open_text.size();
+    if (n < threshold || pool.size() < 2)
+        return encrypt(open_text);
+
+    std::vector<std::size_t> bounds = splitChunks(n, pool.size());
+    const std::size_t chunks = bounds.size() - 1;
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+    pool.parallelFor(chunks, [&](std::size_t i) {
+        offsets[i + 1] = countLetters(open_text.data() + bounds[i], bounds[i + 1] - bounds[i]);
+    });
+    for (std::size_t i = 0; i < chunks; i++)
+        offsets[i + 1] += offsets[i];
+    if (offsets[chunks] == 0) {
+        stats().addRejected();
+        throw cipher_error("Empty open text");
     }
-    return convert(work);
+
+    std::wstring result = allocateResult<std::wstring>(n);
+    pool.parallelFor(chunks, [&](std::size_t i) {
+        unsigned long long key_position = offsets[i];
+        encrypt_chunk(open_text.data() + bounds[i], bounds[i + 1] - bounds[i],
+                      &result[offsets[i]], n - offsets[i], key_position);
+    });
+    result.resize(offsets[chunks]);
+    return result;
+}
+
+/**
+ * @brief Многопоточное дешифрование текста
+ * @param cipher_text - шифртекст
+ * @param pool - пул потоков
+ * @param threshold - длина текста, ниже которой дешифрование выполняется в вызывающем потоке
+ * @return Расшифрованная строка, совпадающая с decrypt(cipher_text)
+ * @throw cipher_error если текст пуст или содержит не заглавные буквы алфавита
+ * @details Каждый символ шифртекста — буква, поэтому фаза ключа фрагмента равна его началу
+ */
+std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text, ThreadPool& pool, std::size_t threshold) const
+{
+    const std::size_t n = cipher_text.size();
+    if (n < threshold || pool.size() < 2)
+        return decrypt(cipher_text);
+
+    std::vector<std::size_t> bounds = splitChunks(n, pool.size());
+    std::wstring result = allocateResult<std::wstring>(n);
+    pool.parallelFor(bounds.size() - 1, [&](std::size_t i) {
+        unsigned long long key_position = bounds[i];
+        decrypt_chunk(cipher_text.data() + bounds[i], bounds[i + 1] - bounds[i],
+                      &result[bounds[i]], n - bounds[i], key_position);
+    });
+    return result;
+}
+
+/**
+ * @brief Подсчёт букв, которые попадут в шифртекст
+ * @param in - фрагмент открытого текста
+ * @param n - длина фрагмента
+ * @return Количество букв во фрагменте
+ */
+std::size_t modAlphaCipher::countLetters(const wchar_t* in, std::size_t n)
+{
+    return letterCount(in, n);
+}
+
+/**
+ * @brief Шифрование текста в буфер вызывающей стороны
+ * @param in - открытый текст
+ * @param n - длина открытого текста
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера (не меньше n)
+ * @return Количество записанных символов
+ * @throw cipher_error если буфер мал, текст пуст после очистки или содержит буквы вне алфавита
+ */
+std::size_t modAlphaCipher::encrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size) const
+{
+    std::size_t written;
+    throwIfFailed(try_encrypt_into(in, n, out, out_size, written));
+    return written;
+}
+
+/**
+ * @brief Шифрование текста в буфер вызывающей стороны без исключений
+ * @param in - открытый текст
+ * @param n - длина открытого текста
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера (не меньше n)
+ * @param written - количество записанных символов
+ * @return Вид ошибки и позиция первой буквы вне алфавита
+ */
+cipher_status modAlphaCipher::try_encrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                               std::size_t& written) const
+{
+    unsigned long long key_position = 0;
+    cipher_status status = try_encrypt_chunk(in, n, out, out_size, key_position, written);
+    if (status && written == 0)
+        return rejected(cipher_status(cipher_errc::empty_open_text));
+    return status;
+}
+
+/**
+ * @brief Дешифрование текста в буфер вызывающей стороны
+ * @param in - шифртекст
+ * @param n - длина шифртекста
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера (не меньше n)
+ * @return Количество записанных символов
+ * @throw cipher_error если буфер мал, текст пуст или содержит не заглавные буквы алфавита
+ */
+std::size_t modAlphaCipher::decrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size) const
+{
+    std::size_t written;
+    throwIfFailed(try_decrypt_into(in, n, out, out_size, written));
+    return written;
+}
+
+/**
+ * @brief Дешифрование текста в буфер вызывающей стороны без исключений
+ * @param in - шифртекст
+ * @param n - длина шифртекста
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера (не меньше n)
+ * @param written - количество записанных символов
+ * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой алфавита
+ */
+cipher_status modAlphaCipher::try_decrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                               std::size_t& written) const
+{
+    written = 0;
+    if (n == 0)
+        return rejected(cipher_status(cipher_errc::empty_cipher_text));
+    unsigned long long key_position = 0;
+    return try_decrypt_chunk(in, n, out, out_size, key_position, written);
+}
+
+/**
+ * @brief Шифрование текста в UTF-8
+ * @param open_text - открытый текст в UTF-8
+ * @return Зашифрованная строка в UTF-8
+ * @throw cipher_error если текст не в UTF-8, пуст после очистки или содержит буквы вне алфавита
+ */
+std::string modAlphaCipher::encrypt(std::string_view open_text) const
+{
+    std::string result = allocateResult<std::string>(open_text.size());
+    result.resize(encrypt_into(open_text.data(), open_text.size(), &result[0], result.size()));
+    return result;
+}
+
+/**
+ * @brief Дешифрование текста в UTF-8
+ * @param cipher_text - шифртекст в UTF-8
+ * @return Расшифрованная строка в UTF-8
+ * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы алфавита
+ */
+std::string modAlphaCipher::decrypt(std::string_view cipher_text) const
+{
+    std::string result = allocateResult<std::string>(cipher_text.size());
+    result.resize(decrypt_into(cipher_text.data(), cipher_text.size(), &result[0], result.size()));
+    return result;
 }
 
 /**
- * @brief Преобразование строки в числовой вектор
- * @param s - строка для преобразования
- * @return Вектор номеров символов
+ * @brief Шифрование текста в виде номеров букв
+ * @param open_text - открытый текст, закодированный алфавитом alphabet()
+ * @return Шифртекст в том же виде
+ * @throw cipher_error если текст пуст
  */
-std::vector<int> modAlphaCipher::convert(const std::wstring& s)
+PackedText modAlphaCipher::encrypt(const PackedText& open_text) const
 {
-    std::vector<int> result;
-    for(auto c:s) {
-        result.push_back(alphaNum[c]);
+    stats().addCall(open_text.size());
+    if (open_text.empty()) {
+        stats().addRejected();
+        throw cipher_error("Empty open text");
     }
+    PackedText result(allocateResult<std::vector<unsigned char>>(open_text.size()));
+    StageTimer timer(stats(), CipherStage::transform);
+    text_cipher.encrypt_packed(open_text.data(), result.data(), open_text.size(), 0);
     return result;
 }
 
 /**
- * @brief Преобразование числового вектора в строку
- * @param v - вектор чисел
- * @return Строка, соответствующая вектору
+ * @brief Дешифрование текста в виде номеров букв
+ * @param cipher_text - шифртекст, закодированный алфавитом alphabet()
+ * @return Открытый текст в том же виде
+ * @throw cipher_error если текст пуст
  */
-std::wstring modAlphaCipher::convert(const std::vector<int>& v)
+PackedText modAlphaCipher::decrypt(const PackedText& cipher_text) const
 {
-    std::wstring result;
-    for(auto i:v) {
-        result.push_back(numAlpha[i]);
+    stats().addCall(cipher_text.size());
+    if (cipher_text.empty()) {
+        stats().addRejected();
+        throw cipher_error("Empty cipher text");
     }
+    PackedText result(allocateResult<std::vector<unsigned char>>(cipher_text.size()));
+    StageTimer timer(stats(), CipherStage::transform);
+    text_cipher.decrypt_packed(cipher_text.data(), result.data(), cipher_text.size(), 0);
     return result;
 }
 
 /**
- * @brief Проверка и нормализация ключа
- * @param s - исходный ключ
- * @return Ключ в верхнем регистре
- * @throw cipher_error если ключ пустой или содержит не-буквы
+ * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны
+ * @param in - открытый текст в UTF-8
+ * @param n - длина открытого текста в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @return Количество записанных байтов
+ * @throw cipher_error если буфер мал, текст не в UTF-8, пуст после очистки или содержит буквы вне алфавита
+ */
+std::size_t modAlphaCipher::encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const
+{
+    std::size_t written;
+    throwIfFailed(try_encrypt_into(in, n, out, out_size, written));
+    return written;
+}
+
+/**
+ * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+ * @param in - открытый текст в UTF-8
+ * @param n - длина открытого текста в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @param written - количество записанных байтов
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
  */
-std::wstring modAlphaCipher::getValidKey(const std::wstring& s)
+cipher_status modAlphaCipher::try_encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                               std::size_t& written) const
 {
-    if (s.empty())
-        throw cipher_error("Empty key");
-    std::wstring tmp(s);
-    for (auto & c:tmp) {
-        if (!iswalpha(c))
-            throw cipher_error("Invalid key");
-        if (iswlower(c))
-            c = towupper(c);
+    unsigned long long key_position = 0;
+    cipher_status status = try_encrypt_chunk(in, n, out, out_size, key_position, written);
+    if (status && key_position == 0)
+        return rejected(cipher_status(cipher_errc::empty_open_text));
+    return status;
+}
+
+/**
+ * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны
+ * @param in - шифртекст в UTF-8
+ * @param n - длина шифртекста в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @return Количество записанных байтов
+ * @throw cipher_error если буфер мал, текст не в UTF-8, пуст или содержит не заглавные буквы алфавита
+ */
+std::size_t modAlphaCipher::decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const
+{
+    std::size_t written;
+    throwIfFailed(try_decrypt_into(in, n, out, out_size, written));
+    return written;
+}
+
+/**
+ * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+ * @param in - шифртекст в UTF-8
+ * @param n - длина шифртекста в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @param written - количество записанных байтов
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status modAlphaCipher::try_decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                               std::size_t& written) const
+{
+    if (n == 0) {
+        written = 0;
+        stats().addCall(n);
+        return rejected(cipher_status(cipher_errc::empty_cipher_text));
     }
-    return tmp;
+    unsigned long long key_position = 0;
+    return try_decrypt_chunk(in, n, out, out_size, key_position, written);
 }
 
 /**
- * @brief Проверка и очистка открытого текста
- * @param s - исходный текст
- * @return Текст в верхнем регистре без не-букв
- * @throw cipher_error если текст пуст после очистки
+ * @brief Шифрование фрагмента текста в UTF-8 с текущей позиции ключа
+ * @param in - фрагмент открытого текста в UTF-8, не разрезающий символы
+ * @param n - длина фрагмента в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; увеличивается на число букв фрагмента
+ * @return Количество записанных байтов (может быть 0)
+ * @throw cipher_error если буфер мал, фрагмент не в UTF-8 или содержит буквы вне алфавита
+ */
+std::size_t modAlphaCipher::encrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                          unsigned long long& key_position) const
+{
+    std::size_t written;
+    throwIfFailed(try_encrypt_chunk(in, n, out, out_size, key_position, written));
+    return written;
+}
+
+/**
+ * @brief Шифрование фрагмента текста в UTF-8 с текущей позиции ключа без исключений
+ * @param in - фрагмент открытого текста в UTF-8, не разрезающий символы
+ * @param n - длина фрагмента в байтах
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+ * @param written - количество записанных байтов (может быть 0)
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ * @details Буквы классифицируются по letters.h, а не через локаль
+ */
+cipher_status modAlphaCipher::try_encrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                                unsigned long long& key_position, std::size_t& written) const
+{
+    stats().addCall(n);
+    StageTimer timer(stats(), CipherStage::transform);
+    cipher_status status = text_cipher.try_encrypt_chunk(in, n, out, out_size, key_position, written);
+    return status ? status : rejected(status);
+}
+
+/**
+ * @brief Дешифрование фрагмента шифртекста в UTF-8 с текущей позиции ключа
+ * @param in - фрагмент шифртекста в UTF-8, не разрезающий символы
+ * @param n - длина фрагмента в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; увеличивается на число букв фрагмента
+ * @return Количество записанных байтов
+ * @throw cipher_error если буфер мал, фрагмент не в UTF-8 или содержит не заглавные буквы алфавита
+ */
+std::size_t modAlphaCipher::decrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                          unsigned long long& key_position) const
+{
+    std::size_t written;
+    throwIfFailed(try_decrypt_chunk(in, n, out, out_size, key_position, written));
+    return written;
+}
+
+/**
+ * @brief Дешифрование фрагмента шифртекста в UTF-8 с текущей позиции ключа без исключений
+ * @param in - фрагмент шифртекста в UTF-8, не разрезающий символы
+ * @param n - длина фрагмента в байтах
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера в байтах (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+ * @param written - количество записанных байтов
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status modAlphaCipher::try_decrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                                unsigned long long& key_position, std::size_t& written) const
+{
+    stats().addCall(n);
+    StageTimer timer(stats(), CipherStage::transform);
+    cipher_status status = text_cipher.try_decrypt_chunk(in, n, out, out_size, key_position, written);
+    return status ? status : rejected(status);
+}
+
+/**
+ * @brief Шифрование фрагмента текста с заданной позиции ключа
+ * @param in - фрагмент открытого текста
+ * @param n - длина фрагмента
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; увеличивается на число букв фрагмента
+ * @return Количество записанных символов (может быть 0)
+ * @throw cipher_error если буфер мал или фрагмент содержит буквы вне алфавита
+ */
+std::size_t modAlphaCipher::encrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                          unsigned long long& key_position) const
+{
+    std::size_t written;
+    throwIfFailed(try_encrypt_chunk(in, n, out, out_size, key_position, written));
+    return written;
+}
+
+/**
+ * @brief Шифрование фрагмента текста с заданной позиции ключа без исключений
+ * @param in - фрагмент открытого текста
+ * @param n - длина фрагмента
+ * @param out - буфер для шифртекста
+ * @param out_size - размер буфера (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+ * @param written - количество записанных символов (может быть 0)
+ * @return Вид ошибки и позиция первой буквы вне алфавита
+ * @details Номера букв собираются BasicGronsfeld<RussianLetters> в блоки и сдвигаются
+ * тем же векторным ядром, что и PackedText
  */
-std::wstring modAlphaCipher::getValidOpenText(const std::wstring& s)
+cipher_status modAlphaCipher::try_encrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                                unsigned long long& key_position, std::size_t& written) const
 {
-    std::wstring tmp;
-    for (auto c:s) {
-        if (iswalpha(c)) {
-            if (iswlower(c))
-                tmp.push_back(towupper(c));
-            else
-                tmp.push_back(c);
+    stats().addCall(n);
+    StageTimer timer(stats(), CipherStage::transform);
+    cipher_status status = text_cipher.try_encrypt_chunk(in, n, out, out_size, key_position, written);
+    return status ? status : rejected(status);
+}
+
+/**
+ * @brief Дешифрование фрагмента шифртекста с заданной позиции ключа
+ * @param in - фрагмент шифртекста
+ * @param n - длина фрагмента
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; увеличивается на n
+ * @return Количество записанных символов (равно n)
+ * @throw cipher_error если буфер мал или фрагмент содержит не заглавные буквы алфавита
+ */
+std::size_t modAlphaCipher::decrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                          unsigned long long& key_position) const
+{
+    std::size_t written;
+    throwIfFailed(try_decrypt_chunk(in, n, out, out_size, key_position, written));
+    return written;
+}
+
+/**
+ * @brief Дешифрование фрагмента шифртекста с заданной позиции ключа без исключений
+ * @param in - фрагмент шифртекста
+ * @param n - длина фрагмента
+ * @param out - буфер для открытого текста
+ * @param out_size - размер буфера (не меньше n)
+ * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на n
+ * @param written - количество записанных символов (равно n при успехе)
+ * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой алфавита
+ */
+cipher_status modAlphaCipher::try_decrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                                unsigned long long& key_position, std::size_t& written) const
+{
+    stats().addCall(n);
+    StageTimer timer(stats(), CipherStage::transform);
+    cipher_status status = text_cipher.try_decrypt_chunk(in, n, out, out_size, key_position, written);
+    return status ? status : rejected(status);
+}
+
+/**
+ * @brief Проверка ключа без исключений
+ * @param skey - ключ шифрования
+ * @return Вид ошибки и позиция первого недопустимого символа ключа
+ */
+cipher_status modAlphaCipher::checkKey(const std::wstring& skey)
+{
+    return BasicGronsfeld<RussianLetters>::checkKey(skey);
+}
+
+/**
+ * @brief Проверка ключа в UTF-8 без исключений
+ * @param skey - ключ шифрования в UTF-8
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа ключа
+ * @details Некорректный UTF-8 в ключе сообщается как invalid_key, как и в бросающем API
+ */
+cipher_status modAlphaCipher::checkKey(std::string_view skey)
+{
+    if (skey.empty())
+        return cipher_status(cipher_errc::empty_key);
+    for (std::size_t i = 0; i < skey.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(skey.data() + i, skey.size() - i, c);
+        if (k == 0 || !isLetter(c) || !alphabet().contains(toUpperLetter(c)))
+            return cipher_status(cipher_errc::invalid_key, i);
+        i += k;
+    }
+    return cipher_status();
+}
+
+/**
+ * @brief Проверка открытого текста без исключений
+ * @param open_text - открытый текст
+ * @return Вид ошибки и позиция первой буквы вне алфавита
+ */
+cipher_status modAlphaCipher::checkOpenText(const std::wstring& open_text)
+{
+    bool letters = false;
+    for (std::size_t i = 0; i < open_text.size(); i++) {
+        wchar_t c = open_text[i];
+        if (!isLetter(c))
+            continue;
+        if (!alphabet().contains(toUpperLetter(c)))
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+        letters = true;
+    }
+    if (!letters)
+        return cipher_status(cipher_errc::empty_open_text);
+    return cipher_status();
+}
+
+/**
+ * @brief Проверка открытого текста в UTF-8 без исключений
+ * @param open_text - открытый текст в UTF-8
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status modAlphaCipher::checkOpenText(std::string_view open_text)
+{
+    bool letters = false;
+    for (std::size_t i = 0; i < open_text.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(open_text.data() + i, open_text.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        if (isLetter(c)) {
+            if (!alphabet().contains(toUpperLetter(c)))
+                return cipher_status(cipher_errc::not_in_alphabet, i);
+            letters = true;
         }
+        i += k;
     }
-    if (tmp.empty())
-        throw cipher_error("Empty open text");
-    return tmp;
+    if (!letters)
+        return cipher_status(cipher_errc::empty_open_text);
+    return cipher_status();
 }
 
 /**
- * @brief Проверка шифртекста
- * @param s - шифртекст
- * @return Текст без изменений
- * @throw cipher_error если текст пуст или содержит не заглавные буквы
+ * @brief Проверка шифртекста без исключений
+ * @param cipher_text - шифртекст
+ * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой алфавита
  */
-std::wstring modAlphaCipher::getValidCipherText(const std::wstring& s)
+cipher_status modAlphaCipher::checkCipherText(const std::wstring& cipher_text)
 {
-    if (s.empty())
-        throw cipher_error("Empty cipher text");
-    for (auto c:s) {
-        if (!iswupper(c))
-            throw cipher_error("Invalid cipher text");
+    if (cipher_text.empty())
+        return cipher_status(cipher_errc::empty_cipher_text);
+    for (std::size_t i = 0; i < cipher_text.size(); i++) {
+        if (!isUpperLetter(cipher_text[i]))
+            return cipher_status(cipher_errc::invalid_cipher_text, i);
+        if (!alphabet().contains(cipher_text[i]))
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+    }
+    return cipher_status();
+}
+
+/**
+ * @brief Проверка шифртекста в UTF-8 без исключений
+ * @param cipher_text - шифртекст в UTF-8
+ * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+ */
+cipher_status modAlphaCipher::checkCipherText(std::string_view cipher_text)
+{
+    if (cipher_text.empty())
+        return cipher_status(cipher_errc::empty_cipher_text);
+    for (std::size_t i = 0; i < cipher_text.size();) {
+        char32_t c;
+        std::size_t k = utf8Decode(cipher_text.data() + i, cipher_text.size() - i, c);
+        if (k == 0)
+            return cipher_status(cipher_errc::invalid_utf8, i);
+        if (!isUpperLetter(c))
+            return cipher_status(cipher_errc::invalid_cipher_text, i);
+        if (!alphabet().contains(c))
+            return cipher_status(cipher_errc::not_in_alphabet, i);
+        i += k;
     }
-    return s;
+    return cipher_status();
 }
@@ -1,10 +1,15 @@
 #pragma once
 #include <vector>
 #include <string>
-#include <map>
+#include <string_view>
 #include <stdexcept>
 #include <locale>
-#include <codecvt>
+#include "alphabet.h"
+#include "gronsfeld.h"
+#include "cipher_error.h"
+#include "cipher_status.h"
+#include "packed_text.h"
+#include "cipher_stats.h"
 
 /**
  * @file modAlphaCipher.h
@@ -15,86 +20,110 @@
  * @warning Реализация для русского алфавита (33 буквы)
  */
 
-/**
- * @brief Класс исключения для ошибок шифрования
- * @details Наследуется от std::invalid_argument
- */
-class cipher_error : public std::invalid_argument {
-public:
-    /**
-     * @brief Конструктор исключения с передачей строки
-     * @param what_arg - сообщение об ошибке
-     */
-    explicit cipher_error(const std::string& what_arg):
-        std::invalid_argument(what_arg) {}
-    
-    /**
-     * @brief Конструктор исключения с передачей строки (C-стиль)
-     * @param what_arg - сообщение об ошибке
-     */
-    explicit cipher_error(const char* what_arg):
-        std::invalid_argument(what_arg) {}
-};
+class ThreadPool;
 
 /**
  * @brief Класс для шифрования методом Гронсфельда
  * @details Использует сложение символов сообщения с символами ключа по модулю 33
  * Алфавит: АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ (33 символа)
+ * После конструирования объект не изменяется: методы шифрования и дешифрования
+ * константны и могут одновременно вызываться из нескольких потоков.
+ * Текст (широкие строки и UTF-8) и PackedText шифруются BasicGronsfeld<RussianLetters>
+ * через общий сдвиг на векторном ядре gronsfeldKernel()
  */
 class modAlphaCipher
 {
 private:
-    std::wstring numAlpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"; ///< Русский алфавит по порядку
-    std::map <wchar_t, int> alphaNum; ///< Ассоциативный массив "символ → номер"
-    std::vector <int> key; ///< Ключ в числовом виде
-    
+    BasicGronsfeld<RussianLetters> text_cipher; ///< Шифр с тем же ключом, выполняющий сдвиг
+
     /**
-     * @brief Преобразование строки в числовой вектор
-     * @param s - строка для преобразования
-     * @return Вектор чисел (номеров символов в алфавите)
+     * @brief Подсчёт букв, которые попадут в шифртекст
+     * @param in - фрагмент открытого текста
+     * @param n - длина фрагмента
+     * @return Количество букв во фрагменте
      */
-    std::vector<int> convert(const std::wstring& s);
-    
+    static std::size_t countLetters(const wchar_t* in, std::size_t n);
+
+public:
+    static const std::size_t parallel_threshold = 1 << 20; ///< Длина текста, начиная с которой выгодно многопоточное шифрование
+
+    modAlphaCipher() = delete; ///< Удалённый конструктор по умолчанию
+
     /**
-     * @brief Преобразование числового вектора в строку
-     * @param v - вектор чисел
-     * @return Строка, соответствующая вектору
+     * @brief Русский алфавит с таблицей "символ → номер"
+     * @return Алфавит, общий для всех объектов класса
+     * @details Алфавит не зависит от ключа, поэтому ключ и текст можно проверить
+     * статическими методами check* до создания шифра
      */
-    std::wstring convert(const std::vector<int>& v);
-    
+    static const Alphabet& alphabet();
+
     /**
-     * @brief Проверка и нормализация ключа
-     * @param s - исходный ключ
-     * @return Валидный ключ в верхнем регистре
-     * @throw cipher_error если ключ пустой или содержит не-буквы
+     * @brief Счётчики шифра, общие для всех объектов класса
+     * @return Статистика вызовов
+     * @details Вызовом считается проход по тексту: try_*_into, try_*_chunk и шифрование
+     * PackedText; многопоточные методы учитываются по одному вызову на фрагмент.
+     * Проверка и перевод в номера выполняются в том же проходе, что и сдвиг,
+     * поэтому входят в этап transform; этап validate у этого шифра пуст
      */
-    std::wstring getValidKey(const std::wstring& s);
+    static CipherStats& stats();
     
     /**
-     * @brief Проверка и нормализация открытого текста
-     * @param s - исходный текст
-     * @return Текст в верхнем регистре без не-букв
-     * @throw cipher_error если после очистки текст пуст
+     * @brief Конструктор с установкой ключа
+     * @param skey - ключ шифрования
+     * @throw cipher_error если ключ невалиден
      */
-    std::wstring getValidOpenText(const std::wstring& s);
-    
+    modAlphaCipher(const std::wstring& skey);
+
     /**
-     * @brief Проверка шифртекста
-     * @param s - шифртекст
-     * @return Текст без изменений
-     * @throw cipher_error если текст пуст или содержит не заглавные буквы
+     * @brief Конструктор с установкой ключа в UTF-8
+     * @param skey - ключ шифрования в UTF-8
+     * @throw cipher_error если ключ невалиден
+     * @details Не зависит от локали программы
      */
-    std::wstring getValidCipherText(const std::wstring& s);
+    explicit modAlphaCipher(std::string_view skey);
 
-public:
-    modAlphaCipher() = delete; ///< Удалённый конструктор по умолчанию
-    
     /**
-     * @brief Конструктор с установкой ключа
+     * @brief Проверка ключа без исключений
      * @param skey - ключ шифрования
-     * @throw cipher_error если ключ невалиден
+     * @return Вид ошибки и позиция первого недопустимого символа ключа
+     * @details Если проверка прошла, конструктор с этим ключом не выбрасывает исключений
      */
-    modAlphaCipher(const std::wstring& skey);
+    static cipher_status checkKey(const std::wstring& skey);
+
+    /**
+     * @brief Проверка ключа в UTF-8 без исключений
+     * @param skey - ключ шифрования в UTF-8
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа ключа
+     */
+    static cipher_status checkKey(std::string_view skey);
+
+    /**
+     * @brief Проверка открытого текста без исключений
+     * @param open_text - открытый текст
+     * @return Вид ошибки и позиция первой буквы вне алфавита
+     */
+    static cipher_status checkOpenText(const std::wstring& open_text);
+
+    /**
+     * @brief Проверка открытого текста в UTF-8 без исключений
+     * @param open_text - открытый текст в UTF-8
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status checkOpenText(std::string_view open_text);
+
+    /**
+     * @brief Проверка шифртекста без исключений
+     * @param cipher_text - шифртекст
+     * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой алфавита
+     */
+    static cipher_status checkCipherText(const std::wstring& cipher_text);
+
+    /**
+     * @brief Проверка шифртекста в UTF-8 без исключений
+     * @param cipher_text - шифртекст в UTF-8
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    static cipher_status checkCipherText(std::string_view cipher_text);
     
     /**
      * @brief Шифрование текста
@@ -102,7 +131,7 @@ public:
      * @return Зашифрованная строка
      * @throw cipher_error если текст невалиден
      */
-    std::wstring encrypt(const std::wstring& open_text);
+    std::wstring encrypt(const std::wstring& open_text) const;
     
     /**
      * @brief Дешифрование текста
@@ -110,5 +139,290 @@ public:
      * @return Расшифрованная строка
      * @throw cipher_error если текст невалиден
      */
-    std::wstring decrypt(const std::wstring& cipher_text);
+    std::wstring decrypt(const std::wstring& cipher_text) const;
+
+    /**
+     * @brief Многопоточное шифрование текста
+     * @param open_text - открытый текст
+     * @param pool - пул потоков
+     * @param threshold - длина текста, ниже которой шифрование выполняется в вызывающем потоке
+     * @return Зашифрованная строка, совпадающая с encrypt(open_text)
+     * @throw cipher_error если текст пуст после очистки или содержит буквы вне алфавита
+     * @details Текст делится на фрагменты; сначала параллельно считаются буквы каждого
+     * фрагмента, затем каждый фрагмент шифруется со своей фазы ключа прямо в общий результат
+     */
+    std::wstring encrypt(const std::wstring& open_text, ThreadPool& pool,
+                         std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Многопоточное дешифрование текста
+     * @param cipher_text - шифртекст
+     * @param pool - пул потоков
+     * @param threshold - длина текста, ниже которой дешифрование выполняется в вызывающем потоке
+     * @return Расшифрованная строка, совпадающая с decrypt(cipher_text)
+     * @throw cipher_error если текст пуст или содержит не заглавные буквы алфавита
+     */
+    std::wstring decrypt(const std::wstring& cipher_text, ThreadPool& pool,
+                         std::size_t threshold = parallel_threshold) const;
+
+    /**
+     * @brief Шифрование текста в буфер вызывающей стороны
+     * @param in - открытый текст
+     * @param n - длина открытого текста
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера (не меньше n)
+     * @return Количество записанных символов
+     * @throw cipher_error если буфер мал, текст пуст после очистки или содержит буквы вне алфавита
+     * @details Проверка, приведение к верхнему регистру, сдвиг и запись выполняются
+     * за один проход без выделения памяти
+     */
+    std::size_t encrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size) const;
+
+    /**
+     * @brief Шифрование текста в буфер вызывающей стороны без исключений
+     * @param in - открытый текст
+     * @param n - длина открытого текста
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера (не меньше n)
+     * @param written - количество записанных символов
+     * @return Вид ошибки и позиция первой буквы вне алфавита
+     * @details Тот же путь, что и encrypt_into; при ошибке содержимое out не определено
+     */
+    cipher_status try_encrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+    /**
+     * @brief Дешифрование текста в буфер вызывающей стороны
+     * @param in - шифртекст
+     * @param n - длина шифртекста
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера (не меньше n)
+     * @return Количество записанных символов
+     * @throw cipher_error если буфер мал, текст пуст или содержит не заглавные буквы алфавита
+     * @details Проверка, сдвиг и запись выполняются за один проход без выделения памяти
+     */
+    std::size_t decrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size) const;
+
+    /**
+     * @brief Дешифрование текста в буфер вызывающей стороны без исключений
+     * @param in - шифртекст
+     * @param n - длина шифртекста
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера (не меньше n)
+     * @param written - количество записанных символов
+     * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой алфавита
+     */
+    cipher_status try_decrypt_into(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+    /**
+     * @brief Шифрование текста в UTF-8
+     * @param open_text - открытый текст в UTF-8
+     * @return Зашифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8, пуст после очистки или содержит буквы вне алфавита
+     */
+    std::string encrypt(std::string_view open_text) const;
+
+    /**
+     * @brief Дешифрование текста в UTF-8
+     * @param cipher_text - шифртекст в UTF-8
+     * @return Расшифрованная строка в UTF-8
+     * @throw cipher_error если текст не в UTF-8, пуст или содержит не заглавные буквы алфавита
+     */
+    std::string decrypt(std::string_view cipher_text) const;
+
+    /**
+     * @brief Шифрование текста в виде номеров букв
+     * @param open_text - открытый текст, закодированный алфавитом alphabet()
+     * @return Шифртекст в том же виде
+     * @throw cipher_error если текст пуст
+     * @details Номера сдвигаются векторным ядром без перевода в символы
+     */
+    PackedText encrypt(const PackedText& open_text) const;
+
+    /**
+     * @brief Дешифрование текста в виде номеров букв
+     * @param cipher_text - шифртекст, закодированный алфавитом alphabet()
+     * @return Открытый текст в том же виде
+     * @throw cipher_error если текст пуст
+     */
+    PackedText decrypt(const PackedText& cipher_text) const;
+
+    /**
+     * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны
+     * @param in - открытый текст в UTF-8
+     * @param n - длина открытого текста в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @return Количество записанных байтов
+     * @throw cipher_error если буфер мал, текст не в UTF-8, пуст после очистки или содержит буквы вне алфавита
+     * @details Байты декодируются, проверяются, приводятся к верхнему регистру, сдвигаются
+     * и кодируются обратно за один проход, без широких строк и без локали
+     */
+    std::size_t encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const;
+
+    /**
+     * @brief Шифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+     * @param in - открытый текст в UTF-8
+     * @param n - длина открытого текста в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_encrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+    /**
+     * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны
+     * @param in - шифртекст в UTF-8
+     * @param n - длина шифртекста в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @return Количество записанных байтов
+     * @throw cipher_error если буфер мал, текст не в UTF-8, пуст или содержит не заглавные буквы алфавита
+     */
+    std::size_t decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size) const;
+
+    /**
+     * @brief Дешифрование текста в UTF-8 в буфер вызывающей стороны без исключений
+     * @param in - шифртекст в UTF-8
+     * @param n - длина шифртекста в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_decrypt_into(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                   std::size_t& written) const;
+
+    /**
+     * @brief Шифрование фрагмента текста в UTF-8 с текущей позиции ключа
+     * @param in - фрагмент открытого текста в UTF-8, не разрезающий символы
+     * @param n - длина фрагмента в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; увеличивается на число букв фрагмента
+     * @return Количество записанных байтов (может быть 0)
+     * @throw cipher_error если буфер мал, фрагмент не в UTF-8 или содержит буквы вне алфавита
+     * @details Последовательные вызовы с одной переменной key_position дают тот же
+     * результат, что encrypt_into для всего текста, но фрагмент без букв не считается ошибкой
+     */
+    std::size_t encrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                              unsigned long long& key_position) const;
+
+    /**
+     * @brief Шифрование фрагмента текста в UTF-8 с текущей позиции ключа без исключений
+     * @param in - фрагмент открытого текста в UTF-8, не разрезающий символы
+     * @param n - длина фрагмента в байтах
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+     * @param written - количество записанных байтов (может быть 0)
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_encrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const;
+
+    /**
+     * @brief Дешифрование фрагмента шифртекста в UTF-8 с текущей позиции ключа
+     * @param in - фрагмент шифртекста в UTF-8, не разрезающий символы
+     * @param n - длина фрагмента в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; увеличивается на число букв фрагмента
+     * @return Количество записанных байтов
+     * @throw cipher_error если буфер мал, фрагмент не в UTF-8 или содержит не заглавные буквы алфавита
+     * @details В отличие от decrypt_into не считает пустой фрагмент ошибкой
+     */
+    std::size_t decrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                              unsigned long long& key_position) const;
+
+    /**
+     * @brief Дешифрование фрагмента шифртекста в UTF-8 с текущей позиции ключа без исключений
+     * @param in - фрагмент шифртекста в UTF-8, не разрезающий символы
+     * @param n - длина фрагмента в байтах
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера в байтах (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+     * @param written - количество записанных байтов
+     * @return Вид ошибки и позиция (в байтах) первого недопустимого символа
+     */
+    cipher_status try_decrypt_chunk(const char* in, std::size_t n, char* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const;
+
+    /**
+     * @brief Шифрование фрагмента текста с заданной позиции ключа
+     * @param in - фрагмент открытого текста
+     * @param n - длина фрагмента
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; увеличивается на число букв фрагмента
+     * @return Количество записанных символов (может быть 0)
+     * @throw cipher_error если буфер мал или фрагмент содержит буквы вне алфавита
+     * @details Как и у encrypt_chunk для UTF-8, последовательные вызовы с одной переменной
+     * key_position дают результат encrypt_into для всего текста; фрагмент без букв не считается ошибкой
+     */
+    std::size_t encrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                              unsigned long long& key_position) const;
+
+    /**
+     * @brief Шифрование фрагмента текста с заданной позиции ключа без исключений
+     * @param in - фрагмент открытого текста
+     * @param n - длина фрагмента
+     * @param out - буфер для шифртекста
+     * @param out_size - размер буфера (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на число букв фрагмента
+     * @param written - количество записанных символов (может быть 0)
+     * @return Вид ошибки и позиция первой буквы вне алфавита
+     */
+    cipher_status try_encrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const;
+
+    /**
+     * @brief Дешифрование фрагмента шифртекста с заданной позиции ключа
+     * @param in - фрагмент шифртекста
+     * @param n - длина фрагмента
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; увеличивается на n
+     * @return Количество записанных символов (равно n)
+     * @throw cipher_error если буфер мал или фрагмент содержит не заглавные буквы алфавита
+     * @details В отличие от decrypt_into не считает пустой фрагмент ошибкой
+     */
+    std::size_t decrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                              unsigned long long& key_position) const;
+
+    /**
+     * @brief Дешифрование фрагмента шифртекста с заданной позиции ключа без исключений
+     * @param in - фрагмент шифртекста
+     * @param n - длина фрагмента
+     * @param out - буфер для открытого текста
+     * @param out_size - размер буфера (не меньше n)
+     * @param key_position - количество букв до начала фрагмента; при успехе увеличивается на n
+     * @param written - количество записанных символов (равно n при успехе)
+     * @return Вид ошибки и позиция первого символа, не являющегося заглавной буквой алфавита
+     */
+    cipher_status try_decrypt_chunk(const wchar_t* in, std::size_t n, wchar_t* out, std::size_t out_size,
+                                    unsigned long long& key_position, std::size_t& written) const;
+
+    /**
+     * @brief Длина ключа
+     * @return Количество букв ключа (период шифра)
+     */
+    std::size_t keyLength() const
+    {
+        return text_cipher.keyLength();
+    }
+
+    /**
+     * @brief Сдвиг ключа для буквы с заданным номером
+     * @param position - номер буквы в тексте
+     * @return Номер буквы ключа в алфавите, прибавляемый при шифровании
+     * @details Нужен для слияния шифра с другими этапами (см. CipherPipeline)
+     */
+    int keyShift(unsigned long long position) const
+    {
+        return text_cipher.keyShift(position);
+    }
 };
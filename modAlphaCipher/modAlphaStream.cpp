@@ -0,0 +1,116 @@
+#include "modAlphaStream.h"
+#include "utf8.h"
+
+/**
+ * @file modAlphaStream.cpp
+ * @brief Реализация класса modAlphaStream
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Конструктор на основе готового шифра
+ * @param cipher - шифр с установленным ключом
+ * @param mode - направление преобразования
+ */
+modAlphaStream::modAlphaStream(const modAlphaCipher& cipher, Mode mode):
+    cipher(cipher), mode(mode)
+{
+}
+
+/**
+ * @brief Конструктор с установкой ключа
+ * @param skey - ключ шифрования
+ * @param mode - направление преобразования
+ * @throw cipher_error если ключ невалиден
+ */
+modAlphaStream::modAlphaStream(const std::wstring& skey, Mode mode):
+    modAlphaStream(modAlphaCipher(skey), mode)
+{
+}
+
+/**
+ * @brief Преобразование декодированного фрагмента с текущей позиции ключа
+ * @param in - фрагмент
+ * @param n - длина фрагмента
+ * @return Количество символов, записанных в wide_out
+ * @details Позиция ключа сохраняется только после успешного преобразования
+ */
+std::size_t modAlphaStream::transform(const wchar_t* in, std::size_t n)
+{
+    if (wide_out.size() < n)
+        wide_out.resize(n);
+    unsigned long long next = pos;
+    std::size_t written;
+    if (mode == Mode::Encrypt)
+        written = cipher.encrypt_chunk(in, n, &wide_out[0], wide_out.size(), next);
+    else
+        written = cipher.decrypt_chunk(in, n, &wide_out[0], wide_out.size(), next);
+    pos = next;
+    return written;
+}
+
+/**
+ * @brief Обработка очередного фрагмента широкой строки
+ * @param chunk - фрагмент текста
+ * @return Результат для фрагмента
+ * @throw cipher_error если фрагмент содержит недопустимые символы
+ */
+std::wstring modAlphaStream::update(const std::wstring& chunk)
+{
+    std::size_t written = transform(chunk.data(), chunk.size());
+    return wide_out.substr(0, written);
+}
+
+/**
+ * @brief Обработка очередного фрагмента текста в UTF-8
+ * @param chunk - фрагмент байтов; первый и последний символы могут быть неполными
+ * @return Результат для фрагмента в UTF-8
+ * @throw cipher_error если фрагмент содержит недопустимые символы или некорректный UTF-8
+ * @details Неполный символ в конце фрагмента переносится в carry и дописывается
+ * в начало следующего; остальное передаётся UTF-8 методам шифра без перекодирования.
+ * carry и позиция ключа меняются только после успешного преобразования
+ */
+std::string modAlphaStream::update(const std::string& chunk)
+{
+    bytes_in.assign(carry);
+    bytes_in.append(chunk);
+    std::size_t n = utf8CompletePrefix(bytes_in.data(), bytes_in.size());
+
+    std::string result(n, '\0');
+    unsigned long long next = pos;
+    std::size_t written;
+    if (mode == Mode::Encrypt)
+        written = cipher.encrypt_chunk(bytes_in.data(), n, &result[0], result.size(), next);
+    else
+        written = cipher.decrypt_chunk(bytes_in.data(), n, &result[0], result.size(), next);
+    result.resize(written);
+    pos = next;
+    carry.assign(bytes_in, n, std::string::npos);
+    return result;
+}
+
+/**
+ * @brief Завершение потока
+ * @throw cipher_error если поток оборвался посреди символа UTF-8 или в нём не было букв
+ */
+void modAlphaStream::finish()
+{
+    if (!carry.empty())
+        throwIfFailed(cipher_status(cipher_errc::invalid_utf8));
+    if (pos == start)
+        throwIfFailed(cipher_status(mode == Mode::Encrypt ? cipher_errc::empty_open_text
+                                                          : cipher_errc::empty_cipher_text));
+}
+
+/**
+ * @brief Переход к заданной позиции ключа
+ * @param offset - количество букв текста, предшествующих следующему фрагменту
+ */
+void modAlphaStream::seek(unsigned long long offset)
+{
+    pos = offset;
+    start = offset;
+    carry.clear();
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <string>
+#include "modAlphaCipher.h"
+
+/**
+ * @file modAlphaStream.h
+ * @brief Заголовочный файл класса modAlphaStream для потокового шифрования методом Гронсфельда
+ * @author Пресняков Александр
+ * @version 1.0
+ * @date 2025
+ */
+
+/**
+ * @brief Потоковый шифратор/дешифратор Гронсфельда
+ * @details Обрабатывает текст произвольной длины по частям. Между вызовами update()
+ * сохраняется фаза ключа (число уже обработанных букв) и до 3 байтов незавершённого
+ * символа UTF-8, поэтому символ может быть разрезан границей фрагментов. Результат
+ * совпадает с однократным вызовом modAlphaCipher::encrypt/decrypt для всего текста
+ * и не зависит от локали программы. Если update() выбросил исключение, состояние потока
+ * не меняется: фрагмент можно исправить и подать снова.
+ */
+class modAlphaStream
+{
+public:
+    /**
+     * @brief Направление преобразования
+     */
+    enum class Mode {
+        Encrypt, ///< Шифрование
+        Decrypt  ///< Дешифрование
+    };
+
+    modAlphaStream() = delete; ///< Удалённый конструктор по умолчанию
+
+    /**
+     * @brief Конструктор на основе готового шифра
+     * @param cipher - шифр с установленным ключом
+     * @param mode - направление преобразования
+     */
+    modAlphaStream(const modAlphaCipher& cipher, Mode mode);
+
+    /**
+     * @brief Конструктор с установкой ключа
+     * @param skey - ключ шифрования
+     * @param mode - направление преобразования
+     * @throw cipher_error если ключ невалиден
+     */
+    modAlphaStream(const std::wstring& skey, Mode mode);
+
+    /**
+     * @brief Обработка очередного фрагмента широкой строки
+     * @param chunk - фрагмент текста
+     * @return Результат для фрагмента
+     * @throw cipher_error если фрагмент содержит недопустимые символы
+     */
+    std::wstring update(const std::wstring& chunk);
+
+    /**
+     * @brief Обработка очередного фрагмента текста в UTF-8
+     * @param chunk - фрагмент байтов; первый и последний символы могут быть неполными
+     * @return Результат для фрагмента в UTF-8
+     * @throw cipher_error если фрагмент содержит недопустимые символы или некорректный UTF-8;
+     * позиция ключа и перенесённые байты при этом не меняются
+     */
+    std::string update(const std::string& chunk);
+
+    /**
+     * @brief Завершение потока
+     * @throw cipher_error если поток оборвался посреди символа UTF-8 или, как у
+     * modAlphaCipher::encrypt/decrypt, в нём не было ни одной буквы (с начала или после seek())
+     */
+    void finish();
+
+    /**
+     * @brief Переход к заданной позиции ключа
+     * @param offset - количество букв текста, предшествующих следующему фрагменту
+     * @details Позволяет обработать любой фрагмент отдельно, зная число букв перед ним.
+     * Незавершённый символ UTF-8 сбрасывается
+     */
+    void seek(unsigned long long offset);
+
+    /**
+     * @brief Текущая позиция ключа
+     * @return Количество обработанных букв с начала потока
+     */
+    unsigned long long position() const
+    {
+        return pos;
+    }
+
+private:
+    modAlphaCipher cipher; ///< Шифр с установленным ключом
+    Mode mode; ///< Направление преобразования
+    unsigned long long pos = 0; ///< Количество обработанных букв
+    unsigned long long start = 0; ///< Позиция начала потока или последнего seek()
+    std::string carry; ///< Начало символа UTF-8, разрезанного границей фрагментов (до 3 байтов)
+    std::string bytes_in; ///< Буфер: перенесённые байты и очередной фрагмент
+    std::wstring wide_out; ///< Буфер результата для фрагмента широкой строки
+
+    /**
+     * @brief Преобразование декодированного фрагмента с текущей позиции ключа
+     * @param in - фрагмент
+     * @param n - длина фрагмента
+     * @return Количество символов, записанных в wide_out
+     */
+    std::size_t transform(const wchar_t* in, std::size_t n);
+};